@@ -0,0 +1,196 @@
+#include "ADPCMRenderer.h"
+#include <iostream>
+#include <cstring>
+#include <cassert>
+
+#include "player/playerbase.hpp"
+#include "player/vgmplayer.hpp"
+#include "player/playera.hpp"
+#include "utils/DataLoader.h"
+#include "utils/MemoryLoader.h"
+#include "emu/SoundDevs.h"
+#include "emu/cores/opnintf.h"
+
+#define RENDER_CHUNK_FRAMES 2048
+
+ADPCMRenderer::ADPCMRenderer()
+    : player(NULL), loader(NULL), gain(ADPCM_RENDER_GAIN), dither(PCM_DITHER_NONE),
+      sampleCache(NULL), seekError(false), sampleRate(0), dacRate(0), totalFrames(0), totalSamples(0), renderedFrames(0),
+      producedSamples(0), chunkStart(0) {
+}
+
+ADPCMRenderer::~ADPCMRenderer() {
+    Close();
+}
+
+bool ADPCMRenderer::Open(const UINT8* data, UINT32 size, UINT32 renderRate, UINT32 outRate) {
+    Close();
+    sampleRate = renderRate;
+    dacRate = outRate ? outRate : renderRate;
+    if (!resampler.Init(sampleRate, dacRate) || !conditioner.Init(1.0, dither)) {
+        return false;
+    }
+
+    player = new PlayerA;
+    player->RegisterPlayerEngine(new VGMPlayer);
+
+    if (player->SetOutputSettings(sampleRate, 2, 16, RENDER_CHUNK_FRAMES)) {
+        std::cerr << "Unsupported ADPCM render sample rate: " << sampleRate << std::endl;
+        Close();
+        return false;
+    }
+
+    // Same playback settings as vgm2wav_adpcm_only
+    PlayerA::Config pCfg = player->GetConfiguration();
+    pCfg.masterVol = (INT32)(gain * 0x10000 + 0.5);  // 16.16 fixed point
+    pCfg.loopCount = 1;
+    pCfg.fadeSmpls = 0;
+    pCfg.endSilenceSmpls = 0;
+    pCfg.pbSpeed = 1.0;
+    player->SetConfiguration(pCfg);
+
+    loader = MemoryLoader_Init(data, size);
+    if (loader == NULL) {
+        std::cerr << "Failed to create memory loader for ADPCM rendering" << std::endl;
+        Close();
+        return false;
+    }
+    DataLoader_SetPreloadBytes(loader, 0x100);
+    if (DataLoader_Load(loader)) {
+        std::cerr << "Failed to open VGM for ADPCM rendering" << std::endl;
+        Close();
+        return false;
+    }
+    if (player->LoadFile(loader)) {
+        std::cerr << "libvgm failed to load the VGM for ADPCM rendering" << std::endl;
+        Close();
+        return false;
+    }
+
+    PlayerBase* plrEngine = player->GetPlayer();
+    if (plrEngine->GetPlayerType() == FCC_VGM) {
+        VGMPlayer* vgmplay = dynamic_cast<VGMPlayer*>(plrEngine);
+        player->SetLoopCount(vgmplay->GetModifiedLoopCount(1));
+    }
+
+    // No oscilloscope here: without voice capture the player keeps all of
+    // its state to itself, so renderers in other threads do not interfere
+    plrEngine->SetVoiceCapture(0);
+    player->Start();
+
+    // Render ADPCM only: the YM2610 skips its FM channels and the SSG and
+    // replays ADPCM-A samples from its decode cache
+    std::vector<PLR_DEV_INFO> devList;
+    plrEngine->GetSongDeviceInfo(devList);
+    for (size_t i = 0; i < devList.size(); i++) {
+        if (devList[i].type == DEVID_YM2610) {
+            PLR_DEV_OPTS devOpts;
+            plrEngine->GetDeviceOptions(devList[i].id, devOpts);
+            devOpts.coreOpts |= OPT_YM2610_PCM_ONLY | OPT_YM2610_ADPCMA_CACHE;
+            devOpts.sampleCache = sampleCache;
+            plrEngine->SetDeviceOptions(devList[i].id, devOpts);
+
+            // Mute FM CH0-5 and the SSG as well, so nothing but ADPCM gets
+            // into the DAC render even with a libvgm that lacks the option
+            PLR_MUTE_OPTS muteOpts;
+            muteOpts.disable = 0x00;
+            muteOpts.chnMute[0] = 0x0000003F;
+            muteOpts.chnMute[1] = 0x00000007;
+            plrEngine->SetDeviceMuting(devList[i].id, muteOpts);
+        }
+    }
+
+    totalFrames = plrEngine->Tick2Sample(plrEngine->GetTotalPlayTicks(1));
+    totalSamples = resampler.GetOutputLength(totalFrames);
+    renderedFrames = 0;
+    producedSamples = 0;
+    renderBuf.resize(RENDER_CHUNK_FRAMES * 2);
+    chunk.clear();
+    chunkStart = 0;
+    seekError = false;
+
+    return true;
+}
+
+void ADPCMRenderer::Close() {
+    if (player != NULL) {
+        if (loader != NULL) {
+            player->Stop();
+            player->UnloadFile();
+        }
+        player->UnregisterAllPlayers();
+        delete player;
+        player = NULL;
+    }
+    if (loader != NULL) {
+        DataLoader_Deinit(loader);
+        loader = NULL;
+    }
+    renderBuf.clear();
+    monoBuf.clear();
+    chunk.clear();
+}
+
+bool ADPCMRenderer::RenderNextChunk() {
+    if (player == NULL || producedSamples >= totalSamples) {
+        return false;
+    }
+
+    // The resampler holds back the samples its filter still needs input
+    // for, so a chunk may come out empty; keep rendering until it does not
+    monoBuf.clear();
+    while (monoBuf.empty()) {
+        if (renderedFrames >= totalFrames) {
+            resampler.Finish(monoBuf);
+            if (monoBuf.empty()) {
+                return false;
+            }
+            break;
+        }
+
+        UINT32 frames = totalFrames - renderedFrames;
+        if (frames > RENDER_CHUNK_FRAMES) {
+            frames = RENDER_CHUNK_FRAMES;
+        }
+
+        std::memset(&renderBuf[0], 0, frames * 2 * sizeof(INT16));
+        player->Render(frames * 2 * sizeof(INT16), &renderBuf[0]);
+
+        // Mix to mono (in place), exactly like PrepareDACData does for a WAV
+        conditioner.Downmix(&renderBuf[0], frames, 2, &renderBuf[0]);
+        resampler.Process(&renderBuf[0], frames, monoBuf);
+        renderedFrames += frames;
+    }
+
+    // 8-bit unsigned
+    chunkStart = producedSamples;
+    chunk.resize(monoBuf.size());
+    conditioner.Quantize(&monoBuf[0], monoBuf.size(), &chunk[0]);
+
+    producedSamples += chunk.size();
+    return true;
+}
+
+UINT8 ADPCMRenderer::GetSample(UINT32 index) {
+    if (index >= totalSamples) {
+        return 0x80;
+    }
+
+    while (index >= chunkStart + chunk.size()) {
+        if (!RenderNextChunk()) {
+            return 0x80;
+        }
+    }
+
+    // Already dropped samples are gone: the caller went backwards by more than a chunk
+    assert(index >= chunkStart);
+    if (index < chunkStart) {
+        if (!seekError) {
+            std::cerr << "Error: ADPCM render sample " << index << " requested after sample "
+                      << chunkStart << " (only forward access is supported)" << std::endl;
+            seekError = true;
+        }
+        return 0x80;
+    }
+    return chunk[index - chunkStart];
+}
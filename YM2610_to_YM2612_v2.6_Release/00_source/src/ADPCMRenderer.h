@@ -0,0 +1,76 @@
+#ifndef ADPCMRENDERER_H
+#define ADPCMRENDERER_H
+
+#include "../libvgm/stdtype.h"
+#include "DACResampler.h"
+#include "PCMConditioner.h"
+#include <vector>
+#include <string>
+
+#define ADPCM_RENDER_GAIN 1.5   // == 150% (boost PCM volume), as vgm2wav_adpcm_only
+
+class PlayerA;
+struct _data_loader;
+struct _adpcma_cache;
+
+// Renders the ADPCM part of a YM2610 VGM in-process with libvgm (FM muted),
+// the same way vgm2wav_adpcm_only does, and hands it out as 8-bit unsigned
+// mono DAC samples. Audio is produced in fixed-size chunks on demand, so
+// memory use does not depend on the track length. When the DAC rate differs
+// from the render rate, the mono mix is resampled before quantizing.
+// Downmix and quantization go through PCMConditioner; the gain is applied by
+// libvgm (master volume) on its wider internal mix.
+// The player runs without oscilloscope capture and keeps no state outside
+// itself (apart from a sample cache handed in with SetSampleCache), so
+// renderers in different threads run fully in parallel.
+class ADPCMRenderer {
+public:
+    ADPCMRenderer();
+    ~ADPCMRenderer();
+
+    // PCM gain (libvgm master volume), default 1.5 like vgm2wav_adpcm_only;
+    // dither for the 8-bit quantization. Take effect on the next Open().
+    void SetGain(double g) { gain = g; }
+    void SetDither(PCMDither d) { dither = d; }
+    // ADPCM-A sample cache for the YM2610 (see ADPCMSampleBank::GetChipCache),
+    // NULL = the chip decodes into a cache of its own. Takes effect on the next Open().
+    void SetSampleCache(struct _adpcma_cache* cache) { sampleCache = cache; }
+
+    // Render the VGM in data[0..size) at renderRate and deliver DAC samples
+    // at dacRate (0 = renderRate); the data must stay valid until Close()
+    bool Open(const UINT8* data, UINT32 size, UINT32 renderRate, UINT32 dacRate = 0);
+    void Close();
+
+    UINT32 GetSampleRate() const { return dacRate; }
+    UINT32 GetTotalSamples() const { return totalSamples; }
+
+    // DAC sample at the given index. Indices must not go backwards by more
+    // than one chunk; past the end of the track silence (0x80) is returned.
+    UINT8 GetSample(UINT32 index);
+    // An index went back too far since Open(): those samples came out as silence
+    bool HasSeekError() const { return seekError; }
+
+private:
+    PlayerA* player;
+    struct _data_loader* loader;
+    double gain;
+    PCMDither dither;
+    struct _adpcma_cache* sampleCache;
+    bool seekError;
+    UINT32 sampleRate;              // Render rate
+    UINT32 dacRate;                 // Rate of the samples handed out
+    UINT32 totalFrames;             // Track length at the render rate
+    UINT32 totalSamples;            // Track length at the DAC rate
+    UINT32 renderedFrames;          // Frames rendered so far
+    UINT32 producedSamples;         // DAC samples produced so far
+    std::vector<INT16> renderBuf;   // Interleaved stereo from PlayerA::Render
+    std::vector<INT16> monoBuf;     // Mono mix, DAC rate
+    DACResampler resampler;
+    PCMConditioner conditioner;
+    std::vector<UINT8> chunk;       // Current chunk as DAC samples
+    UINT32 chunkStart;              // Sample index of chunk[0]
+
+    bool RenderNextChunk();
+};
+
+#endif // ADPCMRENDERER_H
@@ -0,0 +1,274 @@
+#include "ADPCMSampleBank.h"
+#include "VGMReader.h"
+#include <iostream>
+#include <cstring>
+
+// ADPCM-A tables (same as libvgm fmopn.c, verified on real YM2608/YM2610)
+static const int adpcmaSteps[49] = {
+     16,  17,   19,   21,   23,   25,   28,
+     31,  34,   37,   41,   45,   50,   55,
+     60,  66,   73,   80,   88,   97,  107,
+    118, 130,  143,  157,  173,  190,  209,
+    230, 253,  279,  307,  337,  371,  408,
+    449, 494,  544,  598,  658,  724,  796,
+    876, 963, 1060, 1166, 1282, 1411, 1552
+};
+static const int adpcmaStepInc[8] = { -1, -1, -1, -1, 2, 5, 7, 9 };
+
+// DELTA-T tables (same as libvgm ymdeltat.c)
+static const INT32 deltatTableB1[16] = {
+     1,   3,   5,   7,   9,  11,  13,  15,
+    -1,  -3,  -5,  -7,  -9, -11, -13, -15
+};
+static const INT32 deltatTableB2[16] = {
+    57,  57,  57,  57,  77, 102, 128, 153,
+    57,  57,  57,  57,  77, 102, 128, 153
+};
+
+// The YM2610 addresses 16 MB of ADPCM-A and of ADPCM-B ROM
+static const UINT32 romMaxSize = 0x1000000;
+
+ADPCMSampleBank::ADPCMSampleBank()
+    : decodedBytes(0), lookupCount(0), hitCount(0), blockLoadCount(0), blockReuseCount(0),
+      chipCache(NULL) {
+}
+
+ADPCMSampleBank::~ADPCMSampleBank() {
+    ym2610_adpcma_cache_free(chipCache);
+}
+
+bool ADPCMSampleBank::CopyROMBlock(std::vector<UINT8>& rom, const UINT8* blockData, UINT32 blockSize) {
+    if (blockSize < 8) {
+        return false;
+    }
+
+    // ROM data block body: total ROM size, start address, data
+    UINT32 romSize = VGMReader::ReadLE32(&blockData[0]);
+    UINT32 startAddr = VGMReader::ReadLE32(&blockData[4]);
+    UINT32 dataLen = blockSize - 8;
+
+    // A block outside the ROM size it declares is corrupt
+    if (romSize > romMaxSize) {
+        romSize = romMaxSize;
+    }
+    if (startAddr > romSize || dataLen > romSize - startAddr) {
+        return false;
+    }
+
+    if (rom.size() < romSize) {
+        rom.resize(romSize, 0x00);
+    }
+    if (dataLen > 0) {
+        memcpy(&rom[startAddr], &blockData[8], dataLen);
+    }
+    return true;
+}
+
+bool ADPCMSampleBank::LoadROMBlock(UINT8 type, const UINT8* blockData, UINT32 blockSize) {
+    std::vector<UINT8>* rom;
+    if (type == 0x82) {
+        rom = &romA;
+    } else if (type == 0x83) {
+        rom = &romB;
+    } else {
+        return false;
+    }
+
+    if (!CopyROMBlock(*rom, blockData, blockSize)) {
+        return false;
+    }
+
+    // Samples decoded from the old contents are stale now
+    if (blockSize > 8) {
+        UINT32 startAddr = VGMReader::ReadLE32(&blockData[4]);
+        InvalidateRange((type == 0x82) ? SAMPLE_ADPCMA : SAMPLE_ADPCMB, startAddr, startAddr + blockSize - 9);
+    }
+    blockLoadCount++;
+
+    return true;
+}
+
+UINT32 ADPCMSampleBank::LoadROMSet(const std::vector<ROMBlock>& blocks) {
+    // Build the ROM images the way a freshly reset chip sees them after
+    // this track's blocks; copying is cheap next to decoding the samples
+    std::vector<UINT8> newA;
+    std::vector<UINT8> newB;
+    UINT32 reused = 0;
+
+    for (size_t b = 0; b < blocks.size(); b++) {
+        const ROMBlock& block = blocks[b];
+        std::vector<UINT8>& newROM = (block.type == 0x82) ? newA : newB;
+        const std::vector<UINT8>& oldROM = (block.type == 0x82) ? romA : romB;
+        if ((block.type != 0x82 && block.type != 0x83) || !CopyROMBlock(newROM, block.data, block.size)) {
+            continue;
+        }
+
+        UINT32 startAddr = VGMReader::ReadLE32(&block.data[4]);
+        UINT32 dataLen = block.size - 8;
+        if (startAddr + dataLen <= oldROM.size() &&
+            (dataLen == 0 || memcmp(&oldROM[startAddr], &block.data[8], dataLen) == 0)) {
+            // Same bytes at the same address as in the previous track
+            reused++;
+        } else {
+            blockLoadCount++;
+        }
+    }
+
+    InvalidateChanged(SAMPLE_ADPCMA, newA);
+    InvalidateChanged(SAMPLE_ADPCMB, newB);
+    romA.swap(newA);
+    romB.swap(newB);
+
+    blockReuseCount += reused;
+    return reused;
+}
+
+void ADPCMSampleBank::InvalidateChanged(SampleType type, const std::vector<UINT8>& newROM) {
+    std::map<std::pair<UINT32, UINT32>, int>& index = (type == SAMPLE_ADPCMA) ? indexA : indexB;
+    const std::vector<UINT8>& oldROM = (type == SAMPLE_ADPCMA) ? romA : romB;
+
+    // A cached sample stays valid if its ROM bytes are still there, unchanged
+    std::map<std::pair<UINT32, UINT32>, int>::iterator it = index.begin();
+    while (it != index.end()) {
+        UINT32 start = it->first.first;
+        UINT32 end = it->first.second;
+        if (end < newROM.size() && end < oldROM.size() &&
+            memcmp(&oldROM[start], &newROM[start], end - start + 1) == 0) {
+            ++it;
+        } else {
+            std::vector<UINT8>().swap(samples[it->second].data);
+            index.erase(it++);
+        }
+    }
+}
+
+void ADPCMSampleBank::InvalidateRange(SampleType type, UINT32 start, UINT32 end) {
+    std::map<std::pair<UINT32, UINT32>, int>& index = (type == SAMPLE_ADPCMA) ? indexA : indexB;
+
+    std::map<std::pair<UINT32, UINT32>, int>::iterator it = index.begin();
+    while (it != index.end()) {
+        if (it->first.first <= end && it->first.second >= start) {
+            // Keep the slot so sample indices stay stable, free the data
+            std::vector<UINT8>().swap(samples[it->second].data);
+            index.erase(it++);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ADPCMSampleBank::Clear() {
+    romA.clear();
+    romB.clear();
+    samples.clear();
+    indexA.clear();
+    indexB.clear();
+}
+
+ADPCMA_CACHE* ADPCMSampleBank::GetChipCache() {
+    if (chipCache == NULL) {
+        chipCache = ym2610_adpcma_cache_create();
+    }
+    return chipCache;
+}
+
+UINT32 ADPCMSampleBank::GetChipDecodeCount() const {
+    UINT32 decoded = 0;
+    UINT32 reused = 0;
+    if (chipCache != NULL) {
+        ym2610_adpcma_cache_stats(chipCache, &decoded, &reused);
+    }
+    return decoded;
+}
+
+UINT32 ADPCMSampleBank::GetChipReuseCount() const {
+    UINT32 decoded = 0;
+    UINT32 reused = 0;
+    if (chipCache != NULL) {
+        ym2610_adpcma_cache_stats(chipCache, &decoded, &reused);
+    }
+    return reused;
+}
+
+int ADPCMSampleBank::GetSample(SampleType type, UINT32 start, UINT32 end) {
+    lookupCount++;
+
+    std::map<std::pair<UINT32, UINT32>, int>& index = (type == SAMPLE_ADPCMA) ? indexA : indexB;
+    std::pair<UINT32, UINT32> key(start, end);
+
+    std::map<std::pair<UINT32, UINT32>, int>::const_iterator it = index.find(key);
+    if (it != index.end()) {
+        hitCount++;
+        return it->second;
+    }
+
+    const std::vector<UINT8>& rom = (type == SAMPLE_ADPCMA) ? romA : romB;
+    if (start > end || end >= rom.size()) {
+        return -1;
+    }
+
+    Sample sample;
+    sample.type = type;
+    sample.start = start;
+    sample.end = end;
+    if (type == SAMPLE_ADPCMA) {
+        DecodeADPCMA(rom.data(), start, end, sample.data);
+    } else {
+        DecodeADPCMB(rom.data(), start, end, sample.data);
+    }
+
+    decodedBytes += sample.data.size();
+    samples.push_back(sample);
+    index[key] = samples.size() - 1;
+    return samples.size() - 1;
+}
+
+void ADPCMSampleBank::DecodeADPCMA(const UINT8* rom, UINT32 start, UINT32 end, std::vector<UINT8>& out) {
+    // The chip stops when the nibble address reaches end*2, so the last byte is not played
+    UINT32 nibbles = (end - start) * 2;
+    out.resize(nibbles);
+
+    INT32 acc = 0;
+    INT32 step = 0;
+    for (UINT32 i = 0; i < nibbles; i++) {
+        UINT8 byte = rom[start + (i >> 1)];
+        UINT8 data = (i & 1) ? (byte & 0x0F) : (byte >> 4);
+
+        int value = (2 * (data & 0x07) + 1) * adpcmaSteps[step] / 8;
+        acc += (data & 0x08) ? -value : value;
+
+        // 12-bit accumulator wraps, it does not saturate
+        acc &= 0xFFF;
+        if (acc & 0x800) {
+            acc |= ~0xFFF;
+        }
+
+        step += adpcmaStepInc[data & 0x07];
+        if (step < 0) step = 0;
+        if (step > 48) step = 48;
+
+        out[i] = static_cast<UINT8>((acc >> 4) + 0x80);
+    }
+}
+
+void ADPCMSampleBank::DecodeADPCMB(const UINT8* rom, UINT32 start, UINT32 end, std::vector<UINT8>& out) {
+    UINT32 nibbles = (end - start) * 2;
+    out.resize(nibbles);
+
+    INT32 acc = 0;
+    INT32 delta = 127;
+    for (UINT32 i = 0; i < nibbles; i++) {
+        UINT8 byte = rom[start + (i >> 1)];
+        UINT8 data = (i & 1) ? (byte & 0x0F) : (byte >> 4);
+
+        acc += deltatTableB1[data] * delta / 8;
+        if (acc > 32767) acc = 32767;
+        if (acc < -32768) acc = -32768;
+
+        delta = (delta * deltatTableB2[data]) / 64;
+        if (delta > 24576) delta = 24576;
+        if (delta < 127) delta = 127;
+
+        out[i] = static_cast<UINT8>((acc >> 8) + 0x80);
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef ADPCMSAMPLEBANK_H
+#define ADPCMSAMPLEBANK_H
+
+#include "../libvgm/stdtype.h"
+#include "../libvgm/emu/cores/opnintf.h"
+#include <vector>
+#include <map>
+#include <utility>
+
+// Decodes YM2610 ADPCM-A / ADPCM-B (DELTA-T) sample regions from the ROM
+// data blocks of a VGM and keeps one copy of each distinct region as
+// 8-bit unsigned DAC data. Used by the DAC stream mode (--dac=stream); the
+// default render mode plays the ROM through libvgm and shares the bank's
+// libvgm ADPCM-A cache instead (GetChipCache).
+// All tracks of a game carry (parts of) the same ROM, so a bank can be
+// shared by every track of a batch: LoadROMSet() rebuilds the ROM image of
+// each track and keeps the samples whose ROM bytes did not change, and the
+// YM2610 of each rendered track reuses the ADPCM-A samples it finds
+// unchanged in its own ROM.
+class ADPCMSampleBank {
+public:
+    enum SampleType {
+        SAMPLE_ADPCMA = 0,
+        SAMPLE_ADPCMB = 1
+    };
+
+    struct Sample {
+        SampleType type;
+        UINT32 start;               // ROM byte address (inclusive)
+        UINT32 end;                 // ROM byte address (inclusive)
+        std::vector<UINT8> data;    // Decoded 8-bit unsigned PCM
+    };
+
+    // A ROM data block (0x67 type 0x82/0x83) as found in the VGM;
+    // data points at the block body (ROM size, start address, data)
+    struct ROMBlock {
+        UINT8 type;
+        const UINT8* data;
+        UINT32 size;
+    };
+
+    ADPCMSampleBank();
+    ~ADPCMSampleBank();
+
+    // Replace the ROM with the data blocks of one track: the ROM ends up as
+    // if only these blocks had been loaded, nothing of an earlier track is
+    // left in it. Samples whose ROM bytes stay the same remain cached.
+    // Returns the number of blocks whose contents were already in the ROM.
+    UINT32 LoadROMSet(const std::vector<ROMBlock>& blocks);
+
+    // Drop all ROM data and decoded samples
+    void Clear();
+
+    // Load a VGM data block of type 0x82 (ADPCM-A ROM) or 0x83 (DELTA-T ROM).
+    // blockData points at the block body (ROM size, start address, data).
+    bool LoadROMBlock(UINT8 type, const UINT8* blockData, UINT32 blockSize);
+
+    // Look up or decode a region. Returns the sample index, or -1 if the
+    // region is outside the loaded ROM.
+    int GetSample(SampleType type, UINT32 start, UINT32 end);
+
+    UINT32 GetSampleCount() const { return samples.size(); }
+    const Sample& GetSampleAt(UINT32 index) const { return samples[index]; }
+
+    UINT32 GetDecodedBytes() const { return decodedBytes; }
+    UINT32 GetLookupCount() const { return lookupCount; }
+    UINT32 GetHitCount() const { return hitCount; }
+    UINT32 GetBlockLoadCount() const { return blockLoadCount; }
+    UINT32 GetBlockReuseCount() const { return blockReuseCount; }
+
+    // libvgm YM2610 ADPCM-A cache for the render mode (ADPCMRenderer::SetSampleCache),
+    // created on first use. Only one chip may use it at a time.
+    ADPCMA_CACHE* GetChipCache();
+    // Render mode: ADPCM-A regions decoded, and regions kept from an earlier track
+    UINT32 GetChipDecodeCount() const;
+    UINT32 GetChipReuseCount() const;
+
+    // Raw decoders, also usable without a bank
+    static void DecodeADPCMA(const UINT8* rom, UINT32 start, UINT32 end, std::vector<UINT8>& out);
+    static void DecodeADPCMB(const UINT8* rom, UINT32 start, UINT32 end, std::vector<UINT8>& out);
+
+private:
+    std::vector<UINT8> romA;
+    std::vector<UINT8> romB;
+    std::vector<Sample> samples;
+    std::map<std::pair<UINT32, UINT32>, int> indexA;  // (start, end) -> sample index
+    std::map<std::pair<UINT32, UINT32>, int> indexB;
+    UINT32 decodedBytes;
+    UINT32 lookupCount;
+    UINT32 hitCount;
+    UINT32 blockLoadCount;
+    UINT32 blockReuseCount;
+    ADPCMA_CACHE* chipCache;
+
+    void InvalidateRange(SampleType type, UINT32 start, UINT32 end);
+    void InvalidateChanged(SampleType type, const std::vector<UINT8>& newROM);
+    static bool CopyROMBlock(std::vector<UINT8>& rom, const UINT8* blockData, UINT32 blockSize);
+};
+
+#endif // ADPCMSAMPLEBANK_H
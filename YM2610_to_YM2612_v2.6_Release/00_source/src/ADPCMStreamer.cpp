@@ -0,0 +1,160 @@
+#include "ADPCMStreamer.h"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+#define DAC_STREAM_ID    0x00
+#define DAC_CHIP_YM2612  0x02
+
+ADPCMStreamer::ADPCMStreamer(VGMWriter& w, ADPCMSampleBank& b)
+    : writer(w), bank(b), clock(8000000), nextBlockId(0), streamFreq(0),
+      playingSource(SOURCE_NONE), scanning(false), keyOnCount(0), streamStartCount(0) {
+    std::memset(regA, 0, sizeof(regA));
+    std::memset(regB, 0, sizeof(regB));
+}
+
+ADPCMStreamer::~ADPCMStreamer() {
+}
+
+void ADPCMStreamer::BeginScan() {
+    scanning = true;
+    scanOrder.clear();
+}
+
+void ADPCMStreamer::Initialize(UINT32 ym2610Clock) {
+    clock = ym2610Clock;
+
+    // Samples found by the scan go in front of everything else. A block
+    // written later could end up after the loop point, and libvgm does not
+    // skip data blocks correctly when it plays the loop again.
+    if (scanning) {
+        for (size_t i = 0; i < scanOrder.size(); i++) {
+            WriteSampleBlock(scanOrder[i]);
+        }
+        scanning = false;
+        std::memset(regA, 0, sizeof(regA));
+        std::memset(regB, 0, sizeof(regB));
+        playingSource = SOURCE_NONE;
+    }
+
+    // Stream 0 -> YM2612 port 0, register 0x2A (DAC)
+    writer.WriteStreamSetup(DAC_STREAM_ID, DAC_CHIP_YM2612, 0x00, 0x2A);
+
+    // Stream 0 reads data bank type 0x00, step size 1, step base 0
+    writer.WriteStreamData(DAC_STREAM_ID, 0x00, 0x01, 0x00);
+}
+
+void ADPCMStreamer::WriteADPCMA(UINT8 reg, UINT8 data) {
+    if (reg >= sizeof(regA)) return;
+    regA[reg] = data;
+
+    if (reg != 0x00) return;
+
+    if (data & 0x80) {
+        // Dump (key off) for every selected channel
+        for (int c = 0; c < 6; c++) {
+            if ((data >> c) & 1) {
+                StopSource(c);
+            }
+        }
+        return;
+    }
+
+    // Key on: the highest selected channel ends up on the DAC
+    for (int c = 0; c < 6; c++) {
+        if (!((data >> c) & 1)) continue;
+
+        if (!scanning) keyOnCount++;
+        UINT32 start = ((regA[0x18 + c] << 8) | regA[0x10 + c]) << 8;
+        UINT32 end = (((regA[0x28 + c] << 8) | regA[0x20 + c]) << 8) | 0xFF;
+        int sampleIndex = bank.GetSample(ADPCMSampleBank::SAMPLE_ADPCMA, start, end);
+        if (sampleIndex < 0) continue;
+
+        // ADPCM-A runs at a fixed clock / 432 (18.5 kHz at 8 MHz)
+        StartSample(sampleIndex, clock / 432, false, c);
+    }
+}
+
+void ADPCMStreamer::WriteADPCMB(UINT8 reg, UINT8 data) {
+    if (reg < 0x10 || reg > 0x1C) return;
+    regB[reg - 0x10] = data;
+
+    if (reg == 0x10) {
+        if (data & 0x01) {
+            // Reset
+            StopSource(SOURCE_ADPCMB);
+        } else if (data & 0x80) {
+            if (!scanning) keyOnCount++;
+            UINT32 start = ((regB[0x03] << 8) | regB[0x02]) << 8;
+            UINT32 end = (((regB[0x05] << 8) | regB[0x04]) << 8) | 0xFF;
+            int sampleIndex = bank.GetSample(ADPCMSampleBank::SAMPLE_ADPCMB, start, end);
+            if (sampleIndex >= 0) {
+                StartSample(sampleIndex, GetADPCMBFrequency(), (data & 0x10) != 0, SOURCE_ADPCMB);
+            }
+        } else {
+            StopSource(SOURCE_ADPCMB);
+        }
+    } else if ((reg == 0x19 || reg == 0x1A) && playingSource == SOURCE_ADPCMB && !scanning) {
+        // DELTA-N change while playing: retune the stream
+        UINT32 freq = GetADPCMBFrequency();
+        if (freq != streamFreq && freq > 0) {
+            writer.WriteStreamFrequency(DAC_STREAM_ID, freq);
+            streamFreq = freq;
+        }
+    }
+}
+
+void ADPCMStreamer::WriteSampleBlock(int sampleIndex) {
+    if ((UINT32)sampleIndex >= blockIds.size()) {
+        blockIds.resize(sampleIndex + 1, -1);
+    }
+    if (blockIds[sampleIndex] < 0) {
+        writer.WriteDataBlock(0x00, bank.GetSampleAt(sampleIndex).data);
+        blockIds[sampleIndex] = nextBlockId++;
+    }
+}
+
+void ADPCMStreamer::StartSample(int sampleIndex, UINT32 freq, bool loop, int source) {
+    if (scanning) {
+        // Only remember which samples are used, in order
+        if (std::find(scanOrder.begin(), scanOrder.end(), sampleIndex) == scanOrder.end()) {
+            scanOrder.push_back(sampleIndex);
+        }
+        return;
+    }
+
+    if (freq == 0) return;
+
+    // Write each distinct sample to the file once, the first time it is used
+    // (only happens here if the track was not scanned)
+    if ((UINT32)sampleIndex >= blockIds.size() || blockIds[sampleIndex] < 0) {
+        WriteSampleBlock(sampleIndex);
+
+        // Players bind the bank (and its block count) at 0x91: re-issue it
+        writer.WriteStreamData(DAC_STREAM_ID, 0x00, 0x01, 0x00);
+    }
+
+    if (freq != streamFreq) {
+        writer.WriteStreamFrequency(DAC_STREAM_ID, freq);
+        streamFreq = freq;
+    }
+
+    // Start stream from block ID, flags bit 0 = loop
+    writer.WriteStreamStartBlock(DAC_STREAM_ID, (UINT16)blockIds[sampleIndex], loop ? 0x01 : 0x00);
+
+    playingSource = source;
+    streamStartCount++;
+}
+
+void ADPCMStreamer::StopSource(int source) {
+    if (scanning || playingSource != source) return;
+
+    writer.WriteStreamStop(DAC_STREAM_ID);
+    playingSource = SOURCE_NONE;
+}
+
+UINT32 ADPCMStreamer::GetADPCMBFrequency() const {
+    // DELTA-N / 65536 * (clock / 144)
+    UINT32 deltaN = (regB[0x0A] << 8) | regB[0x09];
+    return (UINT32)(((UINT64)deltaN * (clock / 144)) >> 16);
+}
@@ -0,0 +1,62 @@
+#ifndef ADPCMSTREAMER_H
+#define ADPCMSTREAMER_H
+
+#include "../libvgm/stdtype.h"
+#include "VGMWriter.h"
+#include "ADPCMSampleBank.h"
+
+// Turns YM2610 ADPCM-A/ADPCM-B key-on/off register writes into VGM
+// DAC Stream Control commands (0x90-0x95) on the YM2612 DAC.
+// Every distinct sample region is decoded once and stored as its own
+// type 0x00 data block; playback uses 0x95 (start stream by block ID).
+// The YM2612 has a single DAC, so the most recent key-on wins.
+class ADPCMStreamer {
+public:
+    ADPCMStreamer(VGMWriter& writer, ADPCMSampleBank& bank);
+    ~ADPCMStreamer();
+
+    // Optional pre-pass: feed every ADPCM register write of the track
+    // between BeginScan() and Initialize() to collect the samples it uses;
+    // they are then written as data blocks ahead of all commands
+    void BeginScan();
+
+    // Emit pending data blocks and stream setup (0x90/0x91); call once
+    // before any key-on
+    void Initialize(UINT32 ym2610Clock);
+
+    // YM2610 port 1 registers 0x00-0x2F (ADPCM-A)
+    void WriteADPCMA(UINT8 reg, UINT8 data);
+    // YM2610 port 0 registers 0x10-0x1C (ADPCM-B / DELTA-T)
+    void WriteADPCMB(UINT8 reg, UINT8 data);
+
+    // Statistics
+    UINT32 GetKeyOnCount() const { return keyOnCount; }
+    UINT32 GetStreamStartCount() const { return streamStartCount; }
+
+private:
+    enum {
+        SOURCE_NONE = -1,
+        SOURCE_ADPCMB = 6   // 0-5 = ADPCM-A channels
+    };
+
+    VGMWriter& writer;
+    ADPCMSampleBank& bank;
+    UINT32 clock;
+    UINT8 regA[0x30];
+    UINT8 regB[0x10];
+    std::vector<int> blockIds;  // Sample index -> data block ID (-1 = not written yet)
+    UINT32 nextBlockId;
+    UINT32 streamFreq;          // Currently programmed stream frequency
+    int playingSource;
+    bool scanning;
+    std::vector<int> scanOrder;  // Sample indices in order of first use during the scan
+    UINT32 keyOnCount;
+    UINT32 streamStartCount;
+
+    void StartSample(int sampleIndex, UINT32 freq, bool loop, int source);
+    void StopSource(int source);
+    void WriteSampleBlock(int sampleIndex);
+    UINT32 GetADPCMBFrequency() const;
+};
+
+#endif // ADPCMSTREAMER_H
@@ -1,10 +1,11 @@
 #include "CommandMapper.h"
+#include "ADPCMStreamer.h"
 #include <iostream>
 #include <algorithm>
 #include <cstring>
 
 CommandMapper::CommandMapper(VGMWriter& w)
-    : writer(w), fmCommandCount(0), ssgCommandCount(0), adpcmCommandCount(0), fmVolumeMultiplier(1.0) {
+    : writer(w), adpcmStreamer(NULL), fmCommandCount(0), ssgCommandCount(0), adpcmCommandCount(0), fmVolumeMultiplier(1.0) {
     // Initialize all channels to algorithm 0
     std::memset(channelAlgo, 0, sizeof(channelAlgo));
 }
@@ -19,12 +20,17 @@ bool CommandMapper::IsFMRegister(UINT8 reg) {
 
 bool CommandMapper::IsSSGRegister(UINT8 reg) {
     // SSG registers: 0x00-0x1F
-    return (reg >= 0x00 && reg <= 0x1F);
+    return (reg <= 0x1F);
 }
 
-bool CommandMapper::IsADPCMRegister(UINT8 reg) {
-    // ADPCM registers in port 1: 0x00-0x1F
-    return (reg >= 0x00 && reg <= 0x1F);
+bool CommandMapper::IsADPCMARegister(UINT8 reg) {
+    // ADPCM-A registers in port 1: 0x00-0x2F (key on/off, TL, pan, start/end address)
+    return (reg <= 0x2F);
+}
+
+bool CommandMapper::IsADPCMBRegister(UINT8 reg) {
+    // ADPCM-B (DELTA-T) registers in port 0: 0x10-0x1C
+    return (reg >= 0x10 && reg <= 0x1C);
 }
 
 bool CommandMapper::IsTLRegister(UINT8 reg) {
@@ -67,10 +73,19 @@ UINT8 CommandMapper::AdjustTL(UINT8 tl) {
 
 void CommandMapper::ProcessYM2610Port0(UINT8 reg, UINT8 data) {
     // Port 0 contains:
-    // - 0x00-0x1F: SSG registers (discard)
+    // - 0x00-0x0F: SSG registers (discard)
+    // - 0x10-0x1C: ADPCM-B registers (forward to streamer)
     // - 0x20-0x2F: Timer and mode registers (convert)
     // - 0x30-0xB6: FM operator/channel registers for channels 0-2 (convert)
 
+    if (IsADPCMBRegister(reg)) {
+        adpcmCommandCount++;
+        if (adpcmStreamer) {
+            adpcmStreamer->WriteADPCMB(reg, data);
+        }
+        return;
+    }
+
     if (IsSSGRegister(reg)) {
         // Discard SSG registers
         ssgCommandCount++;
@@ -108,17 +123,19 @@ void CommandMapper::ProcessYM2610Port0(UINT8 reg, UINT8 data) {
 
     // Unknown register, skip
     std::cerr << "Warning: Unknown YM2610 port 0 register: 0x"
-              << std::hex << (int)reg << std::dec << std::endl;
+              << VGMReader::ToHex(reg) << std::endl;
 }
 
 void CommandMapper::ProcessYM2610Port1(UINT8 reg, UINT8 data) {
     // Port 1 contains:
-    // - 0x00-0x1F: ADPCM-A and ADPCM-B control registers (handle separately)
+    // - 0x00-0x2F: ADPCM-A registers (forward to streamer)
     // - 0x30-0xB6: FM operator/channel registers for channels 3-5 (convert)
 
-    if (IsADPCMRegister(reg)) {
-        // ADPCM registers - will be handled by ADPCMDecoder
+    if (IsADPCMARegister(reg)) {
         adpcmCommandCount++;
+        if (adpcmStreamer) {
+            adpcmStreamer->WriteADPCMA(reg, data);
+        }
         return;
     }
 
@@ -150,5 +167,5 @@ void CommandMapper::ProcessYM2610Port1(UINT8 reg, UINT8 data) {
 
     // Unknown register, skip
     std::cerr << "Warning: Unknown YM2610 port 1 register: 0x"
-              << std::hex << (int)reg << std::dec << std::endl;
+              << VGMReader::ToHex(reg) << std::endl;
 }
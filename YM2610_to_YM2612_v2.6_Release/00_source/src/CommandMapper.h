@@ -4,6 +4,8 @@
 #include "stdtype.h"
 #include "VGMWriter.h"
 
+class ADPCMStreamer;
+
 class CommandMapper {
 public:
     CommandMapper(VGMWriter& writer);
@@ -16,6 +18,9 @@ public:
     // Set FM volume adjustment (multiplier, 1.0 = no adjustment, 2.0 = half volume)
     void SetFMVolumeMultiplier(double multiplier) { fmVolumeMultiplier = multiplier; }
 
+    // Forward ADPCM-A/B register writes to a DAC streamer (NULL = discard)
+    void SetADPCMStreamer(ADPCMStreamer* s) { adpcmStreamer = s; }
+
     // Get statistics
     UINT32 GetFMCommandCount() const { return fmCommandCount; }
     UINT32 GetSSGCommandCount() const { return ssgCommandCount; }
@@ -23,6 +28,7 @@ public:
 
 private:
     VGMWriter& writer;
+    ADPCMStreamer* adpcmStreamer;
     UINT32 fmCommandCount;
     UINT32 ssgCommandCount;
     UINT32 adpcmCommandCount;
@@ -31,7 +37,8 @@ private:
 
     bool IsFMRegister(UINT8 reg);
     bool IsSSGRegister(UINT8 reg);
-    bool IsADPCMRegister(UINT8 reg);
+    bool IsADPCMARegister(UINT8 reg);  // Port 1
+    bool IsADPCMBRegister(UINT8 reg);  // Port 0
     bool IsTLRegister(UINT8 reg);  // Check if register is TL (0x40-0x4F)
     bool IsCarrierOperator(UINT8 channel, UINT8 op);  // Check if operator is carrier
     UINT8 AdjustTL(UINT8 tl);  // Adjust TL value for volume reduction
@@ -0,0 +1,196 @@
+#include "DACResampler.h"
+#include <cmath>
+#include <iostream>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define DAC_RESAMPLER_SSE
+#endif
+
+#define RESAMPLER_BASE_TAPS   32      // Taps per phase when not decimating
+#define RESAMPLER_MAX_PHASES  8192
+#define RESAMPLER_ROLLOFF     0.90    // Cutoff relative to the lower Nyquist frequency
+#define RESAMPLER_KAISER_BETA 7.0     // About 70 dB stopband
+#define RESAMPLER_TRIM_SIZE   0x4000  // Drop consumed input once this much piles up
+
+static UINT32 GCD(UINT32 a, UINT32 b) {
+    while (b != 0) {
+        UINT32 t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// Modified Bessel function of the first kind, order 0
+static double BesselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 32; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+DACResampler::DACResampler()
+    : upFactor(1), downFactor(1), taps(0), historyStart(0), inputCount(0), outputCount(0) {
+}
+
+bool DACResampler::Init(UINT32 inputRate, UINT32 outputRate) {
+    if (inputRate == 0 || outputRate == 0) {
+        return false;
+    }
+
+    UINT32 g = GCD(inputRate, outputRate);
+    upFactor = outputRate / g;
+    downFactor = inputRate / g;
+    if (upFactor > RESAMPLER_MAX_PHASES) {
+        std::cerr << "Unsupported resampling ratio: " << inputRate << " -> " << outputRate << " Hz" << std::endl;
+        return false;
+    }
+
+    // Lower the cutoff (and lengthen the filter to keep its transition band
+    // narrow) when decimating
+    double ratio = (double)upFactor / downFactor;
+    double cutoff = 0.5 * RESAMPLER_ROLLOFF * ((ratio < 1.0) ? ratio : 1.0);  // Cycles per input sample
+    UINT32 stretch = (ratio < 1.0) ? (UINT32)std::ceil(1.0 / ratio) : 1;
+    taps = RESAMPLER_BASE_TAPS * stretch;
+
+    // Phase p produces the output at input position i + p / L from the
+    // inputs i - taps/2 + 1 ... i + taps/2
+    coeffs.assign((size_t)upFactor * taps, 0.0f);
+    double half = taps / 2.0;
+    double norm = BesselI0(RESAMPLER_KAISER_BETA);
+    for (UINT32 p = 0; p < upFactor; p++) {
+        double sum = 0.0;
+        for (UINT32 k = 0; k < taps; k++) {
+            double u = (double)p / upFactor + half - 1.0 - k;
+            double x = u / half;
+            double h = 0.0;
+            if (x > -1.0 && x < 1.0) {
+                double arg = 2.0 * M_PI * cutoff * u;
+                double sinc = (u == 0.0) ? 1.0 : std::sin(arg) / arg;
+                double window = BesselI0(RESAMPLER_KAISER_BETA * std::sqrt(1.0 - x * x)) / norm;
+                h = 2.0 * cutoff * sinc * window;
+            }
+            coeffs[(size_t)p * taps + k] = (float)h;
+            sum += h;
+        }
+        // Unity gain at DC for every phase
+        for (UINT32 k = 0; k < taps; k++) {
+            coeffs[(size_t)p * taps + k] = (float)(coeffs[(size_t)p * taps + k] / sum);
+        }
+    }
+
+    // Inputs before the start are silence
+    history.assign(taps / 2, 0.0f);
+    historyStart = -(INT64)(taps / 2);
+    inputCount = 0;
+    outputCount = 0;
+    return true;
+}
+
+UINT32 DACResampler::GetOutputLength(UINT32 inputLength) const {
+    return (UINT32)(((UINT64)inputLength * upFactor + downFactor - 1) / downFactor);
+}
+
+void DACResampler::Process(const INT16* input, UINT32 count, std::vector<INT16>& output) {
+    if (IsPassThrough()) {
+        output.insert(output.end(), input, input + count);
+        inputCount += count;
+        outputCount += count;
+        return;
+    }
+
+    size_t old = history.size();
+    history.resize(old + count);
+    for (UINT32 i = 0; i < count; i++) {
+        history[old + i] = input[i];
+    }
+    inputCount += count;
+
+    Produce(inputCount, output);
+}
+
+void DACResampler::Finish(std::vector<INT16>& output) {
+    if (IsPassThrough()) {
+        return;
+    }
+
+    // Silence after the end, enough for the last output's filter
+    history.resize(history.size() + taps, 0.0f);
+    Produce(inputCount + taps, output);
+}
+
+void DACResampler::Produce(UINT64 availableInput, std::vector<INT16>& output) {
+    UINT64 totalOutput = ((UINT64)inputCount * upFactor + downFactor - 1) / downFactor;
+
+    while (outputCount < totalOutput) {
+        UINT64 pos = outputCount * downFactor;
+        UINT64 i = pos / upFactor;
+        UINT32 phase = (UINT32)(pos % upFactor);
+
+        // Needs inputs up to i + taps/2
+        if (i + taps / 2 >= availableInput) {
+            break;
+        }
+
+        INT64 first = (INT64)i - (INT64)(taps / 2) + 1;
+        float y = DotProduct(&history[(size_t)(first - historyStart)], &coeffs[(size_t)phase * taps], taps);
+
+        INT32 value = (INT32)std::floor(y + 0.5f);
+        if (value > 32767) value = 32767;
+        if (value < -32768) value = -32768;
+        output.push_back((INT16)value);
+        outputCount++;
+    }
+
+    // Forget input no output needs any more
+    INT64 keepFrom = (INT64)((outputCount * downFactor) / upFactor) - (INT64)(taps / 2) + 1;
+    if (keepFrom - historyStart >= RESAMPLER_TRIM_SIZE) {
+        history.erase(history.begin(), history.begin() + (size_t)(keepFrom - historyStart));
+        historyStart = keepFrom;
+    }
+}
+
+float DACResampler::DotProduct(const float* a, const float* b, UINT32 count) {
+#ifdef DAC_RESAMPLER_SSE
+    // count is a multiple of 4
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    UINT32 i = 0;
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    for (; i < count; i += 4) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+    acc0 = _mm_add_ps(acc0, acc1);
+    float lanes[4];
+    _mm_storeu_ps(lanes, acc0);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#else
+    float sum = 0.0f;
+    for (UINT32 i = 0; i < count; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+#endif
+}
+
+bool DACResampler::Resample(const std::vector<INT16>& input, UINT32 inputRate, UINT32 outputRate,
+                            std::vector<INT16>& output) {
+    DACResampler resampler;
+    if (!resampler.Init(inputRate, outputRate)) {
+        return false;
+    }
+    output.clear();
+    output.reserve(resampler.GetOutputLength(input.size()));
+    if (!input.empty()) {
+        resampler.Process(&input[0], input.size(), output);
+    }
+    resampler.Finish(output);
+    return true;
+}
@@ -0,0 +1,48 @@
+#ifndef DACRESAMPLER_H
+#define DACRESAMPLER_H
+
+#include "../libvgm/stdtype.h"
+#include <vector>
+
+// Band-limited sample rate converter for the DAC feed (mono, 16-bit).
+// Polyphase windowed-sinc (Kaiser) filter for the rational ratio
+// outputRate / inputRate; the cutoff sits just below the lower of the two
+// Nyquist frequencies, so lowering the DAC rate does not alias. The filter
+// dot product uses SSE where available.
+// Input can be fed in pieces (Process) and the end flushed with Finish();
+// the output is aligned with the input (no delay).
+class DACResampler {
+public:
+    DACResampler();
+
+    bool Init(UINT32 inputRate, UINT32 outputRate);
+    bool IsPassThrough() const { return upFactor == downFactor; }
+
+    // Output samples produced for inputLength input samples
+    UINT32 GetOutputLength(UINT32 inputLength) const;
+
+    // Append input; every output sample that no longer depends on future
+    // input is added to output
+    void Process(const INT16* input, UINT32 count, std::vector<INT16>& output);
+    // No more input: add the remaining output samples
+    void Finish(std::vector<INT16>& output);
+
+    // Whole buffer at once
+    static bool Resample(const std::vector<INT16>& input, UINT32 inputRate, UINT32 outputRate,
+                         std::vector<INT16>& output);
+
+private:
+    UINT32 upFactor;            // L: output = input * L / M
+    UINT32 downFactor;          // M
+    UINT32 taps;                // Filter taps per phase (multiple of 4)
+    std::vector<float> coeffs;  // L phases x taps
+    std::vector<float> history; // Input samples, history[0] is input index historyStart
+    INT64 historyStart;
+    UINT64 inputCount;          // Input samples received
+    UINT64 outputCount;         // Output samples produced
+
+    void Produce(UINT64 availableInput, std::vector<INT16>& output);
+    static float DotProduct(const float* a, const float* b, UINT32 count);
+};
+
+#endif // DACRESAMPLER_H
@@ -0,0 +1,118 @@
+#include "MappedFile.h"
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : data(NULL), size(0), mapped(false) {
+#ifdef _WIN32
+    fileHandle = INVALID_HANDLE_VALUE;
+    mapHandle = NULL;
+#endif
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const std::string& filename) {
+    Close();
+
+#ifdef _WIN32
+    HANDLE hFile = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                               OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (hFile != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(hFile, &fileSize) && fileSize.QuadPart > 0 && fileSize.HighPart == 0) {
+            HANDLE hMap = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (hMap != NULL) {
+                const void* view = MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0);
+                if (view != NULL) {
+                    fileHandle = hFile;
+                    mapHandle = hMap;
+                    data = (const UINT8*)view;
+                    size = (UINT32)fileSize.QuadPart;
+                    mapped = true;
+                    return true;
+                }
+                CloseHandle(hMap);
+            }
+        }
+        CloseHandle(hFile);
+    }
+#else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0 && (UINT64)st.st_size <= 0xFFFFFFFFULL) {
+            void* view = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view != MAP_FAILED) {
+                // Commands are parsed front to back
+                madvise(view, st.st_size, MADV_SEQUENTIAL);
+                close(fd);
+                data = (const UINT8*)view;
+                size = (UINT32)st.st_size;
+                mapped = true;
+                return true;
+            }
+        }
+        close(fd);
+    }
+#endif
+
+    // Fall back to reading the file (empty files, pipes, no mmap support).
+    // Pipes have no size to ask for, so read in chunks until EOF.
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::vector<UINT8> readBuffer;
+    const size_t chunkSize = 0x10000;
+    while (file) {
+        size_t oldSize = readBuffer.size();
+        if (oldSize > 0xFFFFFFFFULL - chunkSize) {
+            return false;  // Sizes are 32-bit
+        }
+        readBuffer.resize(oldSize + chunkSize);
+        file.read((char*)readBuffer.data() + oldSize, chunkSize);
+        readBuffer.resize(oldSize + file.gcount());
+    }
+    if (file.bad()) {
+        return false;
+    }
+    Assign(readBuffer);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (mapped) {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle((HANDLE)mapHandle);
+        CloseHandle((HANDLE)fileHandle);
+        mapHandle = NULL;
+        fileHandle = INVALID_HANDLE_VALUE;
+#else
+        munmap((void*)data, size);
+#endif
+        mapped = false;
+    }
+    std::vector<UINT8>().swap(buffer);
+    data = NULL;
+    size = 0;
+}
+
+void MappedFile::Assign(std::vector<UINT8>& newBuffer) {
+    Close();
+    buffer.swap(newBuffer);
+    data = buffer.empty() ? NULL : buffer.data();
+    size = buffer.size();
+}
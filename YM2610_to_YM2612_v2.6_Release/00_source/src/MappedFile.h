@@ -0,0 +1,41 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include "../libvgm/stdtype.h"
+#include <vector>
+#include <string>
+
+// Read-only view of a whole file. The file is memory-mapped where the OS
+// allows it, so opening costs no copy and repeated opens share the page
+// cache; otherwise it falls back to reading into an owned buffer.
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    bool Open(const std::string& filename);
+    void Close();
+
+    // Replace the view with an in-memory buffer (taken over by swap)
+    void Assign(std::vector<UINT8>& buffer);
+
+    const UINT8* Data() const { return data; }
+    UINT32 Size() const { return size; }
+    bool IsMapped() const { return mapped; }
+
+private:
+    const UINT8* data;
+    UINT32 size;
+    bool mapped;
+    std::vector<UINT8> buffer;  // Fallback / assigned storage
+#ifdef _WIN32
+    void* fileHandle;
+    void* mapHandle;
+#endif
+
+    // Not copyable
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,368 @@
+#include "PCMConditioner.h"
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define PCM_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang compile the SIMD kernels for their instruction set without
+// raising the baseline of the whole program; MSVC needs no attribute
+#if defined(PCM_X86) && defined(__GNUC__)
+#define PCM_TARGET_SSE2 __attribute__((target("sse2")))
+#define PCM_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define PCM_TARGET_SSE2
+#define PCM_TARGET_AVX2
+#endif
+
+#define DITHER_TABLE_BITS  16
+#define DITHER_TABLE_SIZE  (1 << DITHER_TABLE_BITS)
+#define DITHER_TABLE_MASK  (DITHER_TABLE_SIZE - 1)
+#define DITHER_TABLE_PAD   32       // Copy of the first entries, so a vector load never wraps
+#define SHAPE_ERROR_LIMIT  1024     // Error feedback clamp; keeps clipped input from running away
+
+static inline INT16 SaturateINT16(INT32 value) {
+    if (value > 32767) return 32767;
+    if (value < -32768) return -32768;
+    return (INT16)value;
+}
+
+static inline UINT8 QuantizeSample(INT32 value) {
+    // Same as (value + 32768) >> 8 for the 16-bit range
+    return (UINT8)((SaturateINT16(value) + 32768) >> 8);
+}
+
+// ---- Scalar kernels (also finish the tails of the SIMD kernels) ----
+
+static void DownmixScalar(const INT16* in, UINT32 start, UINT32 frames, UINT16 channels,
+                          float scale, bool unity, INT16* out) {
+    for (UINT32 i = start; i < frames; i++) {
+        INT32 sum = 0;
+        for (UINT16 ch = 0; ch < channels; ch++) {
+            sum += in[i * channels + ch];
+        }
+        if (unity) {
+            out[i] = (INT16)(sum / channels);
+        } else {
+            // lrint rounds to nearest even, like cvtps2dq in the SIMD kernels
+            out[i] = SaturateINT16((INT32)std::lrint((float)sum * scale));
+        }
+    }
+}
+
+static void QuantizeScalar(const INT16* in, UINT32 start, UINT32 count, const INT16* dither, UINT8* out) {
+    for (UINT32 i = start; i < count; i++) {
+        INT32 value = in[i];
+        if (dither != NULL) {
+            value += dither[i];
+        }
+        out[i] = QuantizeSample(value);
+    }
+}
+
+#ifdef PCM_X86
+
+// ---- SSE2 ----
+
+PCM_TARGET_SSE2
+static UINT32 DownmixSSE2(const INT16* in, UINT32 frames, UINT16 channels, float scale, bool unity, INT16* out) {
+    UINT32 i = 0;
+    __m128 vscale = _mm_set1_ps(scale);
+
+    if (channels == 2) {
+        const __m128i ones = _mm_set1_epi16(1);
+        for (; i + 8 <= frames; i += 8) {
+            // Pairwise L+R sums as 32-bit
+            __m128i a = _mm_madd_epi16(_mm_loadu_si128((const __m128i*)(in + i * 2)), ones);
+            __m128i b = _mm_madd_epi16(_mm_loadu_si128((const __m128i*)(in + i * 2 + 8)), ones);
+            if (unity) {
+                // Divide by 2 rounding towards zero, like the integer division
+                a = _mm_srai_epi32(_mm_add_epi32(a, _mm_srli_epi32(a, 31)), 1);
+                b = _mm_srai_epi32(_mm_add_epi32(b, _mm_srli_epi32(b, 31)), 1);
+            } else {
+                a = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(a), vscale));
+                b = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(b), vscale));
+            }
+            _mm_storeu_si128((__m128i*)(out + i), _mm_packs_epi32(a, b));
+        }
+    } else if (channels == 1 && !unity) {
+        for (; i + 8 <= frames; i += 8) {
+            __m128i x = _mm_loadu_si128((const __m128i*)(in + i));
+            __m128i a = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+            __m128i b = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+            a = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(a), vscale));
+            b = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(b), vscale));
+            _mm_storeu_si128((__m128i*)(out + i), _mm_packs_epi32(a, b));
+        }
+    }
+    return i;
+}
+
+PCM_TARGET_SSE2
+static UINT32 QuantizeSSE2(const INT16* in, UINT32 count, const INT16* dither, UINT8* out) {
+    const __m128i bias = _mm_set1_epi16((short)0x8000);
+    UINT32 i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(in + i + 8));
+        if (dither != NULL) {
+            a = _mm_adds_epi16(a, _mm_loadu_si128((const __m128i*)(dither + i)));
+            b = _mm_adds_epi16(b, _mm_loadu_si128((const __m128i*)(dither + i + 8)));
+        }
+        // (x + 32768) >> 8: flip the sign bit, then a logical shift
+        a = _mm_srli_epi16(_mm_xor_si128(a, bias), 8);
+        b = _mm_srli_epi16(_mm_xor_si128(b, bias), 8);
+        _mm_storeu_si128((__m128i*)(out + i), _mm_packus_epi16(a, b));
+    }
+    return i;
+}
+
+// ---- AVX2 ----
+
+PCM_TARGET_AVX2
+static UINT32 DownmixAVX2(const INT16* in, UINT32 frames, UINT16 channels, float scale, bool unity, INT16* out) {
+    UINT32 i = 0;
+    __m256 vscale = _mm256_set1_ps(scale);
+
+    if (channels == 2) {
+        const __m256i ones = _mm256_set1_epi16(1);
+        for (; i + 16 <= frames; i += 16) {
+            __m256i a = _mm256_madd_epi16(_mm256_loadu_si256((const __m256i*)(in + i * 2)), ones);
+            __m256i b = _mm256_madd_epi16(_mm256_loadu_si256((const __m256i*)(in + i * 2 + 16)), ones);
+            if (unity) {
+                a = _mm256_srai_epi32(_mm256_add_epi32(a, _mm256_srli_epi32(a, 31)), 1);
+                b = _mm256_srai_epi32(_mm256_add_epi32(b, _mm256_srli_epi32(b, 31)), 1);
+            } else {
+                a = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(a), vscale));
+                b = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(b), vscale));
+            }
+            // packs works per 128-bit lane; put the quarters back in order
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+            _mm256_storeu_si256((__m256i*)(out + i), packed);
+        }
+    } else if (channels == 1 && !unity) {
+        for (; i + 16 <= frames; i += 16) {
+            __m256i a = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(in + i)));
+            __m256i b = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(in + i + 8)));
+            a = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(a), vscale));
+            b = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(b), vscale));
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+            _mm256_storeu_si256((__m256i*)(out + i), packed);
+        }
+    }
+    return i;
+}
+
+PCM_TARGET_AVX2
+static UINT32 QuantizeAVX2(const INT16* in, UINT32 count, const INT16* dither, UINT8* out) {
+    const __m256i bias = _mm256_set1_epi16((short)0x8000);
+    UINT32 i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(in + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(in + i + 16));
+        if (dither != NULL) {
+            a = _mm256_adds_epi16(a, _mm256_loadu_si256((const __m256i*)(dither + i)));
+            b = _mm256_adds_epi16(b, _mm256_loadu_si256((const __m256i*)(dither + i + 16)));
+        }
+        a = _mm256_srli_epi16(_mm256_xor_si256(a, bias), 8);
+        b = _mm256_srli_epi16(_mm256_xor_si256(b, bias), 8);
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+        _mm256_storeu_si256((__m256i*)(out + i), packed);
+    }
+    return i;
+}
+
+#endif // PCM_X86
+
+// ---- PCMConditioner ----
+
+PCMConditioner::PCMConditioner()
+    : gain(1.0), dither(PCM_DITHER_NONE), kernel(PCM_KERNEL_SCALAR), ditherPos(0), shapeError(0) {
+}
+
+bool PCMConditioner::IsKernelSupported(PCMKernel k) {
+    switch (k) {
+        case PCM_KERNEL_AUTO:
+        case PCM_KERNEL_SCALAR:
+            return true;
+#ifdef PCM_X86
+        case PCM_KERNEL_SSE2:
+#if defined(__x86_64__) || defined(_M_X64)
+            return true;  // Part of the x86-64 baseline
+#elif defined(__GNUC__)
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2");
+#else
+            {
+                int info[4];
+                __cpuid(info, 1);
+                return (info[3] & (1 << 26)) != 0;
+            }
+#endif
+        case PCM_KERNEL_AVX2:
+#if defined(__GNUC__)
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#else
+            {
+                // AVX2 flag, and the OS saving the YMM registers
+                int info[4];
+                __cpuid(info, 0);
+                if (info[0] < 7) return false;
+                __cpuid(info, 1);
+                if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28))) return false;
+                if ((_xgetbv(0) & 6) != 6) return false;
+                __cpuidex(info, 7, 0);
+                return (info[1] & (1 << 5)) != 0;
+            }
+#endif
+#endif
+        default:
+            return false;
+    }
+}
+
+const char* PCMConditioner::GetKernelName(PCMKernel k) {
+    switch (k) {
+        case PCM_KERNEL_AUTO:   return "auto";
+        case PCM_KERNEL_SCALAR: return "scalar";
+        case PCM_KERNEL_SSE2:   return "sse2";
+        case PCM_KERNEL_AVX2:   return "avx2";
+    }
+    return "unknown";
+}
+
+const char* PCMConditioner::GetDitherName(PCMDither d) {
+    switch (d) {
+        case PCM_DITHER_NONE:   return "none";
+        case PCM_DITHER_TPDF:   return "tpdf";
+        case PCM_DITHER_SHAPED: return "shaped";
+    }
+    return "unknown";
+}
+
+bool PCMConditioner::Init(double g, PCMDither d, PCMKernel k) {
+    if (k == PCM_KERNEL_AUTO) {
+        if (IsKernelSupported(PCM_KERNEL_AVX2)) {
+            k = PCM_KERNEL_AVX2;
+        } else if (IsKernelSupported(PCM_KERNEL_SSE2)) {
+            k = PCM_KERNEL_SSE2;
+        } else {
+            k = PCM_KERNEL_SCALAR;
+        }
+    }
+    if (!IsKernelSupported(k)) {
+        std::cerr << "PCM kernel not supported by this CPU: " << GetKernelName(k) << std::endl;
+        return false;
+    }
+
+    gain = g;
+    dither = d;
+    kernel = k;
+
+    ditherTable.clear();
+    if (dither != PCM_DITHER_NONE) {
+        // Sum of two uniform 8-bit values: triangular over +-1 LSB of the
+        // 8-bit output, offset by half an LSB so truncation rounds instead.
+        // A fixed sequence keeps the output reproducible across kernels.
+        ditherTable.resize(DITHER_TABLE_SIZE + DITHER_TABLE_PAD);
+        UINT32 state = 0x9E3779B9;
+        for (UINT32 i = 0; i < DITHER_TABLE_SIZE; i++) {
+            state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+            INT32 r1 = state >> 24;
+            state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+            INT32 r2 = state >> 24;
+            ditherTable[i] = (INT16)(r1 + r2 - 255 + 128);
+        }
+        for (UINT32 i = 0; i < DITHER_TABLE_PAD; i++) {
+            ditherTable[DITHER_TABLE_SIZE + i] = ditherTable[i];
+        }
+    }
+
+    Reset();
+    return true;
+}
+
+void PCMConditioner::Reset() {
+    ditherPos = 0;
+    shapeError = 0;
+}
+
+void PCMConditioner::Downmix(const INT16* in, UINT32 frames, UINT16 channels, INT16* out) const {
+    if (channels == 0) {
+        return;
+    }
+    bool unity = (gain == 1.0);
+    float scale = (float)(gain / channels);
+
+    if (unity && channels == 1) {
+        if (out != in) {
+            memmove(out, in, frames * sizeof(INT16));
+        }
+        return;
+    }
+
+    UINT32 done = 0;
+#ifdef PCM_X86
+    if (kernel == PCM_KERNEL_AVX2) {
+        done = DownmixAVX2(in, frames, channels, scale, unity, out);
+    } else if (kernel == PCM_KERNEL_SSE2) {
+        done = DownmixSSE2(in, frames, channels, scale, unity, out);
+    }
+#endif
+    DownmixScalar(in, done, frames, channels, scale, unity, out);
+}
+
+void PCMConditioner::Quantize(const INT16* in, UINT32 count, UINT8* out) {
+    if (dither == PCM_DITHER_SHAPED) {
+        QuantizeShaped(in, count, out);
+        return;
+    }
+
+    // Work through the dither table in runs that do not wrap around
+    UINT32 pos = 0;
+    while (pos < count) {
+        UINT32 run = count - pos;
+        const INT16* d = NULL;
+        if (dither == PCM_DITHER_TPDF) {
+            if (run > DITHER_TABLE_SIZE - ditherPos) {
+                run = DITHER_TABLE_SIZE - ditherPos;
+            }
+            d = &ditherTable[ditherPos];
+            ditherPos = (ditherPos + run) & DITHER_TABLE_MASK;
+        }
+
+        UINT32 done = 0;
+#ifdef PCM_X86
+        if (kernel == PCM_KERNEL_AVX2) {
+            done = QuantizeAVX2(in + pos, run, d, out + pos);
+        } else if (kernel == PCM_KERNEL_SSE2) {
+            done = QuantizeSSE2(in + pos, run, d, out + pos);
+        }
+#endif
+        QuantizeScalar(in + pos, done, run, d, out + pos);
+        pos += run;
+    }
+}
+
+void PCMConditioner::QuantizeShaped(const INT16* in, UINT32 count, UINT8* out) {
+    // First-order error feedback: the quantization error of each sample is
+    // subtracted from the next, which moves the noise away from the bass
+    for (UINT32 i = 0; i < count; i++) {
+        INT32 wanted = in[i] - shapeError;
+        UINT8 q = QuantizeSample(wanted + ditherTable[ditherPos]);
+        ditherPos = (ditherPos + 1) & DITHER_TABLE_MASK;
+        out[i] = q;
+
+        // The dither offset makes the quantizer round, so code q stands for q * 256 - 32768
+        shapeError = ((INT32)q * 256 - 32768) - wanted;
+        if (shapeError > SHAPE_ERROR_LIMIT) shapeError = SHAPE_ERROR_LIMIT;
+        if (shapeError < -SHAPE_ERROR_LIMIT) shapeError = -SHAPE_ERROR_LIMIT;
+    }
+}
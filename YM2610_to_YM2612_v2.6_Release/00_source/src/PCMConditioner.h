@@ -0,0 +1,61 @@
+#ifndef PCMCONDITIONER_H
+#define PCMCONDITIONER_H
+
+#include "../libvgm/stdtype.h"
+#include <vector>
+
+enum PCMDither {
+    PCM_DITHER_NONE,    // Truncate to 8 bits (the converter's historical behaviour)
+    PCM_DITHER_TPDF,    // Triangular dither, +-1 LSB
+    PCM_DITHER_SHAPED   // TPDF plus first-order error feedback (noise pushed up in frequency)
+};
+
+enum PCMKernel {
+    PCM_KERNEL_AUTO,    // Best kernel this CPU supports
+    PCM_KERNEL_SCALAR,
+    PCM_KERNEL_SSE2,
+    PCM_KERNEL_AVX2
+};
+
+// Conditions 16-bit PCM for the YM2612 DAC: downmix to mono with a gain,
+// then dither and quantize to 8-bit unsigned. The kernels are vectorized
+// (SSE2/AVX2, chosen at runtime) with a scalar fallback; every kernel gives
+// the same output, dither included. Error feedback (PCM_DITHER_SHAPED) is a
+// serial recurrence, so that quantizer always runs scalar.
+// With gain 1.0 and no dither the output matches the plain
+// (sum / channels + 32768) >> 8 conversion bit for bit.
+class PCMConditioner {
+public:
+    PCMConditioner();
+
+    // Returns false if the kernel is not supported by this CPU
+    bool Init(double gain, PCMDither dither, PCMKernel kernel = PCM_KERNEL_AUTO);
+    // Restart the dither sequence and the error feedback
+    void Reset();
+
+    double GetGain() const { return gain; }
+    PCMKernel GetKernel() const { return kernel; }
+
+    static bool IsKernelSupported(PCMKernel kernel);
+    static const char* GetKernelName(PCMKernel kernel);
+    static const char* GetDitherName(PCMDither dither);
+
+    // Interleaved frames -> mono with the gain applied (saturated).
+    // out may be the same buffer as in.
+    void Downmix(const INT16* in, UINT32 frames, UINT16 channels, INT16* out) const;
+    // Mono 16-bit -> 8-bit unsigned DAC values; consecutive calls continue
+    // one stream (dither position, error feedback)
+    void Quantize(const INT16* in, UINT32 count, UINT8* out);
+
+private:
+    double gain;
+    PCMDither dither;
+    PCMKernel kernel;
+    std::vector<INT16> ditherTable;  // Precomputed TPDF values, replayed cyclically
+    UINT32 ditherPos;
+    INT32 shapeError;                // Error feedback state (16-bit units)
+
+    void QuantizeShaped(const INT16* in, UINT32 count, UINT8* out);
+};
+
+#endif // PCMCONDITIONER_H
@@ -0,0 +1,719 @@
+#include "VGMConverterWithDAC.h"
+#include "VGMValidator.h"
+#include "DACResampler.h"
+#include "PCMConditioner.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+
+#pragma pack(push, 1)
+struct WAVHeader {
+    char riff[4];           // "RIFF"
+    uint32_t fileSize;      // File size - 8
+    char wave[4];           // "WAVE"
+    char fmt[4];            // "fmt "
+    uint32_t fmtSize;       // Format chunk size
+    uint16_t audioFormat;   // Audio format (1 = PCM)
+    uint16_t numChannels;   // Number of channels
+    uint32_t sampleRate;    // Sample rate
+    uint32_t byteRate;      // Byte rate
+    uint16_t blockAlign;    // Block align
+    uint16_t bitsPerSample; // Bits per sample
+    char data[4];           // "data"
+    uint32_t dataSize;      // Data size
+};
+#pragma pack(pop)
+
+class WAVReader {
+public:
+    bool Load(const std::string& filename, std::ostream& log) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file) {
+            std::cerr << "Failed to open WAV file: " << filename << std::endl;
+            return false;
+        }
+
+        // Read RIFF header
+        char riff[4];
+        uint32_t fileSize;
+        char wave[4];
+        file.read(riff, 4);
+        file.read(reinterpret_cast<char*>(&fileSize), 4);
+        file.read(wave, 4);
+
+        if (std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(wave, "WAVE", 4) != 0) {
+            std::cerr << "Invalid WAV file" << std::endl;
+            return false;
+        }
+
+        // Read fmt chunk
+        char fmt[4];
+        uint32_t fmtSize;
+        file.read(fmt, 4);
+        file.read(reinterpret_cast<char*>(&fmtSize), 4);
+
+        if (std::memcmp(fmt, "fmt ", 4) != 0) {
+            std::cerr << "Invalid fmt chunk" << std::endl;
+            return false;
+        }
+
+        // Read format data
+        file.read(reinterpret_cast<char*>(&audioFormat), 2);
+        file.read(reinterpret_cast<char*>(&numChannels), 2);
+        file.read(reinterpret_cast<char*>(&sampleRate), 4);
+        file.read(reinterpret_cast<char*>(&byteRate), 4);
+        file.read(reinterpret_cast<char*>(&blockAlign), 2);
+        file.read(reinterpret_cast<char*>(&bitsPerSample), 2);
+
+        // Skip any extra format bytes
+        if (fmtSize > 16) {
+            file.seekg(fmtSize - 16, std::ios::cur);
+        }
+
+        // Find data chunk
+        char chunkId[4];
+        uint32_t chunkSize;
+        bool foundData = false;
+
+        while (file.read(chunkId, 4)) {
+            file.read(reinterpret_cast<char*>(&chunkSize), 4);
+
+            if (std::memcmp(chunkId, "data", 4) == 0) {
+                foundData = true;
+                break;
+            }
+
+            // Skip this chunk
+            file.seekg(chunkSize, std::ios::cur);
+        }
+
+        if (!foundData) {
+            std::cerr << "No data chunk found" << std::endl;
+            return false;
+        }
+
+        // Read samples
+        uint32_t numSamples = chunkSize / sizeof(int16_t);
+        samples.resize(numSamples);
+        file.read(reinterpret_cast<char*>(samples.data()), chunkSize);
+
+        log << "Loaded WAV file:" << std::endl;
+        log << "  Sample rate: " << sampleRate << " Hz" << std::endl;
+        log << "  Channels: " << numChannels << std::endl;
+        log << "  Bits per sample: " << bitsPerSample << std::endl;
+        log << "  Samples: " << numSamples << " (" << numSamples / numChannels << " frames)" << std::endl;
+
+        return true;
+    }
+
+    uint16_t GetAudioFormat() const { return audioFormat; }
+    uint16_t GetNumChannels() const { return numChannels; }
+    uint32_t GetSampleRate() const { return sampleRate; }
+    uint16_t GetBitsPerSample() const { return bitsPerSample; }
+    const std::vector<int16_t>& GetSamples() const { return samples; }
+
+private:
+    uint16_t audioFormat;
+    uint16_t numChannels;
+    uint32_t sampleRate;
+    uint32_t byteRate;
+    uint16_t blockAlign;
+    uint16_t bitsPerSample;
+    std::vector<int16_t> samples;
+};
+
+VGMConverterWithDAC::VGMConverterWithDAC(ADPCMSampleBank& bank)
+    : reader(), writer(), mapper(writer), sampleBank(bank), streamer(writer, bank),
+      dacMode(DAC_MODE_DIRECT), renderADPCM(false), dacChangesOnly(false),
+      dacRateOverride(0), pcmGain(1.0), pcmDither(PCM_DITHER_NONE), log(&std::cout) {
+}
+
+bool VGMConverterWithDAC::Convert(const std::string& inputVGM, const std::string& inputWAV, const std::string& outputFile) {
+    *log << "=== YM2610 to YM2612 VGM Converter with DAC ===" << std::endl;
+    *log << std::endl;
+
+    // Load input VGM
+    *log << "Loading VGM file: " << inputVGM << std::endl;
+    if (!reader.Load(inputVGM)) {
+        std::cerr << "Failed to load VGM file" << std::endl;
+        return false;
+    }
+
+    return LoadAndConvert(inputWAV, outputFile);
+}
+
+bool VGMConverterWithDAC::Convert(std::vector<UINT8>& vgmData, const std::string& name, const std::string& outputFile) {
+    *log << "=== YM2610 to YM2612 VGM Converter with DAC ===" << std::endl;
+    *log << std::endl;
+
+    *log << "Loading VGM data: " << name << std::endl;
+    if (!reader.Load(vgmData, name)) {
+        std::cerr << "Failed to load VGM data" << std::endl;
+        return false;
+    }
+
+    return LoadAndConvert("", outputFile);
+}
+
+bool VGMConverterWithDAC::LoadAndConvert(const std::string& inputWAV, const std::string& outputFile) {
+    const VGMHeader& header = reader.GetHeader();
+
+    // Check if it's a YM2610 VGM
+    if (header.ym2610Clock == 0) {
+        std::cerr << "Error: Input file does not contain YM2610 data" << std::endl;
+        return false;
+    }
+
+    *log << std::endl;
+
+    if (dacMode == DAC_MODE_STREAM) {
+        // ADPCM samples are decoded from the VGM's own ROM data blocks
+        PrepareStreamData();
+    } else if (renderADPCM) {
+        if (!PrepareRenderedDAC()) {
+            std::cerr << "Failed to render ADPCM" << std::endl;
+            return false;
+        }
+    } else {
+        // Load ADPCM WAV
+        *log << "Loading ADPCM WAV file: " << inputWAV << std::endl;
+        WAVReader wavReader;
+        if (!wavReader.Load(inputWAV, *log)) {
+            std::cerr << "Failed to load WAV file" << std::endl;
+            return false;
+        }
+
+        *log << std::endl;
+
+        // Prepare DAC samples
+        if (!PrepareDACData(wavReader)) {
+            std::cerr << "Failed to prepare DAC data" << std::endl;
+            return false;
+        }
+    }
+
+    *log << std::endl;
+
+    // Initialize writer with YM2612 clock (same as YM2610)
+    UINT32 ym2612Clock = header.ym2610Clock;
+    writer.Initialize(header, ym2612Clock);
+
+    // Copy GD3 tag data
+    std::vector<UINT8> gd3Data = reader.GetGD3Data();
+    if (!gd3Data.empty()) {
+        writer.SetGD3Data(gd3Data);
+        *log << "Copied GD3 tag (" << gd3Data.size() << " bytes)" << std::endl;
+    }
+
+    // Commands go to disk while converting; the header is patched on save
+    if (!writer.OpenStream(outputFile)) {
+        return false;
+    }
+
+    // Convert commands with DAC
+    *log << "Converting VGM commands with DAC..." << std::endl;
+    if (!ConvertCommands()) {
+        std::cerr << "Failed to convert commands" << std::endl;
+        return false;
+    }
+
+    *log << std::endl;
+
+    // Finish output VGM
+    *log << "Finishing output file: " << outputFile << std::endl;
+    if (!writer.Save(outputFile)) {
+        std::cerr << "Failed to save output file" << std::endl;
+        return false;
+    }
+
+    *log << std::endl;
+    PrintStatistics();
+
+    // Validate output VGM
+    *log << "Validating output VGM..." << std::endl;
+    VGMValidator validator;
+    validator.SetLog(*log);
+    if (validator.Validate(outputFile)) {
+        validator.PrintReport();
+    } else {
+        std::cerr << "Output VGM validation failed!" << std::endl;
+        validator.PrintReport();
+        return false;
+    }
+
+    return true;
+}
+
+bool VGMConverterWithDAC::PrepareDACData(const WAVReader& wavReader) {
+    const std::vector<int16_t>& samples = wavReader.GetSamples();
+    UINT16 numChannels = wavReader.GetNumChannels();
+    dacSampleRate = wavReader.GetSampleRate();
+    vgmSampleRate = 44100;  // VGM standard sample rate
+
+    *log << "Preparing DAC data..." << std::endl;
+
+    // The WAV already has vgm2wav_adpcm_only's gain; pcmGain comes on top
+    PCMConditioner conditioner;
+    if (!conditioner.Init(pcmGain, pcmDither)) {
+        return false;
+    }
+
+    // Mix channels to mono
+    UINT32 numFrames = samples.size() / numChannels;
+    std::vector<INT16> mono(numFrames);
+    if (numFrames > 0) {
+        conditioner.Downmix(&samples[0], numFrames, numChannels, &mono[0]);
+    }
+
+    if (dacRateOverride != 0 && dacRateOverride != dacSampleRate) {
+        *log << "  Resampling " << dacSampleRate << " Hz -> " << dacRateOverride << " Hz" << std::endl;
+        std::vector<INT16> resampled;
+        if (!DACResampler::Resample(mono, dacSampleRate, dacRateOverride, resampled)) {
+            return false;
+        }
+        mono.swap(resampled);
+        dacSampleRate = dacRateOverride;
+    }
+
+    // Convert to 8-bit unsigned (0-255)
+    dacSamples.resize(mono.size());
+    if (!mono.empty()) {
+        conditioner.Quantize(&mono[0], mono.size(), &dacSamples[0]);
+    }
+
+    *log << "  Prepared " << dacSamples.size() << " DAC samples" << std::endl;
+    *log << "  DAC sample rate: " << dacSampleRate << " Hz" << std::endl;
+    *log << "  VGM sample rate: " << vgmSampleRate << " Hz" << std::endl;
+    *log << "  PCM gain: " << pcmGain << ", dither: " << PCMConditioner::GetDitherName(pcmDither)
+              << " (" << PCMConditioner::GetKernelName(conditioner.GetKernel()) << ")" << std::endl;
+    *log << "  Sample rate ratio: " << (double)vgmSampleRate / dacSampleRate << "x" << std::endl;
+
+    ResetDACState();
+    return true;
+}
+
+bool VGMConverterWithDAC::PrepareRenderedDAC() {
+    // Same rate vgm2wav_adpcm_only renders at
+    UINT32 renderRate = 22050;
+    dacSampleRate = dacRateOverride ? dacRateOverride : renderRate;
+    vgmSampleRate = 44100;
+
+    *log << "Rendering ADPCM in-process..." << std::endl;
+    renderer.SetGain(ADPCM_RENDER_GAIN * pcmGain);
+    renderer.SetDither(pcmDither);
+    renderer.SetSampleCache(sampleBank.GetChipCache());
+    if (!renderer.Open(reader.GetData(), reader.GetSize(), renderRate, dacSampleRate)) {
+        return false;
+    }
+    if (dacSampleRate != renderRate) {
+        *log << "  Resampling " << renderRate << " Hz -> " << dacSampleRate << " Hz" << std::endl;
+    }
+
+    *log << "  DAC samples: " << renderer.GetTotalSamples() << std::endl;
+    *log << "  DAC sample rate: " << dacSampleRate << " Hz" << std::endl;
+    *log << "  VGM sample rate: " << vgmSampleRate << " Hz" << std::endl;
+    *log << "  PCM gain: " << pcmGain << ", dither: " << PCMConditioner::GetDitherName(pcmDither) << std::endl;
+
+    dacSamples.clear();
+    if (dacMode == DAC_MODE_PCM_BANK) {
+        // The bank is written before any command, so it needs every sample up front
+        dacSamples.resize(renderer.GetTotalSamples());
+        for (UINT32 i = 0; i < dacSamples.size(); i++) {
+            dacSamples[i] = renderer.GetSample(i);
+        }
+        renderer.Close();
+        renderADPCM = false;
+    }
+
+    ResetDACState();
+    return true;
+}
+
+UINT32 VGMConverterWithDAC::GetDACSampleCount() const {
+    return renderADPCM ? renderer.GetTotalSamples() : dacSamples.size();
+}
+
+UINT8 VGMConverterWithDAC::GetDACSample(UINT32 index) {
+    // Silence once the samples run out
+    if (renderADPCM) {
+        return renderer.GetSample(index);
+    }
+    return (index < dacSamples.size()) ? dacSamples[index] : 0x80;
+}
+
+void VGMConverterWithDAC::ResetDACState() {
+    dacSampleIndex = 0;
+    dacAccumulator = 0.0;
+    lastDacSample = 0x80;  // Initialize to silence (center value)
+    dacLatched = 0;
+    dacValueKnown = false;
+
+    bankPos = 0;
+    bankLatched = 0xFFFFFFFF;
+    bankPendingWait = 0;
+    bankPendingWrite = false;
+}
+
+void VGMConverterWithDAC::PrepareStreamData() {
+    *log << "Using DAC stream mode (ADPCM key-on -> 0x90-0x95)" << std::endl;
+
+    dacSamples.clear();
+    dacSampleIndex = 0;
+    dacAccumulator = 0.0;
+    lastDacSample = 0x80;
+    mapper.SetADPCMStreamer(&streamer);
+
+    LoadADPCMROMs();
+    ScanADPCMKeyOns();
+}
+
+void VGMConverterWithDAC::ScanADPCMKeyOns() {
+    // Let the streamer see every ADPCM register write once before
+    // converting, so all samples can be written ahead of the commands
+    const UINT8* data = reader.GetData();
+    UINT32 pos = reader.GetDataStart();
+    UINT32 dataSize = reader.GetSize();
+
+    streamer.BeginScan();
+    while (pos < dataSize && data[pos] != 0x66) {
+        UINT32 len = GetCommandLength(data[pos], data, pos, dataSize);
+        if (len == 0 || pos + len > dataSize) break;
+
+        if (data[pos] == 0x58 && data[pos + 1] >= 0x10 && data[pos + 1] <= 0x1C) {
+            streamer.WriteADPCMB(data[pos + 1], data[pos + 2]);
+        } else if (data[pos] == 0x59 && data[pos + 1] <= 0x2F) {
+            streamer.WriteADPCMA(data[pos + 1], data[pos + 2]);
+        }
+        pos += len;
+    }
+}
+
+void VGMConverterWithDAC::LoadADPCMROMs() {
+    // Collect the ADPCM-A/B ROM data blocks of the whole track up front,
+    // so a ROM shared with the previous track is not decoded again
+    const UINT8* data = reader.GetData();
+    UINT32 pos = reader.GetDataStart();
+    UINT32 dataSize = reader.GetSize();
+    std::vector<ADPCMSampleBank::ROMBlock> blocks;
+
+    while (pos < dataSize && data[pos] != 0x66) {
+        UINT32 len = GetCommandLength(data[pos], data, pos, dataSize);
+        if (len == 0 || pos + len > dataSize) break;
+
+        if (data[pos] == 0x67) {
+            UINT8 blockType = data[pos + 2];
+            if (blockType == 0x82 || blockType == 0x83) {
+                ADPCMSampleBank::ROMBlock block;
+                block.type = blockType;
+                block.data = &data[pos + 7];
+                block.size = len - 7;
+                blocks.push_back(block);
+            }
+        }
+        pos += len;
+    }
+
+    UINT32 reused = sampleBank.LoadROMSet(blocks);
+    *log << "  ADPCM ROM blocks: " << blocks.size() << " (" << reused
+              << " unchanged from previous tracks)" << std::endl;
+}
+
+void VGMConverterWithDAC::WritePCMBank() {
+    // Pack all DAC samples into one YM2612 PCM data block (type 0x00).
+    // One trailing 0x80 byte is used as silence once the samples run out.
+    std::vector<UINT8> bank(dacSamples);
+    bank.push_back(0x80);
+    writer.WriteDataBlock(0x00, bank);
+
+    *log << "  PCM bank: " << bank.size() << " bytes" << std::endl;
+}
+
+void VGMConverterWithDAC::FlushPCMBankWrite() {
+    // Emit the pending 0x8n with as much of the wait as fits (max 15),
+    // then the remainder as regular wait commands
+    if (bankPendingWrite) {
+        UINT32 n = (bankPendingWait > 15) ? 15 : bankPendingWait;
+        writer.WriteCommand(0x80 | n);
+        bankPendingWait -= n;
+        bankPendingWrite = false;
+    }
+    writer.WriteWait(bankPendingWait);
+    bankPendingWait = 0;
+}
+
+void VGMConverterWithDAC::WriteDACBankForSamples(UINT32 vgmSamples) {
+    // Same nearest-neighbour stepping as WriteDACForSamples, but the sample
+    // values come from the PCM bank: only a change of sample costs a byte
+    double ratio = (double)vgmSampleRate / dacSampleRate;
+    UINT32 silenceIndex = dacSamples.size();
+
+    for (UINT32 i = 0; i < vgmSamples; i++) {
+        dacAccumulator += 1.0 / ratio;
+        UINT32 targetIndex = (UINT32)dacAccumulator;
+        if (targetIndex > silenceIndex) {
+            targetIndex = silenceIndex;
+        }
+
+        if (targetIndex != bankLatched) {
+            FlushPCMBankWrite();
+            if (targetIndex != bankPos) {
+                writer.WritePCMSeek(targetIndex);
+            }
+            bankPendingWrite = true;
+            bankLatched = targetIndex;
+            bankPos = targetIndex + 1;
+        }
+        bankPendingWait++;
+    }
+
+    // Commands following this wait must not be reordered before it
+    FlushPCMBankWrite();
+
+    dacSampleIndex = (UINT32)dacAccumulator;
+}
+
+void VGMConverterWithDAC::WriteDACForSamples(UINT32 vgmSamples) {
+    if (dacMode == DAC_MODE_STREAM) {
+        // The stream plays by itself, only the wait is needed
+        writer.WriteWait(vgmSamples);
+        return;
+    }
+    if (dacMode == DAC_MODE_PCM_BANK) {
+        WriteDACBankForSamples(vgmSamples);
+        return;
+    }
+
+    // Write DAC samples with proper timing, handling sample rate conversion
+    // dacSampleRate (e.g., 22050) -> vgmSampleRate (44100)
+    // Ratio = vgmSampleRate / dacSampleRate (e.g., 2.0)
+
+    double ratio = (double)vgmSampleRate / dacSampleRate;
+    UINT32 pendingWait = 0;  // Ticks since the last DAC write
+
+    for (UINT32 i = 0; i < vgmSamples; i++) {
+        // Calculate which DAC sample to use
+        dacAccumulator += 1.0 / ratio;
+        UINT32 targetIndex = (UINT32)dacAccumulator;
+
+        // The DAC holds its value: write each DAC sample once (or, in
+        // changes-only mode, only when the value changes) and cover the
+        // ticks in between with a single wait
+        UINT8 sample = GetDACSample(targetIndex);
+        bool changed = dacChangesOnly ? (sample != lastDacSample) : (targetIndex != dacLatched);
+        if (!dacValueKnown || changed) {
+            writer.WriteWait(pendingWait);
+            writer.WriteCommand(0x52, 0x2A, sample);
+            lastDacSample = sample;
+            dacLatched = targetIndex;
+            dacValueKnown = true;
+            pendingWait = 0;
+        }
+        pendingWait++;
+    }
+    writer.WriteWait(pendingWait);
+
+    // Update dacSampleIndex to track progress
+    dacSampleIndex = (UINT32)dacAccumulator;
+}
+
+bool VGMConverterWithDAC::ConvertCommands() {
+    const UINT8* data = reader.GetData();
+    UINT32 pos = reader.GetDataStart();
+    UINT32 dataSize = reader.GetSize();
+    const VGMHeader& header = reader.GetHeader();
+
+    // Calculate loop position in source VGM
+    UINT32 loopPos = 0;
+    if (header.loopOffset > 0) {
+        loopPos = 0x1C + header.loopOffset;
+    }
+
+    // Enable DAC: write 0x80 to register 0x2B
+    writer.WriteCommand(0x52, 0x2B, 0x80);
+
+    // Set channel 6 (FM channel 5, index 2 in port 1) pan to both speakers
+    // Register 0xB6 (0xB4 + channel 2): bits 7-6 = L/R enable
+    // 0xC0 = both left and right enabled
+    writer.WriteCommand(0x53, 0xB6, 0xC0);
+
+    if (dacMode == DAC_MODE_PCM_BANK) {
+        WritePCMBank();
+        writer.WritePCMSeek(0);
+    } else if (dacMode == DAC_MODE_STREAM) {
+        // DAC Stream Control commands need VGM 1.60
+        writer.RequireVersion(0x160);
+        streamer.Initialize(header.ym2610Clock);
+    }
+
+    while (pos < dataSize) {
+        // Check if we've reached the loop point
+        if (loopPos > 0 && pos == loopPos) {
+            writer.MarkLoopPoint();
+
+            // On the second pass the DAC still holds the last value of the song
+            dacValueKnown = false;
+            bankLatched = 0xFFFFFFFF;
+
+            // The bank pointer is not rewound on loop, so seek explicitly
+            if (dacMode == DAC_MODE_PCM_BANK) {
+                writer.WritePCMSeek(bankPos);
+            }
+        }
+
+        UINT8 cmd = data[pos];
+
+        if (cmd == 0x66) {
+            // End of data
+            writer.WriteCommand(0x66);
+            break;
+        }
+        else if (cmd == 0x67) {
+            // Data block - skip (ADPCM ROMs are loaded up front in stream mode)
+            if (pos + 6 >= dataSize) break;
+            UINT32 blockSize = VGMReader::ReadLE32(&data[pos + 3]);
+            pos += 7 + blockSize;
+        }
+        else if (cmd == 0x58) {
+            // YM2610 port 0 write
+            if (pos + 2 >= dataSize) break;
+            UINT8 reg = data[pos + 1];
+            UINT8 val = data[pos + 2];
+
+            // Remap FM channel 6 to FM channel 4 (v2.3 mapping)
+            // Key on/off register 0x28: bits 0-2 = channel
+            if (reg == 0x28) {
+                UINT8 channel = val & 0x07;
+                if (channel == 6) {
+                    // Remap FM6 (channel 6) to FM4 (channel 4)
+                    val = (val & 0xF8) | 4;
+                }
+            }
+
+            mapper.ProcessYM2610Port0(reg, val);
+            pos += 3;
+        }
+        else if (cmd == 0x59) {
+            // YM2610 port 1 write
+            if (pos + 2 >= dataSize) break;
+            UINT8 reg = data[pos + 1];
+            UINT8 val = data[pos + 2];
+
+            // Remap FM channel 6 (channel 2 in port 1) to FM channel 4 (channel 0 in port 1)
+            // Channel-specific registers: 0x30-0xB6
+            // ADPCM-A registers (0x00-0x2F) are passed through for the streamer
+            if (reg >= 0x30 && reg <= 0xB6) {
+                UINT8 channel_offset = reg & 0x03;
+                if (channel_offset == 2) {
+                    // Remap FM6 to FM4 (channel 0 in port 1)
+                    reg = (reg & 0xFC) | 0;
+                }
+            }
+            mapper.ProcessYM2610Port1(reg, val);
+
+            pos += 3;
+        }
+        else if (cmd == 0x61) {
+            // Wait N samples
+            if (pos + 2 >= dataSize) break;
+            UINT16 samples = VGMReader::ReadLE16(&data[pos + 1]);
+
+            // Write DAC samples for this delay (includes wait commands)
+            WriteDACForSamples(samples);
+
+            // Don't write the original wait command - it's already included in WriteDACForSamples
+            pos += 3;
+        }
+        else if (cmd == 0x62) {
+            // Wait 735 samples (1/60 sec)
+            WriteDACForSamples(735);
+            // Don't write the original wait command
+            pos += 1;
+        }
+        else if (cmd == 0x63) {
+            // Wait 882 samples (1/50 sec)
+            WriteDACForSamples(882);
+            // Don't write the original wait command
+            pos += 1;
+        }
+        else if (cmd >= 0x70 && cmd <= 0x7F) {
+            // Wait 1-16 samples
+            UINT8 waitSamples = (cmd & 0x0F) + 1;
+            WriteDACForSamples(waitSamples);
+            // Don't write the original wait command
+            pos += 1;
+        }
+        else {
+            // Unknown/unsupported command - skip
+            UINT32 len = GetCommandLength(cmd, data, pos, dataSize);
+            if (len == 0) {
+                std::cerr << "Warning: Unknown command 0x" << VGMReader::ToHex(cmd)
+                          << " at position 0x" << VGMReader::ToHex(pos) << std::endl;
+                break;
+            }
+            pos += len;
+        }
+    }
+
+    if (dacMode != DAC_MODE_STREAM) {
+        *log << "  Wrote " << dacSampleIndex << " / " << GetDACSampleCount() << " DAC samples" << std::endl;
+    }
+    if (renderADPCM && renderer.HasSeekError()) {
+        return false;
+    }
+
+    return true;
+}
+
+UINT32 VGMConverterWithDAC::GetCommandLength(UINT8 cmd, const UINT8* data, UINT32 pos, UINT32 dataSize) {
+    if (cmd >= 0x70 && cmd <= 0x7F) return 1;
+    if (cmd >= 0x80 && cmd <= 0x8F) return 1;
+
+    switch (cmd) {
+        case 0x50: return 2;
+        case 0x51: return 3;
+        case 0x52: return 3;
+        case 0x53: return 3;
+        case 0x54: return 3;
+        case 0x55: return 3;
+        case 0x56: return 3;
+        case 0x57: return 3;
+        case 0x58: return 3;
+        case 0x59: return 3;
+        case 0x61: return 3;
+        case 0x62: return 1;
+        case 0x63: return 1;
+        case 0x66: return 1;
+        case 0x67: {
+            if (pos + 6 >= dataSize) return 0;
+            UINT32 blockSize = VGMReader::ReadLE32(&data[pos + 3]);
+            return 7 + blockSize;
+        }
+        case 0x90: return 5;
+        case 0x91: return 5;
+        case 0x92: return 6;
+        case 0x93: return 11;
+        case 0x94: return 2;
+        case 0x95: return 5;
+        case 0xE0: return 5;
+        default:
+            return 0;
+    }
+}
+
+void VGMConverterWithDAC::PrintStatistics() {
+    *log << "=== Conversion Statistics ===" << std::endl;
+    *log << "  FM commands converted: " << mapper.GetFMCommandCount() << std::endl;
+    *log << "  SSG commands discarded: " << mapper.GetSSGCommandCount() << std::endl;
+    if (dacMode == DAC_MODE_STREAM) {
+        *log << "  ADPCM commands processed: " << mapper.GetADPCMCommandCount() << std::endl;
+        *log << "  ADPCM key-ons: " << streamer.GetKeyOnCount() << std::endl;
+        *log << "  DAC streams started: " << streamer.GetStreamStartCount() << std::endl;
+        *log << "  Samples in ADPCM cache: " << sampleBank.GetSampleCount()
+                  << " (" << sampleBank.GetDecodedBytes() << " bytes)" << std::endl;
+    } else {
+        *log << "  DAC samples written: " << dacSampleIndex << std::endl;
+    }
+    *log << std::endl;
+    *log << "Conversion completed successfully!" << std::endl;
+}
@@ -0,0 +1,118 @@
+#ifndef VGMCONVERTERWITHDAC_H
+#define VGMCONVERTERWITHDAC_H
+
+#include "../libvgm/stdtype.h"
+#include "VGMReader.h"
+#include "VGMWriter.h"
+#include "CommandMapper.h"
+#include "ADPCMSampleBank.h"
+#include "ADPCMStreamer.h"
+#include "ADPCMRenderer.h"
+#include <vector>
+#include <string>
+
+class WAVReader;
+
+// DAC output modes
+enum DACMode {
+    DAC_MODE_DIRECT,    // 0x52 0x2A xx + 0x70 for every VGM sample tick
+    DAC_MODE_PCM_BANK,  // YM2612 PCM data block + 0xE0 seek + 0x8n write/wait
+    DAC_MODE_STREAM     // ADPCM key-on events -> DAC Stream Control (0x90-0x95), no WAV
+};
+
+// Converts one YM2610 VGM to YM2612: FM through CommandMapper, ADPCM on the
+// YM2612 DAC (from a WAV, rendered in-process, or as DAC streams).
+// Use one converter per track.
+class VGMConverterWithDAC {
+public:
+    // The sample bank may be shared by several converters (one per track of a game)
+    VGMConverterWithDAC(ADPCMSampleBank& bank);
+
+    void SetDACMode(DACMode mode) { dacMode = mode; }
+
+    // Render ADPCM with libvgm in-process instead of reading a WAV file
+    void SetRenderADPCM(bool render) { renderADPCM = render; }
+
+    // Write .vgz output with this zlib level (0 = plain .vgm)
+    void SetCompression(int level) { writer.SetCompression(level); }
+
+    // Drop redundant register writes and merge waits (VGMWriter::SetOptimize)
+    void SetOptimize(bool enable) { writer.SetOptimize(enable); }
+
+    // Limit register writes per sample for hardware players (VGMWriter::SetWriteBudget)
+    void SetWriteBudget(UINT32 writesPerTick, UINT32 toleranceTicks) { writer.SetWriteBudget(writesPerTick, toleranceTicks); }
+
+    // Direct DAC mode writes 0x2A once per DAC sample and covers the ticks
+    // until the next one with one wait. With this, only writes that change
+    // the value are kept.
+    void SetDACChangesOnly(bool enable) { dacChangesOnly = enable; }
+
+    // Resample the DAC feed to this rate (0 = keep the WAV / render rate).
+    // In direct mode a lower rate means fewer DAC writes and waits (a 0x2A
+    // write per DAC sample); the resampler band-limits first.
+    void SetDACRate(UINT32 rate) { dacRateOverride = rate; }
+
+    // Gain on the DAC feed (1.0 = the level vgm2wav_adpcm_only renders at)
+    // and dither for the 8-bit quantization (PCMConditioner)
+    void SetPCMGain(double gain) { pcmGain = gain; }
+    void SetDither(PCMDither dither) { pcmDither = dither; }
+
+    // Stream for the progress output of the converter and its reader, writer
+    // and validator (default std::cout). Errors always go to std::cerr.
+    void SetLog(std::ostream& out) { log = &out; reader.SetLog(out); writer.SetLog(out); }
+
+    bool Convert(const std::string& inputVGM, const std::string& inputWAV, const std::string& outputFile);
+
+    // Convert a VGM/VGZ image already in memory (e.g. a zip entry); takes
+    // over the contents of vgmData. Stream or render mode only.
+    bool Convert(std::vector<UINT8>& vgmData, const std::string& name, const std::string& outputFile);
+
+private:
+    VGMReader reader;
+    VGMWriter writer;
+    CommandMapper mapper;
+    ADPCMSampleBank& sampleBank;
+    ADPCMStreamer streamer;
+    ADPCMRenderer renderer;
+    std::vector<UINT8> dacSamples;  // Mono 8-bit unsigned samples (WAV input, or bank mode)
+    UINT32 dacSampleIndex;
+    UINT32 dacSampleRate;
+    UINT32 vgmSampleRate;  // VGM sample rate (44100)
+    double dacAccumulator;  // Accumulator for fractional DAC samples
+    UINT8 lastDacSample;  // Track last written sample to skip redundant writes
+    UINT32 dacLatched;    // Direct mode: index of the DAC sample last written
+    bool dacValueKnown;   // lastDacSample / dacLatched is what the DAC holds (false after the loop point)
+    DACMode dacMode;
+    bool renderADPCM;       // DAC samples come from renderer instead of dacSamples
+    bool dacChangesOnly;    // Direct mode: skip 0x2A writes that repeat the last value
+    UINT32 dacRateOverride; // Requested DAC rate, 0 = source rate
+    double pcmGain;
+    PCMDither pcmDither;
+    std::ostream* log;
+
+    // PCM bank mode state
+    UINT32 bankPos;         // Next byte the 0x8n command will read from the bank
+    UINT32 bankLatched;     // Bank index currently on the DAC (0xFFFFFFFF = unknown)
+    UINT32 bankPendingWait; // Samples to wait after the pending bank write
+    bool bankPendingWrite;  // A 0x8n write is pending until its wait is known
+
+    bool LoadAndConvert(const std::string& inputWAV, const std::string& outputFile);
+    bool PrepareDACData(const WAVReader& wavReader);
+    bool PrepareRenderedDAC();
+    UINT32 GetDACSampleCount() const;
+
+    UINT8 GetDACSample(UINT32 index);
+    void ResetDACState();
+    void PrepareStreamData();
+    void ScanADPCMKeyOns();
+    void LoadADPCMROMs();
+    void WritePCMBank();
+    void FlushPCMBankWrite();
+    void WriteDACBankForSamples(UINT32 vgmSamples);
+    void WriteDACForSamples(UINT32 vgmSamples);
+    bool ConvertCommands();
+    UINT32 GetCommandLength(UINT8 cmd, const UINT8* data, UINT32 pos, UINT32 dataSize);
+    void PrintStatistics();
+};
+
+#endif // VGMCONVERTERWITHDAC_H
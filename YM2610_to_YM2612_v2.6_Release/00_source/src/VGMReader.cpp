@@ -1,9 +1,10 @@
 #include "VGMReader.h"
-#include <fstream>
+#include <zlib.h>
 #include <cstring>
+#include <cstdio>
 #include <iostream>
 
-VGMReader::VGMReader() : valid(false), dataStart(0) {
+VGMReader::VGMReader() : valid(false), dataStart(0), log(&std::cout) {
     memset(&header, 0, sizeof(header));
 }
 
@@ -11,23 +12,35 @@ VGMReader::~VGMReader() {
 }
 
 bool VGMReader::Load(const std::string& filename) {
-    std::ifstream file(filename, std::ios::binary | std::ios::ate);
-    if (!file.is_open()) {
+    valid = false;
+    if (!file.Open(filename)) {
         std::cerr << "Failed to open file: " << filename << std::endl;
         return false;
     }
 
-    // Get file size
-    std::streamsize size = file.tellg();
-    file.seekg(0, std::ios::beg);
+    return Parse(filename);
+}
 
-    // Read entire file
-    data.resize(size);
-    if (!file.read((char*)data.data(), size)) {
-        std::cerr << "Failed to read file: " << filename << std::endl;
-        return false;
+bool VGMReader::Load(std::vector<UINT8>& data, const std::string& name) {
+    valid = false;
+    file.Assign(data);
+    return Parse(name);
+}
+
+bool VGMReader::Parse(const std::string& name) {
+    // .vgz: inflate in memory, the mapping is replaced by the decompressed data
+    if (IsGzip(file.Data(), file.Size())) {
+        std::vector<UINT8> inflated;
+        if (!InflateGzip(file.Data(), file.Size(), inflated)) {
+            std::cerr << "Failed to decompress VGZ file: " << name << std::endl;
+            return false;
+        }
+        file.Assign(inflated);
     }
 
+    const UINT8* data = file.Data();
+    UINT32 size = file.Size();
+
     // Validate VGM signature
     if (size < 0x40) {
         std::cerr << "File too small to be a valid VGM" << std::endl;
@@ -41,7 +54,8 @@ bool VGMReader::Load(const std::string& filename) {
     }
 
     // Parse header
-    memcpy(&header, data.data(), sizeof(VGMHeader));
+    memset(&header, 0, sizeof(header));
+    memcpy(&header, data, (size < sizeof(VGMHeader)) ? size : sizeof(VGMHeader));
 
     // Calculate data start offset
     if (header.version >= 0x150) {
@@ -50,25 +64,84 @@ bool VGMReader::Load(const std::string& filename) {
         dataStart = 0x40;
     }
 
-    if (dataStart >= data.size()) {
+    if (dataStart >= size) {
         std::cerr << "Invalid data offset" << std::endl;
         return false;
     }
 
     valid = true;
-    std::cout << "VGM loaded successfully:" << std::endl;
-    std::cout << "  Version: " << std::hex << header.version << std::dec << std::endl;
-    std::cout << "  Total samples: " << header.totalSamples << std::endl;
-    std::cout << "  YM2610 clock: " << header.ym2610Clock << " Hz" << std::endl;
-    std::cout << "  Data start: 0x" << std::hex << dataStart << std::dec << std::endl;
+    *log << "VGM loaded successfully:" << std::endl;
+    *log << "  Version: " << ToHex(header.version) << std::endl;
+    *log << "  Total samples: " << header.totalSamples << std::endl;
+    *log << "  YM2610 clock: " << header.ym2610Clock << " Hz" << std::endl;
+    *log << "  Data start: 0x" << ToHex(dataStart) << std::endl;
 
     return true;
 }
 
+bool VGMReader::IsGzip(const UINT8* data, UINT32 size) {
+    return size >= 2 && data[0] == 0x1F && data[1] == 0x8B;
+}
+
+bool VGMReader::InflateGzip(const UINT8* data, UINT32 size, std::vector<UINT8>& out) {
+    out.clear();
+    if (size >= 18) {
+        // ISIZE of the last member; a good first guess for single-member files.
+        // It comes from the file, so trust it only as far as deflate can
+        // plausibly expand (about 1:1000 at best, VGMs reach 1:20-1:60);
+        // the vector grows for anything bigger.
+        UINT64 guess = ReadLE32(&data[size - 4]);
+        UINT64 limit = (UINT64)size * 64;
+        out.reserve((size_t)(guess < limit ? guess : limit));
+    }
+
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    if (inflateInit2(&zs, 15 + 16) != Z_OK) {  // 15 + 16 = gzip wrapper
+        return false;
+    }
+
+    zs.next_in = (Bytef*)data;
+    zs.avail_in = size;
+
+    UINT8 buffer[0x10000];
+    int ret = Z_OK;
+    while (true) {
+        zs.next_out = buffer;
+        zs.avail_out = sizeof(buffer);
+        ret = inflate(&zs, Z_NO_FLUSH);
+        if (ret != Z_OK && ret != Z_STREAM_END) {
+            break;
+        }
+        out.insert(out.end(), buffer, buffer + (sizeof(buffer) - zs.avail_out));
+
+        if (ret == Z_STREAM_END) {
+            // Concatenated gzip members continue the same stream
+            if (zs.avail_in >= 2 && zs.next_in[0] == 0x1F && zs.next_in[1] == 0x8B) {
+                inflateReset(&zs);
+                continue;
+            }
+            break;
+        }
+        if (zs.avail_in == 0 && zs.avail_out != 0) {
+            break;  // Truncated input
+        }
+    }
+
+    inflateEnd(&zs);
+    return ret == Z_STREAM_END;
+}
+
 UINT32 VGMReader::ReadLE32(const UINT8* data) {
     return data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24);
 }
 
+std::string VGMReader::ToHex(UINT32 value) {
+    char buffer[12];
+    snprintf(buffer, sizeof(buffer), "%x", value);
+    return buffer;
+}
+
 UINT16 VGMReader::ReadLE16(const UINT8* data) {
     return data[0] | (data[1] << 8);
 }
@@ -80,10 +153,13 @@ std::vector<UINT8> VGMReader::GetGD3Data() const {
         return gd3Data;  // No GD3 tag
     }
 
+    const UINT8* data = file.Data();
+    UINT32 size = file.Size();
+
     // Calculate GD3 position
     UINT32 gd3Pos = 0x14 + header.gd3Offset;
 
-    if (gd3Pos + 12 > data.size()) {
+    if (gd3Pos + 12 > size) {
         return gd3Data;  // Invalid GD3 offset
     }
 
@@ -98,7 +174,7 @@ std::vector<UINT8> VGMReader::GetGD3Data() const {
 
     // Copy entire GD3 tag (header + data)
     UINT32 totalSize = 12 + gd3Size;
-    if (gd3Pos + totalSize > data.size()) {
+    if (gd3Pos + totalSize > size) {
         return gd3Data;  // Invalid GD3 size
     }
 
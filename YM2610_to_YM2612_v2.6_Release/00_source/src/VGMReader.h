@@ -2,8 +2,10 @@
 #define VGMREADER_H
 
 #include "../libvgm/stdtype.h"
+#include "MappedFile.h"
 #include <vector>
 #include <string>
+#include <iosfwd>
 
 #pragma pack(push, 1)
 struct VGMHeader {
@@ -56,22 +58,37 @@ public:
     ~VGMReader();
 
     bool Load(const std::string& filename);
+    // Load a VGM/VGZ image already in memory; takes over the contents of data
+    bool Load(std::vector<UINT8>& data, const std::string& name);
     bool IsValid() const { return valid; }
 
+    // Stream for the progress output (default std::cout)
+    void SetLog(std::ostream& out) { log = &out; }
+
     const VGMHeader& GetHeader() const { return header; }
-    const std::vector<UINT8>& GetData() const { return data; }
+    // Whole file, read-only (memory-mapped, not copied)
+    const UINT8* GetData() const { return file.Data(); }
+    UINT32 GetSize() const { return file.Size(); }
     UINT32 GetDataStart() const { return dataStart; }
     std::vector<UINT8> GetGD3Data() const;  // Get GD3 tag data
 
     // Helper functions
+    static bool IsGzip(const UINT8* data, UINT32 size);
+    static bool InflateGzip(const UINT8* data, UINT32 size, std::vector<UINT8>& out);
     static UINT32 ReadLE32(const UINT8* data);
     static UINT16 ReadLE16(const UINT8* data);
+    // Lowercase hex without prefix; unlike std::hex it leaves the (shared)
+    // stream flags alone, so converters on several threads can log
+    static std::string ToHex(UINT32 value);
 
 private:
     bool valid;
     VGMHeader header;
-    std::vector<UINT8> data;
+    MappedFile file;
     UINT32 dataStart;
+    std::ostream* log;
+
+    bool Parse(const std::string& name);
 };
 
 #endif // VGMREADER_H
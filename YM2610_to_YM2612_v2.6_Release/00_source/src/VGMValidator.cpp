@@ -1,10 +1,10 @@
 #include "VGMValidator.h"
 #include "VGMReader.h"
-#include <fstream>
+#include "MappedFile.h"
 #include <iostream>
 #include <iomanip>
 
-VGMValidator::VGMValidator() {
+VGMValidator::VGMValidator() : log(&std::cout) {
     result.valid = false;
     result.fileSize = 0;
     result.version = 0;
@@ -19,29 +19,37 @@ VGMValidator::~VGMValidator() {
 }
 
 bool VGMValidator::Validate(const std::string& filename) {
-    result.errors.clear();
-    result.warnings.clear();
-
-    // Load file
-    std::ifstream file(filename, std::ios::binary | std::ios::ate);
-    if (!file.is_open()) {
+    // Map file
+    MappedFile file;
+    if (!file.Open(filename)) {
+        result.errors.clear();
+        result.warnings.clear();
         result.errors.push_back("Failed to open file: " + filename);
         return false;
     }
 
-    std::streamsize size = file.tellg();
-    file.seekg(0, std::ios::beg);
-
-    std::vector<UINT8> data(size);
-    if (!file.read((char*)data.data(), size)) {
-        result.errors.push_back("Failed to read file");
-        return false;
+    if (VGMReader::IsGzip(file.Data(), file.Size())) {
+        std::vector<UINT8> inflated;
+        if (!VGMReader::InflateGzip(file.Data(), file.Size(), inflated)) {
+            result.errors.clear();
+            result.warnings.clear();
+            result.errors.push_back("Failed to decompress VGZ file: " + filename);
+            return false;
+        }
+        file.Assign(inflated);
     }
 
+    return Validate(file.Data(), file.Size());
+}
+
+bool VGMValidator::Validate(const UINT8* data, UINT32 size) {
+    result.errors.clear();
+    result.warnings.clear();
+
     result.fileSize = size;
 
     // Validate header
-    if (!ValidateHeader(data)) {
+    if (!ValidateHeader(data, size)) {
         return false;
     }
 
@@ -53,7 +61,7 @@ bool VGMValidator::Validate(const std::string& filename) {
     }
 
     // Validate commands
-    if (!ValidateCommands(data, dataStart)) {
+    if (!ValidateCommands(data, size, dataStart)) {
         return false;
     }
 
@@ -61,8 +69,8 @@ bool VGMValidator::Validate(const std::string& filename) {
     return true;
 }
 
-bool VGMValidator::ValidateHeader(const std::vector<UINT8>& data) {
-    if (data.size() < 0x40) {
+bool VGMValidator::ValidateHeader(const UINT8* data, UINT32 size) {
+    if (size < 0x40) {
         result.errors.push_back("File too small (< 64 bytes)");
         return false;
     }
@@ -83,17 +91,17 @@ bool VGMValidator::ValidateHeader(const std::vector<UINT8>& data) {
     // Read EOF offset
     UINT32 eofOffset = VGMReader::ReadLE32(&data[0x04]);
     UINT32 expectedSize = eofOffset + 0x04;
-    if (expectedSize != data.size()) {
+    if (expectedSize != size) {
         result.warnings.push_back("EOF offset mismatch: expected " +
                                   std::to_string(expectedSize) + ", got " +
-                                  std::to_string(data.size()));
+                                  std::to_string(size));
     }
 
     // Read total samples
     result.totalSamples = VGMReader::ReadLE32(&data[0x18]);
 
     // Check YM2612 clock
-    if (data.size() >= 0x30) {
+    if (size >= 0x30) {
         result.ym2612Clock = VGMReader::ReadLE32(&data[0x2C]);
         result.hasYM2612 = (result.ym2612Clock != 0);
     }
@@ -106,11 +114,11 @@ bool VGMValidator::ValidateHeader(const std::vector<UINT8>& data) {
     return true;
 }
 
-bool VGMValidator::ValidateCommands(const std::vector<UINT8>& data, UINT32 dataStart) {
+bool VGMValidator::ValidateCommands(const UINT8* data, UINT32 size, UINT32 dataStart) {
     UINT32 pos = dataStart;
     bool foundEnd = false;
 
-    while (pos < data.size()) {
+    while (pos < size) {
         UINT8 cmd = data[pos];
 
         if (cmd == 0x66) {
@@ -120,7 +128,7 @@ bool VGMValidator::ValidateCommands(const std::vector<UINT8>& data, UINT32 dataS
             break;
         }
 
-        UINT32 cmdLen = GetCommandLength(cmd, data, pos);
+        UINT32 cmdLen = GetCommandLength(cmd, data, size, pos);
         if (cmdLen == 0) {
             result.errors.push_back("Unknown command 0x" +
                                    std::to_string(cmd) + " at offset 0x" +
@@ -128,7 +136,7 @@ bool VGMValidator::ValidateCommands(const std::vector<UINT8>& data, UINT32 dataS
             return false;
         }
 
-        if (pos + cmdLen > data.size()) {
+        if (pos + cmdLen > size) {
             result.errors.push_back("Command extends beyond file at offset 0x" +
                                    std::to_string(pos));
             return false;
@@ -151,7 +159,7 @@ bool VGMValidator::ValidateCommands(const std::vector<UINT8>& data, UINT32 dataS
     return true;
 }
 
-UINT32 VGMValidator::GetCommandLength(UINT8 cmd, const std::vector<UINT8>& data, UINT32 pos) {
+UINT32 VGMValidator::GetCommandLength(UINT8 cmd, const UINT8* data, UINT32 size, UINT32 pos) {
     if (cmd >= 0x70 && cmd <= 0x7F) return 1;
     if (cmd >= 0x80 && cmd <= 0x8F) return 1;
 
@@ -171,53 +179,59 @@ UINT32 VGMValidator::GetCommandLength(UINT8 cmd, const std::vector<UINT8>& data,
         case 0x63: return 1;
         case 0x66: return 1;
         case 0x67: {
-            if (pos + 6 >= data.size()) return 0;
+            if (pos + 6 >= size) return 0;
             UINT32 blockSize = VGMReader::ReadLE32(&data[pos + 3]);
             return 7 + blockSize;
         }
+        case 0x90: return 5;
+        case 0x91: return 5;
+        case 0x92: return 6;
+        case 0x93: return 11;
+        case 0x94: return 2;
+        case 0x95: return 5;
         case 0xE0: return 5;
         default: return 0;
     }
 }
 
 void VGMValidator::PrintReport() const {
-    std::cout << std::endl;
-    std::cout << "=== VGM Validation Report ===" << std::endl;
-    std::cout << std::endl;
+    *log << std::endl;
+    *log << "=== VGM Validation Report ===" << std::endl;
+    *log << std::endl;
 
     if (result.valid) {
-        std::cout << "✓ VGM file is VALID" << std::endl;
+        *log << "✓ VGM file is VALID" << std::endl;
     } else {
-        std::cout << "✗ VGM file is INVALID" << std::endl;
+        *log << "✗ VGM file is INVALID" << std::endl;
     }
 
-    std::cout << std::endl;
-    std::cout << "File Statistics:" << std::endl;
-    std::cout << "  File size: " << result.fileSize << " bytes" << std::endl;
-    std::cout << "  Version: " << std::hex << result.version << std::dec << std::endl;
-    std::cout << "  Total samples: " << result.totalSamples << std::endl;
-    std::cout << "  Commands: " << result.commandCount << std::endl;
-    std::cout << "  Data blocks: " << result.dataBlockCount << std::endl;
+    *log << std::endl;
+    *log << "File Statistics:" << std::endl;
+    *log << "  File size: " << result.fileSize << " bytes" << std::endl;
+    *log << "  Version: " << VGMReader::ToHex(result.version) << std::endl;
+    *log << "  Total samples: " << result.totalSamples << std::endl;
+    *log << "  Commands: " << result.commandCount << std::endl;
+    *log << "  Data blocks: " << result.dataBlockCount << std::endl;
 
     if (result.hasYM2612) {
-        std::cout << "  YM2612 clock: " << result.ym2612Clock << " Hz" << std::endl;
+        *log << "  YM2612 clock: " << result.ym2612Clock << " Hz" << std::endl;
     }
 
     if (!result.errors.empty()) {
-        std::cout << std::endl;
-        std::cout << "Errors (" << result.errors.size() << "):" << std::endl;
+        *log << std::endl;
+        *log << "Errors (" << result.errors.size() << "):" << std::endl;
         for (const auto& error : result.errors) {
-            std::cout << "  ✗ " << error << std::endl;
+            *log << "  ✗ " << error << std::endl;
         }
     }
 
     if (!result.warnings.empty()) {
-        std::cout << std::endl;
-        std::cout << "Warnings (" << result.warnings.size() << "):" << std::endl;
+        *log << std::endl;
+        *log << "Warnings (" << result.warnings.size() << "):" << std::endl;
         for (const auto& warning : result.warnings) {
-            std::cout << "  ⚠ " << warning << std::endl;
+            *log << "  ⚠ " << warning << std::endl;
         }
     }
 
-    std::cout << std::endl;
+    *log << std::endl;
 }
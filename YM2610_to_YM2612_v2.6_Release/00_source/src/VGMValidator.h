@@ -4,6 +4,7 @@
 #include "../libvgm/stdtype.h"
 #include <string>
 #include <vector>
+#include <iosfwd>
 
 class VGMValidator {
 public:
@@ -11,8 +12,13 @@ public:
     ~VGMValidator();
 
     bool Validate(const std::string& filename);
+    // Validate a VGM image already in memory (e.g. a mapped file)
+    bool Validate(const UINT8* data, UINT32 size);
     void PrintReport() const;
 
+    // Stream for the report (default std::cout)
+    void SetLog(std::ostream& out) { log = &out; }
+
 private:
     struct ValidationResult {
         bool valid;
@@ -30,10 +36,11 @@ private:
     };
 
     ValidationResult result;
+    std::ostream* log;
 
-    bool ValidateHeader(const std::vector<UINT8>& data);
-    bool ValidateCommands(const std::vector<UINT8>& data, UINT32 dataStart);
-    UINT32 GetCommandLength(UINT8 cmd, const std::vector<UINT8>& data, UINT32 pos);
+    bool ValidateHeader(const UINT8* data, UINT32 size);
+    bool ValidateCommands(const UINT8* data, UINT32 size, UINT32 dataStart);
+    UINT32 GetCommandLength(UINT8 cmd, const UINT8* data, UINT32 size, UINT32 pos);
 };
 
 #endif // VGMVALIDATOR_H
@@ -3,13 +3,42 @@
 #include <cstring>
 #include <iostream>
 
+#define VGM_DATA_START     0x100
+#define STREAM_FLUSH_SIZE  0x10000  // Flush command buffer to file every 64 KB
+
+// A .vgz is written as two gzip members: the 0x100-byte header stored
+// uncompressed (fixed size, so it can be patched in place like a .vgm),
+// followed by the deflated rest of the file
+#define GZIP_HEADER_MEMBER_SIZE  (10 + 5 + VGM_DATA_START + 8)
+
 VGMWriter::VGMWriter() {
     memset(&header, 0, sizeof(header));
     loopCommandOffset = 0;
     hasLoopPoint = false;
+    dataBlockBytes = 0;
+    streamedBytes = 0;
+    loopFileOffset = 0;
+    log = &std::cout;
+    compressionLevel = 0;
+    memset(&zstream, 0, sizeof(zstream));
+    deflating = false;
+    optimize = false;
+    pendingWait = 0;
+    droppedWrites = 0;
+    mergedWaits = 0;
+    InvalidateShadow();
 }
 
 VGMWriter::~VGMWriter() {
+    if (deflating) {
+        deflateEnd(&zstream);
+    }
+}
+
+void VGMWriter::SetCompression(int level) {
+    if (level < 0) level = 0;
+    if (level > 9) level = 9;
+    compressionLevel = level;
 }
 
 void VGMWriter::Initialize(const VGMHeader& sourceHeader, UINT32 ym2612Clock) {
@@ -31,33 +60,327 @@ void VGMWriter::Initialize(const VGMHeader& sourceHeader, UINT32 ym2612Clock) {
     header.loopOffset = 0;
     header.dataOffset = 0x0C; // Standard offset for v1.50+
 
-    std::cout << "VGMWriter initialized:" << std::endl;
-    std::cout << "  YM2612 clock: " << ym2612Clock << " Hz" << std::endl;
+    *log << "VGMWriter initialized:" << std::endl;
+    *log << "  YM2612 clock: " << ym2612Clock << " Hz" << std::endl;
 }
 
 void VGMWriter::WriteCommand(UINT8 cmd) {
+    if (optimize || scheduler.IsEnabled()) {
+        // Short waits join the pending wait
+        UINT32 wait = 0;
+        if (cmd >= 0x70 && cmd <= 0x7F) {
+            wait = (cmd & 0x0F) + 1;
+        } else if (cmd == 0x62) {
+            wait = 735;
+        } else if (cmd == 0x63) {
+            wait = 882;
+        }
+        if (wait > 0) {
+            if (scheduler.IsEnabled()) {
+                ScheduleWait(wait);
+            } else {
+                AddWait(wait);
+            }
+            return;
+        }
+        if (scheduler.IsEnabled() && (cmd & 0xF0) == 0x80) {
+            // PCM bank DAC write, then its wait
+            WriteScheduler::Write w = { 0x80, 0x00, 0x00 };
+            scheduler.AddFixed(w);
+            ScheduleWait(cmd & 0x0F);
+            return;
+        }
+        FlushSchedule();
+        FlushPendingWait();
+    }
     commandData.push_back(cmd);
+    FlushIfFull();
 }
 
 void VGMWriter::WriteCommand(UINT8 cmd, UINT8 data1) {
+    FlushSchedule();
+    FlushPendingWait();
     commandData.push_back(cmd);
     commandData.push_back(data1);
+    FlushIfFull();
 }
 
 void VGMWriter::WriteCommand(UINT8 cmd, UINT8 data1, UINT8 data2) {
+    if (optimize) {
+        if ((cmd == 0x52 || cmd == 0x53) && IsRedundantWrite(cmd - 0x52, data1, data2)) {
+            droppedWrites++;
+            return;
+        }
+    }
+    if (scheduler.IsEnabled()) {
+        if (cmd == 0x52 || cmd == 0x53) {
+            WriteScheduler::Write w = { cmd, data1, data2 };
+            if (cmd == 0x52 && (data1 == 0x2A || data1 == 0x2B)) {
+                scheduler.AddFixed(w);
+            } else {
+                scheduler.AddFlexible(w);
+            }
+            return;
+        }
+        FlushSchedule();
+    }
+    if (optimize) {
+        FlushPendingWait();
+    }
     commandData.push_back(cmd);
     commandData.push_back(data1);
     commandData.push_back(data2);
+    FlushIfFull();
 }
 
 void VGMWriter::WriteCommand(UINT8 cmd, UINT16 data) {
+    if (cmd == 0x61 && scheduler.IsEnabled()) {
+        ScheduleWait(data);
+        return;
+    }
+    if (optimize && cmd == 0x61) {
+        AddWait(data);
+        return;
+    }
+    FlushSchedule();
+    FlushPendingWait();
     commandData.push_back(cmd);
     commandData.push_back(data & 0xFF);
     commandData.push_back((data >> 8) & 0xFF);
+    FlushIfFull();
+}
+
+void VGMWriter::WriteWait(UINT32 samples) {
+    if (scheduler.IsEnabled()) {
+        ScheduleWait(samples);
+        return;
+    }
+    if (optimize) {
+        AddWait(samples);
+        return;
+    }
+    EmitWait(samples);
+    FlushIfFull();
+}
+
+void VGMWriter::EmitWait(UINT32 samples) {
+    // The combined forms (two 0x7n, 0x62/0x63 plus a rest) belong to the
+    // optimization pass; without it waits are encoded as they always were
+    while (samples > 0) {
+        if (samples <= 16) {
+            commandData.push_back(0x70 | (samples - 1));  // 0x7n = wait n+1 samples
+            samples = 0;
+        } else if (optimize && samples <= 32) {
+            commandData.push_back(0x7F);  // Two 0x7n beat one 0x61
+            samples -= 16;
+        } else if (samples == 735 || (optimize && samples >= 735 && samples <= 735 + 16)) {
+            commandData.push_back(0x62);  // Wait 1/60 sec
+            samples -= 735;
+        } else if (samples == 882 || (optimize && samples >= 882 && samples <= 882 + 16)) {
+            commandData.push_back(0x63);  // Wait 1/50 sec
+            samples -= 882;
+        } else if (optimize && (samples == 735 * 2 || samples == 735 + 882 || samples == 882 * 2)) {
+            commandData.push_back((samples == 882 * 2) ? 0x63 : 0x62);
+            samples -= (samples == 882 * 2) ? 882 : 735;
+        } else {
+            UINT16 chunk = (samples > 0xFFFF) ? 0xFFFF : (UINT16)samples;
+            commandData.push_back(0x61);
+            commandData.push_back(chunk & 0xFF);
+            commandData.push_back((chunk >> 8) & 0xFF);
+            samples -= chunk;
+        }
+    }
+}
+
+void VGMWriter::AddWait(UINT32 samples) {
+    if (pendingWait > 0 && samples > 0) {
+        mergedWaits++;
+    }
+    pendingWait += samples;
+}
+
+void VGMWriter::FlushPendingWait() {
+    if (pendingWait > 0) {
+        EmitWait(pendingWait);
+        pendingWait = 0;
+        FlushIfFull();
+    }
+}
+
+void VGMWriter::ScheduleWait(UINT32 samples) {
+    // Tick by tick while FM writes are carried over, then the rest in one go
+    while (samples > 0) {
+        scheduled.clear();
+        UINT32 ticks = scheduler.EndTick(scheduled, samples);
+        EmitScheduled(ticks);
+        samples -= ticks;
+    }
+}
+
+void VGMWriter::FlushSchedule() {
+    if (!scheduler.IsEnabled()) {
+        return;
+    }
+    scheduled.clear();
+    scheduler.Drain(scheduled);
+    EmitScheduled(0);
+}
+
+void VGMWriter::EmitScheduled(UINT32 waitSamples) {
+    // A PCM bank write that ends the tick carries the wait itself (0x8n)
+    size_t count = scheduled.size();
+    UINT32 fused = 0;
+    if (count > 0 && scheduled[count - 1].cmd == 0x80) {
+        fused = (waitSamples > 15) ? 15 : waitSamples;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const WriteScheduler::Write& w = scheduled[i];
+        FlushPendingWait();
+        if (w.cmd == 0x80) {
+            commandData.push_back(0x80 | ((i == count - 1) ? fused : 0));
+        } else {
+            commandData.push_back(w.cmd);
+            commandData.push_back(w.reg);
+            commandData.push_back(w.data);
+        }
+    }
+
+    if (waitSamples > fused) {
+        if (optimize) {
+            AddWait(waitSamples - fused);
+        } else {
+            EmitWait(waitSamples - fused);
+        }
+    }
+    FlushIfFull();
+}
+
+void VGMWriter::InvalidateShadow() {
+    for (int port = 0; port < 2; port++) {
+        for (int reg = 0; reg < 0x100; reg++) {
+            shadow[port][reg] = 0xFFFF;
+        }
+        for (int i = 0; i < 0x10; i++) {
+            freqCommitted[port][i] = 0xFFFF;
+        }
+        freqLatch[port] = 0xFFFF;
+    }
+}
+
+bool VGMWriter::IsRedundantWrite(UINT8 port, UINT8 reg, UINT8 data) {
+    // Strobes and the DAC: writing the same value again still does something
+    // (and 0x2A is also written by 0x8n and DAC streams behind our back)
+    if (port == 0 && (reg == 0x27 || reg == 0x28 || reg == 0x2A)) {
+        return false;
+    }
+
+    if (reg >= 0xA0 && reg <= 0xAF) {
+        // Frequency: one high byte latch for all channels of both ports
+        // (and one for the channel 3 special mode registers)
+        int latch = (reg >= 0xA8) ? 1 : 0;
+        if ((reg & 0x07) >= 4) {
+            bool redundant = (freqLatch[latch] == data);
+            freqLatch[latch] = data;
+            return redundant;
+        }
+
+        // Low byte: commits the latch together with it
+        bool redundant = (shadow[port][reg] == data) && freqLatch[latch] != 0xFFFF &&
+                         freqCommitted[port][reg & 0x0F] == freqLatch[latch];
+        shadow[port][reg] = data;
+        freqCommitted[port][reg & 0x0F] = freqLatch[latch];
+        return redundant;
+    }
+
+    bool redundant = (shadow[port][reg] == data);
+    shadow[port][reg] = data;
+    return redundant;
+}
+
+void VGMWriter::WritePCMSeek(UINT32 offset) {
+    FlushSchedule();
+    FlushPendingWait();
+    commandData.push_back(0xE0);
+    commandData.push_back(offset & 0xFF);
+    commandData.push_back((offset >> 8) & 0xFF);
+    commandData.push_back((offset >> 16) & 0xFF);
+    commandData.push_back((offset >> 24) & 0xFF);
+    FlushIfFull();
+}
+
+void VGMWriter::WriteStreamSetup(UINT8 streamId, UINT8 chipType, UINT8 port, UINT8 reg) {
+    FlushSchedule();
+    FlushPendingWait();
+    commandData.push_back(0x90);
+    commandData.push_back(streamId);
+    commandData.push_back(chipType);
+    commandData.push_back(port);
+    commandData.push_back(reg);
+    FlushIfFull();
+}
+
+void VGMWriter::WriteStreamData(UINT8 streamId, UINT8 bankType, UINT8 stepSize, UINT8 stepBase) {
+    FlushSchedule();
+    FlushPendingWait();
+    commandData.push_back(0x91);
+    commandData.push_back(streamId);
+    commandData.push_back(bankType);
+    commandData.push_back(stepSize);
+    commandData.push_back(stepBase);
+    FlushIfFull();
+}
+
+void VGMWriter::WriteStreamFrequency(UINT8 streamId, UINT32 frequency) {
+    FlushSchedule();
+    FlushPendingWait();
+    commandData.push_back(0x92);
+    commandData.push_back(streamId);
+    commandData.push_back(frequency & 0xFF);
+    commandData.push_back((frequency >> 8) & 0xFF);
+    commandData.push_back((frequency >> 16) & 0xFF);
+    commandData.push_back((frequency >> 24) & 0xFF);
+    FlushIfFull();
+}
+
+void VGMWriter::WriteStreamStop(UINT8 streamId) {
+    FlushSchedule();
+    FlushPendingWait();
+    commandData.push_back(0x94);
+    commandData.push_back(streamId);
+    FlushIfFull();
+}
+
+void VGMWriter::WriteStreamStartBlock(UINT8 streamId, UINT16 blockId, UINT8 flags) {
+    FlushSchedule();
+    FlushPendingWait();
+    commandData.push_back(0x95);
+    commandData.push_back(streamId);
+    commandData.push_back(blockId & 0xFF);
+    commandData.push_back((blockId >> 8) & 0xFF);
+    commandData.push_back(flags);
+    FlushIfFull();
+}
+
+void VGMWriter::RequireVersion(UINT32 version) {
+    if (header.version < version) {
+        header.version = version;
+    }
 }
 
 void VGMWriter::MarkLoopPoint() {
-    loopCommandOffset = commandData.size() + dataBlocks.size();
+    // Writes and waits before the loop point stay before it
+    FlushSchedule();
+    FlushPendingWait();
+
+    // The second pass starts with whatever state the end of the song left,
+    // so nothing after this point can rely on earlier writes
+    InvalidateShadow();
+
+    // Data blocks may still be added after this point; they are all written
+    // before the commands, so their size is added in Save()
+    loopCommandOffset = commandData.size();
+    loopFileOffset = VGM_DATA_START + streamedBytes + commandData.size();
     hasLoopPoint = true;
 }
 
@@ -66,30 +389,141 @@ void VGMWriter::SetGD3Data(const std::vector<UINT8>& data) {
 }
 
 void VGMWriter::WriteDataBlock(UINT8 type, const std::vector<UINT8>& blockData) {
-    dataBlocks.push_back(0x67);  // Data block command
-    dataBlocks.push_back(0x66);  // Compatibility command
-    dataBlocks.push_back(type);  // Block type
+    // When streaming, blocks go inline at the current position (commands
+    // already on disk cannot be moved); otherwise they all precede the commands
+    std::vector<UINT8>& out = IsStreaming() ? commandData : dataBlocks;
+    if (IsStreaming()) {
+        FlushSchedule();
+        FlushPendingWait();
+    }
+
+    out.push_back(0x67);  // Data block command
+    out.push_back(0x66);  // Compatibility command
+    out.push_back(type);  // Block type
 
     // Block size (4 bytes, little-endian)
     UINT32 size = blockData.size();
-    dataBlocks.push_back(size & 0xFF);
-    dataBlocks.push_back((size >> 8) & 0xFF);
-    dataBlocks.push_back((size >> 16) & 0xFF);
-    dataBlocks.push_back((size >> 24) & 0xFF);
+    out.push_back(size & 0xFF);
+    out.push_back((size >> 8) & 0xFF);
+    out.push_back((size >> 16) & 0xFF);
+    out.push_back((size >> 24) & 0xFF);
 
     // Block data
-    dataBlocks.insert(dataBlocks.end(), blockData.begin(), blockData.end());
+    out.insert(out.end(), blockData.begin(), blockData.end());
+    dataBlockBytes += 7 + size;
+    FlushIfFull();
 }
 
-bool VGMWriter::Save(const std::string& filename) {
-    std::vector<UINT8> output;
+bool VGMWriter::OpenStream(const std::string& filename) {
+    stream.open(filename.c_str(), std::ios::binary | std::ios::trunc);
+    if (!stream.is_open()) {
+        std::cerr << "Failed to create output file: " << filename << std::endl;
+        return false;
+    }
+    streamFilename = filename;
+    streamedBytes = 0;
+
+    // Placeholder header, patched in Save()
+    std::vector<UINT8> placeholder(IsCompressed() ? GZIP_HEADER_MEMBER_SIZE : VGM_DATA_START, 0);
+    stream.write((char*)placeholder.data(), placeholder.size());
+    if (IsCompressed() && !BeginDeflate()) {
+        stream.close();
+        return false;
+    }
+
+    // Anything buffered so far belongs in front of the streamed commands
+    commandData.insert(commandData.begin(), dataBlocks.begin(), dataBlocks.end());
+    if (hasLoopPoint) {
+        loopFileOffset += dataBlocks.size();
+    }
+    dataBlocks.clear();
+
+    return FlushStream();
+}
+
+void VGMWriter::FlushIfFull() {
+    if (commandData.size() >= STREAM_FLUSH_SIZE && IsStreaming()) {
+        FlushStream();
+    }
+}
+
+bool VGMWriter::FlushStream() {
+    if (!commandData.empty()) {
+        if (deflating) {
+            DeflateWrite(stream, commandData.data(), commandData.size(), false);
+        } else {
+            stream.write((char*)commandData.data(), commandData.size());
+        }
+        streamedBytes += commandData.size();
+        commandData.clear();
+    }
+    return stream.good();
+}
+
+bool VGMWriter::BeginDeflate() {
+    memset(&zstream, 0, sizeof(zstream));
+    // windowBits 15 + 16: write a gzip wrapper instead of zlib
+    if (deflateInit2(&zstream, compressionLevel, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        std::cerr << "Failed to initialize gzip compression" << std::endl;
+        return false;
+    }
+    deflating = true;
+    return true;
+}
 
-    // Reserve space for header (256 bytes to be safe)
-    output.resize(256, 0);
+bool VGMWriter::DeflateWrite(std::ofstream& out, const UINT8* data, UINT32 size, bool finish) {
+    UINT8 buffer[0x10000];
+    zstream.next_in = (Bytef*)data;
+    zstream.avail_in = size;
+
+    int ret;
+    do {
+        zstream.next_out = buffer;
+        zstream.avail_out = sizeof(buffer);
+        ret = deflate(&zstream, finish ? Z_FINISH : Z_NO_FLUSH);
+        if (ret == Z_STREAM_ERROR) {
+            return false;
+        }
+        out.write((char*)buffer, sizeof(buffer) - zstream.avail_out);
+    } while (zstream.avail_out == 0 || (finish && ret != Z_STREAM_END));
+
+    if (finish) {
+        deflateEnd(&zstream);
+        deflating = false;
+    }
+    return out.good();
+}
+
+void VGMWriter::BuildHeaderMember(std::vector<UINT8>& output, const std::vector<UINT8>& headerData) {
+    static const UINT8 gzipHeader[10] = { 0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF };
+    UINT16 len = headerData.size();
+
+    output.assign(gzipHeader, gzipHeader + sizeof(gzipHeader));
+
+    // One final stored deflate block: BFINAL=1 BTYPE=00, LEN, NLEN
+    output.push_back(0x01);
+    output.push_back(len & 0xFF);
+    output.push_back((len >> 8) & 0xFF);
+    output.push_back(~len & 0xFF);
+    output.push_back((~len >> 8) & 0xFF);
+    output.insert(output.end(), headerData.begin(), headerData.end());
+
+    // Trailer: CRC-32 and uncompressed size
+    UINT32 crc = crc32(0L, headerData.data(), headerData.size());
+    UINT32 pos = output.size();
+    WriteLE32(output, pos, crc);
+    WriteLE32(output, pos + 4, headerData.size());
+}
+
+void VGMWriter::BuildHeader(std::vector<UINT8>& output, UINT32 fileSize, UINT32 loopOffset, UINT32 gd3Start) {
+    output.assign(VGM_DATA_START, 0);
 
     // Write VGM signature
     WriteLE32(output, 0x00, 0x206D6756); // "Vgm "
 
+    // EOF offset (relative to 0x04)
+    WriteLE32(output, 0x04, fileSize - 0x04);
+
     // Write version
     WriteLE32(output, 0x08, header.version);
 
@@ -104,9 +538,19 @@ bool VGMWriter::Save(const std::string& filename) {
     WriteLE32(output, 0x48, header.ym2608Clock);
     WriteLE32(output, 0x4C, 0); // YM2610 clock = 0
 
+    // GD3 offset (relative to 0x14)
+    WriteLE32(output, 0x14, gd3Start ? gd3Start - 0x14 : 0);
+
     // Write total samples
     WriteLE32(output, 0x18, header.totalSamples);
 
+    // Loop offset (relative to 0x1C)
+    if (hasLoopPoint && header.loopSamples > 0) {
+        WriteLE32(output, 0x1C, loopOffset - 0x1C);
+    } else {
+        WriteLE32(output, 0x1C, 0);
+    }
+
     // Write loop samples
     WriteLE32(output, 0x20, header.loopSamples);
 
@@ -128,56 +572,117 @@ bool VGMWriter::Save(const std::string& filename) {
     output[0x7F] = header.loopModifier;
 
     // Data offset (relative to 0x34)
-    UINT32 dataStart = 0x100; // Start data at offset 0x100
-    WriteLE32(output, 0x34, dataStart - 0x34);
-
-    // Resize to data start
-    output.resize(dataStart);
-
-    // Append data blocks
-    UINT32 dataBlocksStart = output.size();
-    output.insert(output.end(), dataBlocks.begin(), dataBlocks.end());
-
-    // Append command data
-    output.insert(output.end(), commandData.begin(), commandData.end());
-
-    // Calculate and write EOF offset (relative to 0x04)
-    UINT32 eofOffset = output.size() - 0x04;
-    WriteLE32(output, 0x04, eofOffset);
+    WriteLE32(output, 0x34, VGM_DATA_START - 0x34);
+}
 
-    // Write loop offset if present
-    if (hasLoopPoint && header.loopSamples > 0) {
-        // Loop offset is relative to 0x1C
-        UINT32 loopOffset = dataStart + loopCommandOffset - 0x1C;
-        WriteLE32(output, 0x1C, loopOffset);
-    } else {
-        WriteLE32(output, 0x1C, 0);
+bool VGMWriter::Save(const std::string& filename) {
+    std::vector<UINT8> headerData;
+    UINT32 commandSize;
+    UINT32 fileSize;
+    UINT32 compressedSize = 0;
+    UINT32 inlineBlockBytes = 0;   // Data blocks streamed between the commands
+
+    if (scheduler.IsEnabled()) {
+        // Last writes, then close the tick for the statistics
+        FlushSchedule();
+        scheduled.clear();
+        scheduler.EndTick(scheduled, 1);
     }
-
-    // Append GD3 tag if present
-    if (!gd3Data.empty()) {
-        // GD3 offset is relative to 0x14
-        UINT32 gd3Offset = output.size() - 0x14;
-        WriteLE32(output, 0x14, gd3Offset);
-        output.insert(output.end(), gd3Data.begin(), gd3Data.end());
+    FlushPendingWait();
+
+    if (IsStreaming()) {
+        if (filename != streamFilename) {
+            std::cerr << "Warning: output is streamed to " << streamFilename
+                      << ", not " << filename << std::endl;
+        }
+
+        // Flush remaining commands, append GD3, then patch the header
+        FlushStream();
+        commandSize = streamedBytes;
+        inlineBlockBytes = dataBlockBytes;
+        UINT32 gd3Start = gd3Data.empty() ? 0 : VGM_DATA_START + commandSize;
+        if (deflating) {
+            DeflateWrite(stream, gd3Data.data(), gd3Data.size(), true);
+        } else if (!gd3Data.empty()) {
+            stream.write((char*)gd3Data.data(), gd3Data.size());
+        }
+        fileSize = VGM_DATA_START + commandSize + gd3Data.size();
+
+        BuildHeader(headerData, fileSize, loopFileOffset, gd3Start);
+        if (IsCompressed()) {
+            std::vector<UINT8> member;
+            BuildHeaderMember(member, headerData);
+            headerData.swap(member);
+        }
+        compressedSize = stream.tellp();
+        stream.seekp(0);
+        stream.write((char*)headerData.data(), headerData.size());
+        bool ok = stream.good();
+        stream.close();
+        if (!ok) {
+            std::cerr << "Failed to write output file: " << streamFilename << std::endl;
+            return false;
+        }
     } else {
-        WriteLE32(output, 0x14, 0);
+        commandSize = commandData.size();
+        UINT32 commandStart = VGM_DATA_START + dataBlocks.size();
+        UINT32 gd3Start = gd3Data.empty() ? 0 : commandStart + commandSize;
+        fileSize = commandStart + commandSize + gd3Data.size();
+        BuildHeader(headerData, fileSize, commandStart + loopCommandOffset, gd3Start);
+
+        // Write the parts directly, without assembling a second copy in memory
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Failed to create output file: " << filename << std::endl;
+            return false;
+        }
+
+        if (IsCompressed()) {
+            // Everything is known here: a single gzip member
+            if (!BeginDeflate()) {
+                return false;
+            }
+            DeflateWrite(file, headerData.data(), headerData.size(), false);
+            DeflateWrite(file, dataBlocks.data(), dataBlocks.size(), false);
+            DeflateWrite(file, commandData.data(), commandData.size(), false);
+            DeflateWrite(file, gd3Data.data(), gd3Data.size(), true);
+        } else {
+            file.write((char*)headerData.data(), headerData.size());
+            file.write((char*)dataBlocks.data(), dataBlocks.size());
+            file.write((char*)commandData.data(), commandData.size());
+            file.write((char*)gd3Data.data(), gd3Data.size());
+        }
+        if (!file.good()) {
+            std::cerr << "Failed to write output file: " << filename << std::endl;
+            return false;
+        }
+        compressedSize = file.tellp();
+        file.close();
     }
 
-    // Write to file
-    std::ofstream file(filename, std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "Failed to create output file: " << filename << std::endl;
-        return false;
+    *log << "VGM saved successfully: " << filename << std::endl;
+    *log << "  Output size: " << fileSize << " bytes" << std::endl;
+    if (IsCompressed()) {
+        *log << "  Compressed size: " << compressedSize << " bytes (level "
+                  << compressionLevel << ")" << std::endl;
+    }
+    *log << "  Command data: " << (commandSize - inlineBlockBytes) << " bytes" << std::endl;
+    *log << "  Data blocks: " << dataBlockBytes << " bytes" << std::endl;
+    if (optimize) {
+        *log << "  Optimizer: " << droppedWrites << " redundant register writes dropped, "
+                  << mergedWaits << " waits merged" << std::endl;
+    }
+    if (scheduler.IsEnabled()) {
+        *log << "  Write scheduler: " << scheduler.GetDeferredWriteCount() << " FM writes moved (max "
+                  << scheduler.GetMaxDelay() << " samples later), peak " << scheduler.GetPeakTickWrites()
+                  << " writes in one sample" << std::endl;
+        if (scheduler.GetOverflowTickCount() > 0) {
+            std::cerr << "Warning: " << filename << ": write budget exceeded on "
+                      << scheduler.GetOverflowTickCount() << " samples (first at sample "
+                      << scheduler.GetFirstOverflowTick() << ", " << scheduler.GetOverflowWriteCount()
+                      << " writes too many)" << std::endl;
+        }
     }
-
-    file.write((char*)output.data(), output.size());
-    file.close();
-
-    std::cout << "VGM saved successfully: " << filename << std::endl;
-    std::cout << "  Output size: " << output.size() << " bytes" << std::endl;
-    std::cout << "  Command data: " << commandData.size() << " bytes" << std::endl;
-    std::cout << "  Data blocks: " << dataBlocks.size() << " bytes" << std::endl;
 
     return true;
 }
@@ -3,8 +3,11 @@
 
 #include "../libvgm/stdtype.h"
 #include "VGMReader.h"
+#include "WriteScheduler.h"
 #include <vector>
 #include <string>
+#include <fstream>
+#include <zlib.h>
 
 class VGMWriter {
 public:
@@ -17,12 +20,55 @@ public:
     void WriteCommand(UINT8 cmd, UINT8 data1, UINT8 data2);
     void WriteCommand(UINT8 cmd, UINT16 data);
     void WriteDataBlock(UINT8 type, const std::vector<UINT8>& blockData);
+    void WriteWait(UINT32 samples);        // 0x61/0x62/0x63/0x7n (combined forms with SetOptimize)
+    void WritePCMSeek(UINT32 offset);      // 0xE0: seek in YM2612 PCM data bank
+
+    // DAC Stream Control (VGM 1.60+)
+    void WriteStreamSetup(UINT8 streamId, UINT8 chipType, UINT8 port, UINT8 reg);       // 0x90
+    void WriteStreamData(UINT8 streamId, UINT8 bankType, UINT8 stepSize, UINT8 stepBase); // 0x91
+    void WriteStreamFrequency(UINT8 streamId, UINT32 frequency);                       // 0x92
+    void WriteStreamStop(UINT8 streamId);                                              // 0x94
+    void WriteStreamStartBlock(UINT8 streamId, UINT16 blockId, UINT8 flags);           // 0x95
+
+    void RequireVersion(UINT32 version);  // Raise header version if lower
 
     void MarkLoopPoint();  // Mark current position as loop point
     void SetGD3Data(const std::vector<UINT8>& gd3Data);  // Set GD3 tag data
 
+    // Streaming mode: reserve the header in the file now and append commands
+    // (and data blocks, in order) as they are generated; Save() then patches
+    // the header offsets. Without it everything is buffered until Save().
+    bool OpenStream(const std::string& filename);
+    bool IsStreaming() const { return stream.is_open(); }
+
+    // Write gzip-compressed output (.vgz) with the given zlib level (1-9);
+    // 0 writes a plain .vgm. Must be set before OpenStream().
+    void SetCompression(int level);
+    bool IsCompressed() const { return compressionLevel > 0; }
+
+    // Optimization pass: keep a shadow of all YM2612 registers (both ports)
+    // and drop 0x52/0x53 writes that do not change anything, and merge
+    // consecutive waits into the shortest encoding. Key on/off (0x28), the
+    // timer control (0x27) and the DAC (0x2A) are always written. A4-A6 /
+    // AC-AE only set a latch shared by all channels, which the next A0-A2 /
+    // A8-AA write commits, so those are compared against the latch.
+    void SetOptimize(bool enable) { optimize = enable; }
+    UINT32 GetDroppedWriteCount() const { return droppedWrites; }
+    UINT32 GetMergedWaitCount() const { return mergedWaits; }
+
+    // Write scheduling for hardware players (WriteScheduler): at most
+    // writesPerTick register writes per sample; FM writes over the budget
+    // move up to toleranceTicks later, DAC writes (0x2A, 0x2B, 0x8n) keep
+    // their tick. Any other command first flushes the queued writes.
+    // 0 writes per tick = off.
+    void SetWriteBudget(UINT32 writesPerTick, UINT32 toleranceTicks) { scheduler.Configure(writesPerTick, toleranceTicks); }
+    const WriteScheduler& GetScheduler() const { return scheduler; }
+
     bool Save(const std::string& filename);
 
+    // Stream for the progress output (default std::cout)
+    void SetLog(std::ostream& out) { log = &out; }
+
     // Helper functions
     static void WriteLE32(std::vector<UINT8>& data, UINT32 offset, UINT32 value);
     static void WriteLE16(std::vector<UINT8>& data, UINT32 offset, UINT16 value);
@@ -31,9 +77,52 @@ private:
     VGMHeader header;
     std::vector<UINT8> commandData;
     std::vector<UINT8> dataBlocks;
+    UINT32 dataBlockBytes;     // Data blocks written so far, buffered or inline in the stream
     std::vector<UINT8> gd3Data;
-    UINT32 loopCommandOffset;  // Offset in commandData where loop starts
+    UINT32 loopCommandOffset;  // Offset in commandData where loop starts (data blocks precede it)
     bool hasLoopPoint;
+
+    // Streaming mode
+    std::ofstream stream;
+    std::string streamFilename;
+    UINT32 streamedBytes;      // Command bytes already flushed to the file
+    UINT32 loopFileOffset;     // Absolute file offset of the loop point
+    std::ostream* log;
+
+    // Compressed output
+    int compressionLevel;
+    z_stream zstream;
+    bool deflating;
+
+    // Optimization pass
+    bool optimize;
+    UINT16 shadow[2][0x100];       // Last value written per port/register (0xFFFF = unknown)
+    UINT16 freqLatch[2];           // Shared frequency high byte latch: A4-A6, AC-AE
+    UINT16 freqCommitted[2][0x10]; // Latch value each A0-A2 / A8-AA write committed
+    UINT32 pendingWait;            // Wait not written yet, merged with following waits
+    UINT32 droppedWrites;
+    UINT32 mergedWaits;
+
+    bool IsRedundantWrite(UINT8 port, UINT8 reg, UINT8 data);
+    void InvalidateShadow();
+    void AddWait(UINT32 samples);
+    void FlushPendingWait();
+    void EmitWait(UINT32 samples);
+
+    // Write scheduling
+    WriteScheduler scheduler;
+    std::vector<WriteScheduler::Write> scheduled;  // Writes of the tick being emitted
+
+    void ScheduleWait(UINT32 samples);
+    void FlushSchedule();
+    void EmitScheduled(UINT32 waitSamples);
+
+    void FlushIfFull();
+    bool FlushStream();
+    bool BeginDeflate();
+    bool DeflateWrite(std::ofstream& out, const UINT8* data, UINT32 size, bool finish);
+    static void BuildHeaderMember(std::vector<UINT8>& output, const std::vector<UINT8>& headerData);
+    void BuildHeader(std::vector<UINT8>& output, UINT32 fileSize, UINT32 loopOffset, UINT32 gd3Start);
 };
 
 #endif // VGMWRITER_H
@@ -0,0 +1,80 @@
+#include "WriteScheduler.h"
+
+WriteScheduler::WriteScheduler()
+    : budget(0), tolerance(0), currentTick(0), tickWrites(0),
+      deferredWrites(0), maxDelay(0), overflowTicks(0), overflowWrites(0),
+      firstOverflowTick(0), peakTickWrites(0) {
+}
+
+void WriteScheduler::Configure(UINT32 b, UINT32 t) {
+    budget = b;
+    tolerance = t;
+}
+
+void WriteScheduler::AddFixed(const Write& w) {
+    fixed.push_back(w);
+}
+
+void WriteScheduler::AddFlexible(const Write& w) {
+    Pending p;
+    p.write = w;
+    p.tick = currentTick;
+    flexible.push_back(p);
+}
+
+void WriteScheduler::Place(const Pending& p, std::vector<Write>& out) {
+    UINT32 delay = currentTick - p.tick;
+    if (delay > 0) {
+        deferredWrites++;
+        if (delay > maxDelay) maxDelay = delay;
+    }
+    out.push_back(p.write);
+    tickWrites++;
+}
+
+UINT32 WriteScheduler::EndTick(std::vector<Write>& out, UINT32 samples) {
+    // DAC writes first, so they start the tick on time
+    out.insert(out.end(), fixed.begin(), fixed.end());
+    tickWrites += fixed.size();
+    fixed.clear();
+
+    // Then FM writes in request order while the budget lasts; writes that
+    // have waited `tolerance` ticks go out anyway
+    while (!flexible.empty()) {
+        const Pending& p = flexible.front();
+        if (tickWrites >= budget && currentTick - p.tick < tolerance) {
+            break;
+        }
+        Place(p, out);
+        flexible.pop_front();
+    }
+
+    if (tickWrites > budget) {
+        if (overflowTicks == 0) {
+            firstOverflowTick = currentTick;
+        }
+        overflowTicks++;
+        overflowWrites += tickWrites - budget;
+    }
+    if (tickWrites > peakTickWrites) {
+        peakTickWrites = tickWrites;
+    }
+
+    // Writes carried over need the next sample; otherwise the tick runs
+    // through the whole wait
+    UINT32 covered = (flexible.empty() && samples > 0) ? samples : 1;
+    currentTick += covered;
+    tickWrites = 0;
+    return covered;
+}
+
+void WriteScheduler::Drain(std::vector<Write>& out) {
+    out.insert(out.end(), fixed.begin(), fixed.end());
+    tickWrites += fixed.size();
+    fixed.clear();
+
+    while (!flexible.empty()) {
+        Place(flexible.front(), out);
+        flexible.pop_front();
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef WRITESCHEDULER_H
+#define WRITESCHEDULER_H
+
+#include "../libvgm/stdtype.h"
+#include <vector>
+#include <deque>
+
+// Models the chip bus for hardware players: at most `budget` register
+// writes per sample tick. DAC writes are fixed to the tick they were
+// requested on; FM writes that do not fit are carried over to the
+// following ticks (in order) for up to `tolerance` ticks, after which they
+// are written regardless and the tick counts as overflowed.
+// The scheduler only decides what goes on which tick; VGMWriter feeds it
+// and emits what it returns.
+class WriteScheduler {
+public:
+    struct Write {
+        UINT8 cmd;      // 0x52/0x53, or 0x80 (PCM bank DAC write)
+        UINT8 reg;
+        UINT8 data;
+    };
+
+    WriteScheduler();
+
+    // budget 0 disables scheduling
+    void Configure(UINT32 budget, UINT32 tolerance);
+    bool IsEnabled() const { return budget > 0; }
+
+    void AddFixed(const Write& w);      // Stays on the current tick
+    void AddFlexible(const Write& w);   // May move to a later tick
+    bool HasDeferred() const { return !flexible.empty(); }
+
+    // Close the current tick, which may last up to `samples` samples: the
+    // writes that go on it, in emit order. Returns the samples it covers,
+    // 1 while FM writes are still carried over, else all of them.
+    UINT32 EndTick(std::vector<Write>& out, UINT32 samples);
+    // Everything queued, on the current tick (before a command that must
+    // not overtake earlier writes); the tick stays open
+    void Drain(std::vector<Write>& out);
+
+    UINT32 GetDeferredWriteCount() const { return deferredWrites; }
+    UINT32 GetMaxDelay() const { return maxDelay; }
+    UINT32 GetOverflowTickCount() const { return overflowTicks; }
+    UINT32 GetOverflowWriteCount() const { return overflowWrites; }
+    UINT32 GetFirstOverflowTick() const { return firstOverflowTick; }
+    UINT32 GetPeakTickWrites() const { return peakTickWrites; }
+
+private:
+    struct Pending {
+        Write write;
+        UINT32 tick;    // Tick it was requested on
+    };
+
+    UINT32 budget;
+    UINT32 tolerance;
+    UINT32 currentTick;             // Sample the open tick starts on
+    UINT32 tickWrites;              // Writes already placed on the current tick
+    std::vector<Write> fixed;
+    std::deque<Pending> flexible;
+
+    UINT32 deferredWrites;
+    UINT32 maxDelay;
+    UINT32 overflowTicks;
+    UINT32 overflowWrites;
+    UINT32 firstOverflowTick;
+    UINT32 peakTickWrites;
+
+    void Place(const Pending& p, std::vector<Write>& out);
+};
+
+#endif // WRITESCHEDULER_H
@@ -0,0 +1,157 @@
+#include "ZipArchive.h"
+#include "VGMReader.h"
+#include <zlib.h>
+#include <cstring>
+#include <iostream>
+
+#define ZIP_LOCAL_HEADER_SIG    0x04034B50
+#define ZIP_CENTRAL_HEADER_SIG  0x02014B50
+#define ZIP_END_OF_DIR_SIG      0x06054B50
+
+#define ZIP_LOCAL_HEADER_SIZE   30
+#define ZIP_CENTRAL_HEADER_SIZE 46
+#define ZIP_END_OF_DIR_SIZE     22
+
+ZipArchive::ZipArchive() {
+}
+
+ZipArchive::~ZipArchive() {
+}
+
+bool ZipArchive::Open(const std::string& filename) {
+    Close();
+    if (!file.Open(filename)) {
+        std::cerr << "Failed to open ZIP file: " << filename << std::endl;
+        return false;
+    }
+
+    const UINT8* data = file.Data();
+    UINT32 size = file.Size();
+    if (size < ZIP_END_OF_DIR_SIZE) {
+        std::cerr << "File too small to be a ZIP archive: " << filename << std::endl;
+        return false;
+    }
+
+    // End of central directory record: last 22 bytes plus up to 64 KB of comment
+    UINT32 eocd = 0;
+    bool found = false;
+    UINT32 minPos = (size > ZIP_END_OF_DIR_SIZE + 0xFFFF) ? size - ZIP_END_OF_DIR_SIZE - 0xFFFF : 0;
+    for (UINT32 pos = size - ZIP_END_OF_DIR_SIZE + 1; pos-- > minPos; ) {
+        if (VGMReader::ReadLE32(&data[pos]) == ZIP_END_OF_DIR_SIG) {
+            eocd = pos;
+            found = true;
+            break;
+        }
+    }
+    if (!found) {
+        std::cerr << "No ZIP central directory found: " << filename << std::endl;
+        return false;
+    }
+
+    UINT16 entryCount = VGMReader::ReadLE16(&data[eocd + 10]);
+    UINT32 dirSize = VGMReader::ReadLE32(&data[eocd + 12]);
+    UINT32 dirOffset = VGMReader::ReadLE32(&data[eocd + 16]);
+    if (entryCount == 0xFFFF || dirOffset == 0xFFFFFFFF) {
+        std::cerr << "ZIP64 archives are not supported: " << filename << std::endl;
+        return false;
+    }
+    if (dirOffset + dirSize > eocd) {
+        std::cerr << "Invalid ZIP central directory: " << filename << std::endl;
+        return false;
+    }
+
+    // Central directory
+    UINT32 pos = dirOffset;
+    for (UINT16 i = 0; i < entryCount; i++) {
+        if (pos + ZIP_CENTRAL_HEADER_SIZE > eocd ||
+            VGMReader::ReadLE32(&data[pos]) != ZIP_CENTRAL_HEADER_SIG) {
+            std::cerr << "Invalid ZIP central directory entry: " << filename << std::endl;
+            entries.clear();
+            return false;
+        }
+
+        UINT16 flags = VGMReader::ReadLE16(&data[pos + 8]);
+        UINT16 nameLen = VGMReader::ReadLE16(&data[pos + 28]);
+        UINT16 extraLen = VGMReader::ReadLE16(&data[pos + 30]);
+        UINT16 commentLen = VGMReader::ReadLE16(&data[pos + 32]);
+
+        Entry entry;
+        entry.method = VGMReader::ReadLE16(&data[pos + 10]);
+        entry.crc = VGMReader::ReadLE32(&data[pos + 16]);
+        entry.compressedSize = VGMReader::ReadLE32(&data[pos + 20]);
+        entry.size = VGMReader::ReadLE32(&data[pos + 24]);
+        entry.localHeaderOffset = VGMReader::ReadLE32(&data[pos + 42]);
+        entry.name.assign((const char*)&data[pos + ZIP_CENTRAL_HEADER_SIZE], nameLen);
+
+        // Skip directories and encrypted entries
+        bool isDir = !entry.name.empty() && entry.name[entry.name.size() - 1] == '/';
+        if (!isDir && !(flags & 0x0001)) {
+            entries.push_back(entry);
+        }
+
+        pos += ZIP_CENTRAL_HEADER_SIZE + nameLen + extraLen + commentLen;
+    }
+
+    return true;
+}
+
+void ZipArchive::Close() {
+    entries.clear();
+    file.Close();
+}
+
+bool ZipArchive::Extract(const Entry& entry, std::vector<UINT8>& out) const {
+    const UINT8* data = file.Data();
+    UINT32 size = file.Size();
+
+    // Local header: its name/extra lengths may differ from the central directory
+    UINT32 pos = entry.localHeaderOffset;
+    if (pos + ZIP_LOCAL_HEADER_SIZE > size || VGMReader::ReadLE32(&data[pos]) != ZIP_LOCAL_HEADER_SIG) {
+        std::cerr << "Invalid ZIP local header: " << entry.name << std::endl;
+        return false;
+    }
+    UINT32 dataPos = pos + ZIP_LOCAL_HEADER_SIZE +
+                     VGMReader::ReadLE16(&data[pos + 26]) + VGMReader::ReadLE16(&data[pos + 28]);
+    if (dataPos + entry.compressedSize > size) {
+        std::cerr << "ZIP entry is truncated: " << entry.name << std::endl;
+        return false;
+    }
+
+    out.resize(entry.size);
+    if (entry.method == 0) {
+        if (entry.compressedSize != entry.size) {
+            std::cerr << "Invalid stored ZIP entry: " << entry.name << std::endl;
+            return false;
+        }
+        if (entry.size > 0) {
+            memcpy(&out[0], &data[dataPos], entry.size);
+        }
+    } else if (entry.method == 8) {
+        z_stream zs;
+        memset(&zs, 0, sizeof(zs));
+        if (inflateInit2(&zs, -15) != Z_OK) {  // Raw deflate, no wrapper
+            return false;
+        }
+        zs.next_in = (Bytef*)&data[dataPos];
+        zs.avail_in = entry.compressedSize;
+        zs.next_out = out.empty() ? NULL : &out[0];
+        zs.avail_out = entry.size;
+        int ret = inflate(&zs, Z_FINISH);
+        inflateEnd(&zs);
+        if (ret != Z_STREAM_END || zs.total_out != entry.size) {
+            std::cerr << "Failed to inflate ZIP entry: " << entry.name << std::endl;
+            return false;
+        }
+    } else {
+        std::cerr << "Unsupported ZIP compression method " << entry.method
+                  << ": " << entry.name << std::endl;
+        return false;
+    }
+
+    if (crc32(0L, out.empty() ? NULL : &out[0], out.size()) != entry.crc) {
+        std::cerr << "ZIP entry CRC mismatch: " << entry.name << std::endl;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef ZIPARCHIVE_H
+#define ZIPARCHIVE_H
+
+#include "../libvgm/stdtype.h"
+#include "MappedFile.h"
+#include <vector>
+#include <string>
+
+// Read-only access to a .zip archive without unpacking it to disk: the
+// archive is memory-mapped, the central directory is parsed on Open() and
+// entries are inflated into memory on request. Stored and deflated entries
+// are supported (no ZIP64, no encryption). Extract() only reads the
+// mapping, so several threads may extract from one archive at once.
+class ZipArchive {
+public:
+    struct Entry {
+        std::string name;           // Path inside the archive
+        UINT16 method;              // 0 = stored, 8 = deflated
+        UINT32 crc;
+        UINT32 compressedSize;
+        UINT32 size;                // Uncompressed size
+        UINT32 localHeaderOffset;
+    };
+
+    ZipArchive();
+    ~ZipArchive();
+
+    bool Open(const std::string& filename);
+    void Close();
+
+    const std::vector<Entry>& GetEntries() const { return entries; }
+
+    bool Extract(const Entry& entry, std::vector<UINT8>& out) const;
+
+private:
+    MappedFile file;
+    std::vector<Entry> entries;
+};
+
+#endif // ZIPARCHIVE_H
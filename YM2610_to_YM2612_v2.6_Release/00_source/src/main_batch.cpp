@@ -0,0 +1,420 @@
+#include "VGMConverterWithDAC.h"
+#include "ADPCMSampleBank.h"
+#include "ZipArchive.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <map>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define mkdir(path, mode) _mkdir(path)
+#else
+#include <sys/types.h>
+#endif
+
+// Native replacement for the convert_complete.sh loop: converts every track
+// of a game (zip archive or directory) on a pool of worker threads. Zip
+// entries are inflated in memory, nothing is unpacked to disk.
+
+// One track to convert
+struct BatchJob {
+    std::string name;       // Track name (file name without directory and extension)
+    std::string relPath;    // Path inside the archive or below the input directory
+    std::string path;       // Input file (directory input)
+    int zipEntry;           // Index into the archive entries (zip input), -1 = file
+    UINT32 size;            // Input size, larger tracks are started first
+    bool ok;
+    UINT32 outputSize;
+};
+
+// Parse a decimal option value; false unless it is a number in [minValue, maxValue]
+static bool ParseUInt(const char* text, UINT32 minValue, UINT32 maxValue, UINT32& value) {
+    char* end;
+    errno = 0;
+    long parsed = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || parsed < (long)minValue || parsed > (long)maxValue) {
+        return false;
+    }
+    value = (UINT32)parsed;
+    return true;
+}
+
+static void PrintUsage() {
+    std::cout << "Usage: vgm_batch [options] <input.zip or input_dir> [output_dir]" << std::endl;
+    std::cout << "  Converts all .vgm/.vgz tracks of a game to output_dir/<game>_v2.6/ (default 02_output)" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --dac=stream   Decode ADPCM ROM samples, trigger them with DAC stream commands" << std::endl;
+    std::cout << "  --render       Render ADPCM in-process with libvgm (default)" << std::endl;
+    std::cout << "  --vgz[=LEVEL]  Write gzip-compressed .vgz output (zlib level 1-9, default 9)" << std::endl;
+    std::cout << "  --optimize     Drop redundant YM2612 register writes and merge waits" << std::endl;
+    std::cout << "  --dac-changes-only  Write the DAC only when its value changes (render mode)" << std::endl;
+    std::cout << "  --dac-rate=HZ  Resample the rendered DAC feed to HZ (e.g. 8000, 11025, 16000);" << std::endl;
+    std::cout << "                 the DAC is written once per sample, so lower rates mean smaller files" << std::endl;
+    std::cout << "  --gain=G       PCM gain on the DAC feed (1.0 = vgm2wav_adpcm_only level)" << std::endl;
+    std::cout << "  --dither=MODE  8-bit DAC dither: none (default), tpdf, shaped" << std::endl;
+    std::cout << "  --bus-budget=N Hardware playback: at most N register writes per sample; FM writes" << std::endl;
+    std::cout << "                 over it move to later samples, DAC writes keep their timing" << std::endl;
+    std::cout << "  --bus-tolerance=T  Samples an FM write may be moved (default 16)" << std::endl;
+    std::cout << "  --jobs=N       Number of worker threads (default: number of cores)" << std::endl;
+    std::cout << "  --verbose      Show the full converter output (interleaved between threads)" << std::endl;
+}
+
+static bool HasExtension(const std::string& name, const char* ext) {
+    size_t len = strlen(ext);
+    if (name.size() < len) return false;
+    std::string tail = name.substr(name.size() - len);
+    for (size_t i = 0; i < tail.size(); i++) {
+        tail[i] = (char)tolower((unsigned char)tail[i]);
+    }
+    return tail == ext;
+}
+
+static bool IsVGMName(const std::string& name) {
+    return HasExtension(name, ".vgm") || HasExtension(name, ".vgz");
+}
+
+static std::string GetBaseName(const std::string& path, bool stripExtension) {
+    std::string name = path;
+    size_t slash = name.find_last_of("/\\");
+    if (slash != std::string::npos) {
+        name = name.substr(slash + 1);
+    }
+    if (stripExtension) {
+        size_t dot = name.find_last_of('.');
+        if (dot != std::string::npos) {
+            name = name.substr(0, dot);
+        }
+    }
+    return name;
+}
+
+static bool IsDirectory(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && (st.st_mode & S_IFDIR);
+}
+
+static UINT32 GetFileSize(const std::string& path) {
+    struct stat st;
+    return (stat(path.c_str(), &st) == 0) ? (UINT32)st.st_size : 0;
+}
+
+// Tracks in dir and its direct subdirectories, like the script's */*.vgz
+static void ScanDirectory(const std::string& dir, const std::string& relDir, int depth, std::vector<BatchJob>& jobs) {
+    DIR* d = opendir(dir.c_str());
+    if (d == NULL) {
+        return;
+    }
+
+    std::vector<std::string> names;
+    struct dirent* ent;
+    while ((ent = readdir(d)) != NULL) {
+        if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0) {
+            names.push_back(ent->d_name);
+        }
+    }
+    closedir(d);
+    std::sort(names.begin(), names.end());
+
+    for (size_t i = 0; i < names.size(); i++) {
+        std::string path = dir + "/" + names[i];
+        std::string relPath = relDir.empty() ? names[i] : relDir + "/" + names[i];
+        if (IsDirectory(path)) {
+            if (depth == 0) {
+                ScanDirectory(path, relPath, depth + 1, jobs);
+            }
+        } else if (IsVGMName(names[i])) {
+            BatchJob job;
+            job.name = GetBaseName(names[i], true);
+            job.relPath = relPath;
+            job.path = path;
+            job.zipEntry = -1;
+            job.size = GetFileSize(path);
+            job.ok = false;
+            job.outputSize = 0;
+            jobs.push_back(job);
+        }
+    }
+}
+
+static std::string ToLower(std::string text) {
+    for (size_t i = 0; i < text.size(); i++) {
+        text[i] = (char)tolower((unsigned char)text[i]);
+    }
+    return text;
+}
+
+// All outputs go to one directory, so tracks with the same name in different
+// folders (disc1/01.vgz, disc2/01.vgz) get the folder in their name instead
+// (disc1_01, disc2_01). Names are compared ignoring case, as on the
+// filesystems the output may end up on. Returns false if names still clash.
+static bool ResolveNameCollisions(std::vector<BatchJob>& jobs) {
+    std::map<std::string, int> count;
+    for (size_t i = 0; i < jobs.size(); i++) {
+        count[ToLower(jobs[i].name)]++;
+    }
+    for (size_t i = 0; i < jobs.size(); i++) {
+        if (count[ToLower(jobs[i].name)] < 2) continue;
+        std::string name = jobs[i].relPath;
+        size_t dot = name.find_last_of('.');
+        if (dot != std::string::npos) {
+            name = name.substr(0, dot);
+        }
+        std::replace(name.begin(), name.end(), '/', '_');
+        std::replace(name.begin(), name.end(), '\\', '_');
+        jobs[i].name = name;
+    }
+
+    std::map<std::string, size_t> seen;
+    bool ok = true;
+    for (size_t i = 0; i < jobs.size(); i++) {
+        std::map<std::string, size_t>::iterator it = seen.find(ToLower(jobs[i].name));
+        if (it != seen.end()) {
+            std::cerr << "Error: " << jobs[it->second].relPath << " and " << jobs[i].relPath
+                      << " would both be written as " << jobs[i].name << "_YM2612" << std::endl;
+            ok = false;
+        } else {
+            seen[ToLower(jobs[i].name)] = i;
+        }
+    }
+    return ok;
+}
+
+static void MakeDirectory(const std::string& path) {
+    // Create every missing component
+    for (size_t i = 1; i <= path.size(); i++) {
+        if (i == path.size() || path[i] == '/' || path[i] == '\\') {
+            mkdir(path.substr(0, i).c_str(), 0755);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    DACMode dacMode = DAC_MODE_DIRECT;
+    bool renderADPCM = true;
+    int vgzLevel = 0;
+    unsigned int numJobs = 0;
+    bool verbose = false;
+    bool optimize = false;
+    bool dacChangesOnly = false;
+    UINT32 dacRate = 0;  // 0 = render / WAV rate
+    double pcmGain = 1.0;
+    PCMDither dither = PCM_DITHER_NONE;
+    UINT32 busBudget = 0;  // 0 = no write scheduling
+    UINT32 busTolerance = 16;
+
+    int argi = 1;
+    while (argi < argc && std::strncmp(argv[argi], "--", 2) == 0) {
+        std::string opt = argv[argi];
+        if (opt == "--dac=stream") {
+            dacMode = DAC_MODE_STREAM;
+            renderADPCM = false;
+        } else if (opt == "--render") {
+            dacMode = DAC_MODE_DIRECT;
+            renderADPCM = true;
+        } else if (opt == "--vgz") {
+            vgzLevel = 9;
+        } else if (opt.compare(0, 6, "--vgz=") == 0) {
+            UINT32 level;
+            if (!ParseUInt(opt.c_str() + 6, 1, 9, level)) {
+                std::cerr << "Error: --vgz level must be 1-9" << std::endl;
+                return 1;
+            }
+            vgzLevel = (int)level;
+        } else if (opt.compare(0, 7, "--jobs=") == 0) {
+            UINT32 jobCount;
+            if (!ParseUInt(opt.c_str() + 7, 1, 256, jobCount)) {
+                std::cerr << "Error: --jobs must be 1-256" << std::endl;
+                return 1;
+            }
+            numJobs = jobCount;
+        } else if (opt == "--optimize") {
+            optimize = true;
+        } else if (opt == "--dac-changes-only") {
+            dacChangesOnly = true;
+        } else if (opt.compare(0, 11, "--dac-rate=") == 0) {
+            if (!ParseUInt(opt.c_str() + 11, 1000, 44100, dacRate)) {
+                std::cerr << "Error: --dac-rate must be 1000-44100 Hz" << std::endl;
+                return 1;
+            }
+        } else if (opt.compare(0, 7, "--gain=") == 0) {
+            pcmGain = std::atof(opt.c_str() + 7);
+            if (!(pcmGain > 0.0 && pcmGain <= 16.0)) {
+                std::cerr << "Error: --gain must be above 0 and at most 16" << std::endl;
+                return 1;
+            }
+        } else if (opt == "--dither=none") {
+            dither = PCM_DITHER_NONE;
+        } else if (opt == "--dither=tpdf") {
+            dither = PCM_DITHER_TPDF;
+        } else if (opt == "--dither=shaped") {
+            dither = PCM_DITHER_SHAPED;
+        } else if (opt.compare(0, 13, "--bus-budget=") == 0) {
+            if (!ParseUInt(opt.c_str() + 13, 0, 1000, busBudget)) {
+                std::cerr << "Error: --bus-budget must be 0-1000 writes per sample" << std::endl;
+                return 1;
+            }
+        } else if (opt.compare(0, 16, "--bus-tolerance=") == 0) {
+            if (!ParseUInt(opt.c_str() + 16, 0, 44100, busTolerance)) {
+                std::cerr << "Error: --bus-tolerance must be 0-44100 samples" << std::endl;
+                return 1;
+            }
+        } else if (opt == "--verbose") {
+            verbose = true;
+        } else {
+            std::cerr << "Unknown option: " << opt << std::endl;
+            PrintUsage();
+            return 1;
+        }
+        argi++;
+    }
+
+    if (argi >= argc) {
+        PrintUsage();
+        return 1;
+    }
+
+    std::string input = argv[argi];
+    std::string outputDir = (argi + 1 < argc) ? argv[argi + 1] : "02_output";
+
+    // Collect tracks
+    std::vector<BatchJob> jobs;
+    ZipArchive archive;
+    std::string gameName;
+    if (HasExtension(input, ".zip")) {
+        if (!archive.Open(input)) {
+            return 1;
+        }
+        const std::vector<ZipArchive::Entry>& entries = archive.GetEntries();
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (!IsVGMName(entries[i].name)) continue;
+            BatchJob job;
+            job.name = GetBaseName(entries[i].name, true);
+            job.relPath = entries[i].name;
+            job.zipEntry = i;
+            job.size = entries[i].size;
+            job.ok = false;
+            job.outputSize = 0;
+            jobs.push_back(job);
+        }
+        gameName = GetBaseName(input, true);
+    } else if (IsDirectory(input)) {
+        ScanDirectory(input, "", 0, jobs);
+        gameName = GetBaseName(input, false);
+    } else {
+        std::cerr << "Error: input must be a .zip file or a directory: " << input << std::endl;
+        return 1;
+    }
+    if (!ResolveNameCollisions(jobs)) {
+        return 1;
+    }
+
+    std::string finalOutputDir = outputDir + "/" + gameName + "_v2.6";
+    MakeDirectory(finalOutputDir);
+
+    if (numJobs == 0) {
+        numJobs = std::thread::hardware_concurrency();
+        if (numJobs == 0) numJobs = 1;
+    }
+    if (numJobs > jobs.size()) {
+        numJobs = jobs.size() ? jobs.size() : 1;
+    }
+
+    std::cout << "=== YM2610 to YM2612 v2.6 Batch Conversion ===" << std::endl;
+    std::cout << "Game: " << gameName << std::endl;
+    std::cout << "Output: " << finalOutputDir << std::endl;
+    std::cout << "Tracks: " << jobs.size() << ", worker threads: " << numJobs << std::endl;
+    std::cout << std::endl;
+
+    // Longest tracks first, so the last one to finish is not a long one
+    // started at the end
+    std::vector<size_t> order(jobs.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&jobs](size_t a, size_t b) {
+        return jobs[a].size > jobs[b].size;
+    });
+
+    std::mutex consoleLock;
+    std::atomic<size_t> nextJob(0);
+    std::string extension = (vgzLevel > 0) ? ".vgz" : ".vgm";
+
+    std::vector<std::thread> workers;
+    for (unsigned int w = 0; w < numJobs; w++) {
+        workers.push_back(std::thread([&]() {
+            // One bank per worker: the tracks it converts share decoded
+            // samples (DAC stream mode) or its libvgm ADPCM-A cache (render mode)
+            ADPCMSampleBank sampleBank;
+            // The converters log every step; unless asked for, keep that
+            // quiet and report one result per track instead (errors still
+            // go to std::cerr). A stream without a buffer drops everything.
+            std::ostream quiet(NULL);
+
+            size_t n;
+            while ((n = nextJob++) < order.size()) {
+                BatchJob& job = jobs[order[n]];
+                std::string outputFile = finalOutputDir + "/" + job.name + "_YM2612" + extension;
+
+                VGMConverterWithDAC converter(sampleBank);
+                converter.SetDACMode(dacMode);
+                converter.SetRenderADPCM(renderADPCM);
+                converter.SetCompression(vgzLevel);
+                converter.SetOptimize(optimize);
+                converter.SetWriteBudget(busBudget, busTolerance);
+                converter.SetDACChangesOnly(dacChangesOnly);
+                converter.SetDACRate(dacRate);
+                converter.SetPCMGain(pcmGain);
+                converter.SetDither(dither);
+                converter.SetLog(verbose ? std::cout : quiet);
+
+                if (job.zipEntry >= 0) {
+                    const ZipArchive::Entry& entry = archive.GetEntries()[job.zipEntry];
+                    std::vector<UINT8> data;
+                    job.ok = archive.Extract(entry, data) && converter.Convert(data, entry.name, outputFile);
+                } else {
+                    job.ok = converter.Convert(job.path, "", outputFile);
+                }
+                if (job.ok) {
+                    job.outputSize = GetFileSize(outputFile);
+                }
+
+                std::lock_guard<std::mutex> lock(consoleLock);
+                std::cout << "Converting: " << job.name << std::endl;
+                if (job.ok) {
+                    std::cout << "  Success: " << (job.outputSize + 1023) / 1024 << "K" << std::endl;
+                } else {
+                    std::cout << "  Failed to convert" << std::endl;
+                }
+            }
+        }));
+    }
+    for (size_t w = 0; w < workers.size(); w++) {
+        workers[w].join();
+    }
+
+    int converted = 0;
+    int failed = 0;
+    for (size_t i = 0; i < jobs.size(); i++) {
+        if (jobs[i].ok) {
+            converted++;
+        } else {
+            failed++;
+        }
+    }
+
+    std::cout << std::endl;
+    std::cout << "=== Conversion Complete ===" << std::endl;
+    std::cout << "Converted: " << converted << " files" << std::endl;
+    std::cout << "Failed: " << failed << " files" << std::endl;
+    std::cout << "Output directory: " << finalOutputDir << std::endl;
+
+    return failed ? 1 : 0;
+}
@@ -74,9 +74,9 @@ private:
     CommandMapper mapper;
 
     bool ConvertCommands() {
-        const std::vector<UINT8>& data = reader.GetData();
+        const UINT8* data = reader.GetData();
         UINT32 pos = reader.GetDataStart();
-        UINT32 dataSize = data.size();
+        UINT32 dataSize = reader.GetSize();
 
         while (pos < dataSize) {
             UINT8 cmd = data[pos];
@@ -152,7 +152,7 @@ private:
         return true;
     }
 
-    UINT32 GetCommandLength(UINT8 cmd, const std::vector<UINT8>& data, UINT32 pos, UINT32 dataSize) {
+    UINT32 GetCommandLength(UINT8 cmd, const UINT8* data, UINT32 pos, UINT32 dataSize) {
         // Return the length of a VGM command
         if (cmd >= 0x70 && cmd <= 0x7F) return 1;  // Wait 1-16 samples
         if (cmd >= 0x80 && cmd <= 0x8F) return 1;  // YM2612 PCM write + wait
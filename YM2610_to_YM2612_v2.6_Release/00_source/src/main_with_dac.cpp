@@ -290,9 +290,9 @@ private:
     }
 
     bool ConvertCommands() {
-        const std::vector<UINT8>& data = reader.GetData();
+        const UINT8* data = reader.GetData();
         UINT32 pos = reader.GetDataStart();
-        UINT32 dataSize = data.size();
+        UINT32 dataSize = reader.GetSize();
         const VGMHeader& header = reader.GetHeader();
 
         // Calculate loop position in source VGM
@@ -424,7 +424,7 @@ private:
         return true;
     }
 
-    UINT32 GetCommandLength(UINT8 cmd, const std::vector<UINT8>& data, UINT32 pos, UINT32 dataSize) {
+    UINT32 GetCommandLength(UINT8 cmd, const UINT8* data, UINT32 pos, UINT32 dataSize) {
         if (cmd >= 0x70 && cmd <= 0x7F) return 1;
         if (cmd >= 0x80 && cmd <= 0x8F) return 1;
 
@@ -23,6 +23,7 @@
 #include "emu/SoundDevs.h"
 #include "emu/EmuCores.h"
 #include "emu/SoundEmu.h"
+#include "emu/cores/opnintf.h"
 
 #ifdef _MSC_VER
 #define strncasecmp	_strnicmp
@@ -47,6 +48,10 @@ bit_depth = 16;
 static unsigned int
 loops = 1;  // Only play once, no loops
 
+/* PCM gain (master volume) */
+static double
+gain = 1.5;  // == 150% (boost PCM volume)
+
 /* vgm-specific functions */
 static void
 FCC2STR(char *str, UINT32 fcc);
@@ -170,6 +175,19 @@ int main(int argc, const char *argv[]) {
             argv++;
             argc--;
         }
+        else if(str_istarts(*argv,"--gain")) {
+            c = strchr(*argv,'=');
+            if(c != NULL) {
+                s = &c[1];
+            } else {
+                argv++;
+                argc--;
+                s = *argv;
+            }
+            gain = strtod(s,NULL);
+            argv++;
+            argc--;
+        }
         else {
             break;
         }
@@ -183,6 +201,11 @@ int main(int argc, const char *argv[]) {
         sample_rate = 44100;
     }
 
+    if(!(gain > 0.0 && gain <= 16.0)) {
+        fprintf(stderr,"Error: --gain must be above 0 and at most 16\n");
+        return 1;
+    }
+
     switch(bit_depth) {
         case 16: break;
         case 24: break;
@@ -197,6 +220,7 @@ int main(int argc, const char *argv[]) {
         fprintf(stderr,"    --bps\n");
         fprintf(stderr,"    --fade\n");
         fprintf(stderr,"    --loops\n");
+        fprintf(stderr,"    --gain (PCM gain, default 1.5)\n");
         return 1;
     }
 
@@ -234,7 +258,7 @@ int main(int argc, const char *argv[]) {
     /* set playback parameters */
     {
         PlayerA::Config pCfg = player.GetConfiguration();
-        pCfg.masterVol = 0x18000;	// == 1.5 == 150% (boost PCM volume)
+        pCfg.masterVol = (INT32)(gain * 0x10000 + 0.5);	// 16.16 fixed point
         pCfg.loopCount = loops;
         pCfg.fadeSmpls = sample_rate * fade_len;
         pCfg.endSilenceSmpls = 0;
@@ -305,7 +329,7 @@ int main(int argc, const char *argv[]) {
      * Start updates the sample rate multiplier/divisors */
     player.Start();
 
-    /* Mute FM channels to output ADPCM only */
+    /* Render ADPCM only: the YM2610 skips its FM channels and the SSG */
     {
         std::vector<PLR_DEV_INFO> devList;
         plrEngine->GetSongDeviceInfo(devList);
@@ -315,17 +339,20 @@ int main(int argc, const char *argv[]) {
             const PLR_DEV_INFO& devInf = devList[i];
             fprintf(stderr,"  Device %zu: Type=0x%02X, ID=0x%08X\n", i, devInf.type, devInf.id);
 
-            // YM2610 device type is 0x08 (DEVID_YM2610)
-            if (devInf.type == 0x08) {
-                PLR_MUTE_OPTS muteOpts;
-                muteOpts.disable = 0x00;  // Don't disable the device
-                // YM2610 has 4 FM channels (0-3) and ADPCM channels
-                // Mute FM channels 0-3 (bits 0-3)
-                muteOpts.chnMute[0] = 0x0000000F;  // Mute FM channels 0-3
-                muteOpts.chnMute[1] = 0x00000000;  // Don't mute linked device
+            if (devInf.type == DEVID_YM2610) {
+                PLR_DEV_OPTS devOpts;
+                plrEngine->GetDeviceOptions(devInf.id, devOpts);
+                devOpts.coreOpts |= OPT_YM2610_PCM_ONLY | OPT_YM2610_ADPCMA_CACHE;
+                plrEngine->SetDeviceOptions(devInf.id, devOpts);
 
+                // Mute FM CH0-5 and the SSG as well, so nothing but ADPCM is
+                // rendered even with a libvgm that lacks the option
+                PLR_MUTE_OPTS muteOpts;
+                muteOpts.disable = 0x00;
+                muteOpts.chnMute[0] = 0x0000003F;
+                muteOpts.chnMute[1] = 0x00000007;
                 plrEngine->SetDeviceMuting(devInf.id, muteOpts);
-                fprintf(stderr,"  -> Muted FM channels on YM2610 device (ADPCM-only mode)\n");
+                fprintf(stderr,"  -> YM2610 set to PCM-only mode (ADPCM-A/B, no FM/SSG)\n");
             }
         }
     }
@@ -4,9 +4,33 @@
 
 set -e
 
+# Options
+#   (default)     ADPCM is rendered with libvgm inside vgm_converter (--render) and
+#                 written as DAC samples; no temporary WAV files
+#   --dac=stream  ADPCM samples are decoded from the VGM ROM blocks and played as
+#                 DAC streams (no vgm2wav step)
+# The whole game is converted in one converter process, so each ADPCM sample
+# is decoded once per game in either mode
+#   --vgz         Write gzip-compressed _YM2612.vgz files instead of .vgm
+# .vgz input is read by the converter directly, nothing is decompressed to disk
+DAC_MODE=render
+OUT_EXT=vgm
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --dac=stream) DAC_MODE=stream; shift ;;
+        --vgz) OUT_EXT=vgz; shift ;;
+        *) break ;;
+    esac
+done
+
+VGZ_OPT=""
+if [ "$OUT_EXT" == "vgz" ]; then
+    VGZ_OPT="--vgz"
+fi
+
 # Check if input is a zip file or directory
 if [ $# -lt 1 ]; then
-    echo "Usage: $0 <input.zip or input_dir> [output_dir]"
+    echo "Usage: $0 [--dac=stream] [--vgz] <input.zip or input_dir> [output_dir]"
     exit 1
 fi
 
@@ -17,7 +41,6 @@ SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 
 # Tool paths for v2.6
 VGM_CONVERTER="$SCRIPT_DIR/00_source/build/vgm_converter.exe"
-VGM2WAV_ADPCM="$SCRIPT_DIR/00_source/build/vgm2wav_adpcm_only.exe"
 
 # Check if tools exist
 if [ ! -f "$VGM_CONVERTER" ]; then
@@ -25,9 +48,15 @@ if [ ! -f "$VGM_CONVERTER" ]; then
     exit 1
 fi
 
-if [ ! -f "$VGM2WAV_ADPCM" ]; then
-    echo "Error: vgm2wav_adpcm_only.exe not found in 00_source/build/"
-    exit 1
+# Prefer the native batch converter when it is built: it reads the zip in
+# process and converts the tracks in parallel
+VGM_BATCH="$SCRIPT_DIR/00_source/build/vgm_batch.exe"
+if [ -f "$VGM_BATCH" ]; then
+    BATCH_OPTS="$VGZ_OPT"
+    if [ "$DAC_MODE" == "stream" ]; then
+        BATCH_OPTS="$BATCH_OPTS --dac=stream"
+    fi
+    exec "$VGM_BATCH" $BATCH_OPTS "$INPUT" "$OUTPUT_DIR"
 fi
 
 # Create temp directory
@@ -57,83 +86,43 @@ echo ""
 converted=0
 failed=0
 
-# Find all VGZ and VGM files
-for vgzfile in "$INPUT_DIR"/*.vgz "$INPUT_DIR"/*/*.vgz; do
-    if [ ! -f "$vgzfile" ]; then
-        continue
+# Gather all VGZ and VGM files
+inputs=()
+for vgmfile in "$INPUT_DIR"/*.vgz "$INPUT_DIR"/*/*.vgz "$INPUT_DIR"/*.vgm "$INPUT_DIR"/*/*.vgm; do
+    if [ -f "$vgmfile" ]; then
+        inputs+=("$vgmfile")
     fi
-
-    filename=$(basename "$vgzfile" .vgz)
-    echo "Converting: $filename"
-
-    # Decompress VGZ to VGM
-    vgmfile="$TEMP_DIR/${filename}.vgm"
-    gunzip -c "$vgzfile" > "$vgmfile" 2>/dev/null || {
-        echo "  Failed to decompress"
-        ((failed++))
-        continue
-    }
-
-    # Step 1: Extract ADPCM
-    wavfile="$TEMP_DIR/${filename}.wav"
-    "$VGM2WAV_ADPCM" "$vgmfile" "$wavfile" >/dev/null 2>&1 || {
-        echo "  Failed to extract ADPCM"
-        ((failed++))
-        rm -f "$vgmfile"
-        continue
-    }
-
-    # Step 2: Convert with DAC
-    output_vgm="$FINAL_OUTPUT_DIR/${filename}_YM2612.vgm"
-    "$VGM_CONVERTER" "$vgmfile" "$wavfile" "$output_vgm" >/dev/null 2>&1 || {
-        echo "  Failed to convert"
-        ((failed++))
-        rm -f "$vgmfile" "$wavfile"
-        continue
-    }
-
-    size=$(du -h "$output_vgm" | cut -f1)
-    echo "  Success: $size"
-    ((converted++))
-
-    # Cleanup temp files
-    rm -f "$vgmfile" "$wavfile"
 done
 
-# Also process plain VGM files
-for vgmfile in "$INPUT_DIR"/*.vgm "$INPUT_DIR"/*/*.vgm; do
-    if [ ! -f "$vgmfile" ]; then
-        continue
-    fi
+if [ "$DAC_MODE" == "stream" ]; then
+    MODE_OPT="--dac=stream"
+else
+    MODE_OPT="--render"
+fi
 
-    filename=$(basename "$vgmfile" .vgm)
-    echo "Converting: $filename"
+# Convert all tracks in a single run so the shared ADPCM ROM is compared
+# per track but decoded only once
+if [ ${#inputs[@]} -gt 0 ]; then
+    "$VGM_CONVERTER" $MODE_OPT $VGZ_OPT --out-dir="$FINAL_OUTPUT_DIR" "${inputs[@]}" > "$TEMP_DIR/convert.log" 2>&1 || true
+fi
 
-    # Step 1: Extract ADPCM
-    wavfile="$TEMP_DIR/${filename}.wav"
-    "$VGM2WAV_ADPCM" "$vgmfile" "$wavfile" >/dev/null 2>&1 || {
-        echo "  Failed to extract ADPCM"
-        ((failed++))
-        continue
-    }
-
-    # Step 2: Convert with DAC
-    output_vgm="$FINAL_OUTPUT_DIR/${filename}_YM2612.vgm"
-    "$VGM_CONVERTER" "$vgmfile" "$wavfile" "$output_vgm" >/dev/null 2>&1 || {
+for vgmfile in "${inputs[@]}"; do
+    filename=$(basename "$vgmfile")
+    filename="${filename%.*}"
+    output_vgm="$FINAL_OUTPUT_DIR/${filename}_YM2612.$OUT_EXT"
+    echo "Converting: $filename"
+    if [ -f "$output_vgm" ]; then
+        size=$(du -h "$output_vgm" | cut -f1)
+        echo "  Success: $size"
+        converted=$((converted + 1))
+    else
         echo "  Failed to convert"
-        ((failed++))
-        rm -f "$wavfile"
-        continue
-    }
-
-    size=$(du -h "$output_vgm" | cut -f1)
-    echo "  Success: $size"
-    ((converted++))
-
-    # Cleanup temp files
-    rm -f "$wavfile"
+        failed=$((failed + 1))
+    fi
 done
 
+grep -E "ADPCM ROM blocks loaded|ADPCM samples decoded|ADPCM-A samples rendered" "$TEMP_DIR/convert.log" || true
+
 echo ""
 echo "=== Conversion Complete ==="
 echo "Converted: $converted files"
@@ -56,6 +56,46 @@ INLINE void INIT_DEVINF(DEV_INFO* devInf, DEV_DATA* devData, UINT32 sampleRate,
 		rate = customrate;
 
 
+// one-time initialization (e.g. of static tables) that is safe to run from multiple threads
+// Usage:	if (! emu_once_begin(&flag)) return;	... init ...	emu_once_end(&flag);
+typedef volatile long EMU_ONCE;	// 0 = not started, 1 = running, 2 = done
+#define EMU_ONCE_INIT	0
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define EMU_ONCE_CAS(ptr, old, new)	(_InterlockedCompareExchange(ptr, new, old) == (old))
+#define EMU_ONCE_LOAD(ptr)			(*(ptr))	// volatile reads have acquire semantics with MSVC
+#define EMU_ONCE_STORE(ptr, val)	_InterlockedExchange(ptr, val)
+#elif defined(__GNUC__)
+#define EMU_ONCE_CAS(ptr, old, new)	__sync_bool_compare_and_swap(ptr, old, new)
+#define EMU_ONCE_LOAD(ptr)			__atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define EMU_ONCE_STORE(ptr, val)	__atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+#else	// no atomics - single-threaded use only
+#define EMU_ONCE_CAS(ptr, old, new)	((*(ptr) == (old)) ? (*(ptr) = (new), 1) : 0)
+#define EMU_ONCE_LOAD(ptr)			(*(ptr))
+#define EMU_ONCE_STORE(ptr, val)	(*(ptr) = (val))
+#endif
+
+// returns 1 if the caller has to do the initialization, 0 if it is done already
+// (waits if another thread is busy with it)
+INLINE UINT8 emu_once_begin(EMU_ONCE* flag)
+{
+	if (EMU_ONCE_LOAD(flag) == 2)
+		return 0;
+	if (EMU_ONCE_CAS(flag, 0, 1))
+		return 1;
+	while(EMU_ONCE_LOAD(flag) != 2)
+		;	// table setup takes well below a millisecond, so just spin
+	return 0;
+}
+
+INLINE void emu_once_end(EMU_ONCE* flag)
+{
+	EMU_ONCE_STORE(flag, 2);
+	return;
+}
+
+
 // round up to the nearest power of 2
 // from http://graphics.stanford.edu/~seander/bithacks.html#RoundUpPowerOf2
 INLINE UINT32 ceil_pow2(UINT32 v)
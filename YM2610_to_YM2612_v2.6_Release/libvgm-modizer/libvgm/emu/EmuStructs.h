@@ -34,6 +34,7 @@ typedef UINT16 (*DEVFUNC_READ_A16D16)(void* info, UINT16 addr);
 typedef UINT32 (*DEVFUNC_READ_CLOCK)(void* info);
 typedef UINT32 (*DEVFUNC_READ_SRATE)(void* info);
 typedef UINT32 (*DEVFUNC_READ_VOLUME)(void* info);
+typedef UINT32 (*DEVFUNC_READ_STATE)(void* info, void* buffer);	// returns the state size, buffer == NULL only queries it
 
 typedef void (*DEVFUNC_WRITE_A8D8)(void* info, UINT8 addr, UINT8 data);
 typedef void (*DEVFUNC_WRITE_A8D16)(void* info, UINT8 addr, UINT16 data);
@@ -41,9 +42,12 @@ typedef void (*DEVFUNC_WRITE_A16D8)(void* info, UINT16 addr, UINT8 data);
 typedef void (*DEVFUNC_WRITE_A16D16)(void* info, UINT16 addr, UINT16 data);
 typedef void (*DEVFUNC_WRITE_MEMSIZE)(void* info, UINT32 memsize);
 typedef void (*DEVFUNC_WRITE_BLOCK)(void* info, UINT32 offset, UINT32 length, const UINT8* data);
+typedef void (*DEVFUNC_WRITE_DACQUEUE)(void* info, UINT32 smplOfs, UINT8 data);	// offset in device samples from the current render position
+typedef void (*DEVFUNC_WRITE_CACHE)(void* info, void* cache);	// cache type is core specific, NULL = private cache
 typedef void (*DEVFUNC_WRITE_CLOCK)(void* info, UINT32 clock);
 typedef void (*DEVFUNC_WRITE_VOLUME)(void* info, INT32 volume);	// 16.16 fixed point
 typedef void (*DEVFUNC_WRITE_VOL_LR)(void* info, INT32 volL, INT32 volR);
+typedef void (*DEVFUNC_WRITE_STATE)(void* info, const void* buffer);	// buffer must come from the same device instance
 
 #define RWF_WRITE		0x00
 #define RWF_READ		0x01
@@ -58,6 +62,7 @@ typedef void (*DEVFUNC_WRITE_VOL_LR)(void* info, INT32 volL, INT32 volR);
 #define RWF_VOLUME_LR	0x86	// volume (left/right separately)
 #define RWF_CHN_MUTE	0x90	// set channel muting (DEVRW_VALUE = single channel, DEVRW_ALL = mask)
 #define RWF_CHN_PAN		0x92	// set channel panning (DEVRW_VALUE = single channel, DEVRW_ALL = array)
+#define RWF_STATE		0x94	// save (read)/restore (write) the emulation state (DEVRW_ALL)
 
 // register/memory DEVRW constants
 #define DEVRW_A8D8		0x11	//  8-bit address,  8-bit data
@@ -66,6 +71,9 @@ typedef void (*DEVFUNC_WRITE_VOL_LR)(void* info, INT32 volL, INT32 volR);
 #define DEVRW_A16D16	0x22	// 16-bit address, 16-bit data
 #define DEVRW_BLOCK		0x80	// write sample ROM/RAM
 #define DEVRW_MEMSIZE	0x81	// set ROM/RAM size
+#define DEVRW_BLOCKREF	0x82	// map sample ROM/RAM data without copying it (DEVFUNC_WRITE_BLOCK, the data must stay valid while the device runs)
+#define DEVRW_CACHE		0x83	// share a decoded sample cache between devices (DEVFUNC_WRITE_CACHE)
+#define DEVRW_DACQUEUE	0x90	// queue a timestamped DAC write, applied during Update
 // chip setting DEVRW constants
 #define DEVRW_VALUE		0x00
 #define DEVRW_ALL		0x01
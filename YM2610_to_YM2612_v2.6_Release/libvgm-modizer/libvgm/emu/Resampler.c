@@ -350,9 +350,8 @@ static void Resmpl_Exec_Copy(RESMPL_STATE* CAA, UINT32 length, WAVE_32BS* retSam
 	return;
 }
 
-// TODO: The resample is not completely stable.
-//	Resampling tiny blocks (1 resulting sample) sometimes causes values to be off-by-one,
-//	compared to resampling large blocks.
+// Note: The input positions are calculated from the absolute output position,
+//	so that the result doesn't depend on how the output is split into blocks.
 static void Resmpl_Exec_LinearDown(RESMPL_STATE* CAA, UINT32 length, WAVE_32BS* retSample)
 {
 	// RESALGO_LINEAR_DOWN: Linear Downsampling
@@ -393,7 +392,8 @@ static void Resmpl_Exec_LinearDown(RESMPL_STATE* CAA, UINT32 length, WAVE_32BS*
 	{
 		//InPos = InBase + (UINT32)(OutPos * ChipSmpRateFP / CAA->smpRateDst);
 		InPos = InPosNext;
-		InPosNext = InBase + (UINT32)((OutPos+1) * ChipSmpRateFP / CAA->smpRateDst);
+		InPosNext = FIXPNT_FACT + (UINT32)((SLINT)((CAA->smpP + OutPos + 1) * ChipSmpRateFP / CAA->smpRateDst) -
+					(SLINT)CAA->smpLast * FIXPNT_FACT);
 		
 		// first fractional Sample
 		SmpFrc = getnfraction(InPos);
@@ -461,3 +461,35 @@ void Resmpl_Execute(RESMPL_STATE* CAA, UINT32 smplCount, WAVE_32BS* smplBuffer)
 		CAA->smpP += CAA->smpRateDst;	// just skip the samples and do nothing else
 	return;
 }
+
+UINT32 Resmpl_GetSrcOffset(const RESMPL_STATE* CAA, UINT32 dstOffset)
+{
+	UINT64 ChipSmpRateFP;
+	UINT32 srcPos;
+	
+	if (CAA->resampler == NULL || ! dstOffset)
+		return 0;
+	
+	// number of input samples the device has rendered after dstOffset more output samples,
+	// relative to what it has rendered so far (see the resampler functions)
+	ChipSmpRateFP = FIXPNT_FACT * CAA->smpRateSrc;
+	if (CAA->resampler == Resmpl_Exec_Copy)
+	{
+		return dstOffset;
+	}
+	else if (CAA->resampler == Resmpl_Exec_LinearDown)
+	{
+		srcPos = (UINT32)fp2i_ceil((SLINT)((CAA->smpP + dstOffset) * ChipSmpRateFP / CAA->smpRateDst));
+		return srcPos - CAA->smpLast;
+	}
+	else if (CAA->resampler == Resmpl_Exec_LinearUp)
+	{
+		srcPos = (UINT32)fp2i_ceil((SLINT)((CAA->smpP + dstOffset - 1) * ChipSmpRateFP / CAA->smpRateDst));
+		return srcPos - CAA->smpNext;
+	}
+	else //if (CAA->resampler == Resmpl_Exec_Old)
+	{
+		srcPos = (UINT32)((UINT64)(CAA->smpP + dstOffset) * CAA->smpRateSrc / CAA->smpRateDst);
+		return srcPos - CAA->smpNext;
+	}
+}
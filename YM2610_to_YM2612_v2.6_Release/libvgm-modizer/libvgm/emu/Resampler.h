@@ -88,6 +88,16 @@ void Resmpl_ChangeRate(void* DataPtr, UINT32 newSmplRate);
  * @param smplBuffer buffer for output data
  */
 void Resmpl_Execute(RESMPL_STATE* CAA, UINT32 samples, WAVE_32BS* smplBuffer);
+/**
+ * @brief Maps a position in the output stream to the device's input stream.
+ *        A device write done after rendering dstOffset more output samples affects the input
+ *        samples from the returned offset on.
+ *
+ * @param CAA resampler to be queried
+ * @param dstOffset number of output samples, counted from the current position
+ * @return number of input samples the device renders for them, counted from its current position
+ */
+UINT32 Resmpl_GetSrcOffset(const RESMPL_STATE* CAA, UINT32 dstOffset);
 
 #ifdef __cplusplus
 }
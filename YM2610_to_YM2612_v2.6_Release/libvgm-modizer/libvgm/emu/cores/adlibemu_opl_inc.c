@@ -41,6 +41,7 @@
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
+#include "../modizer_voices.h"
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -1311,24 +1312,19 @@ void ADLIBEMU(getsample)(void *chip, UINT32 numsamples, DEV_SMPL** sndptr)
     //search first voice linked to current chip
     int m_voice_ofs=-1;
     int m_total_channels=max_channel;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
     //printf("opn:%d / %lf delta:%lf\n",OPN->ST.rate,OPN->ST.freqbase,DELTAT->freqbase);
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
     int64_t smplIncr;
-    if (m_voice_current_samplerate) smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    if (mzv_ctx->samplerate) smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
     
+#ifndef MODIZER_NO_OSCILLO
     //YOYOFR
-    static INT32 old_out_fm[NUM_CHANNELS]; //YOYOFR
+    static MZV_THREAD_LOCAL INT32 old_out_fm[NUM_CHANNELS]; //YOYOFR
     if (m_voice_ofs>=0) {
         for (int ii=0;ii<max_channel;ii++) {
             if (!(OPL->MuteChn[ii])) {
@@ -1365,6 +1361,7 @@ void ADLIBEMU(getsample)(void *chip, UINT32 numsamples, DEV_SMPL** sndptr)
         }
     }
     //YOYOFR
+#endif
 	
 	if (! numsamples)
 	{
@@ -2103,13 +2100,16 @@ void ADLIBEMU(getsample)(void *chip, UINT32 numsamples, DEV_SMPL** sndptr)
 		outbufl += endsamples;
 		outbufr += endsamples;
         
+#ifndef MODIZER_NO_OSCILLO
         //YOYOFR
+        if (m_voice_ofs>=0)
         for (int i=0;i<max_channel;i++) {
             int64_t ofs_end=(m_voice_current_ptr[m_voice_ofs+i]+smplIncr*endsamples);
             while ((ofs_end>>MODIZER_OSCILLO_OFFSET_FIXEDPOINT)>=SOUND_BUFFER_SIZE_SAMPLE*4*2) ofs_end-=(SOUND_BUFFER_SIZE_SAMPLE*4*2<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT);
             m_voice_current_ptr[m_voice_ofs+i]=ofs_end;
         }
         //YOYOFR
+#endif
 	}
     
 	for (i=0;i<numsamples;i++)
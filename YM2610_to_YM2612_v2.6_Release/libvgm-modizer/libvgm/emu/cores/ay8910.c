@@ -533,7 +533,7 @@ YM2203 Japanese datasheet contents, translated: http://www.larwe.com/technical/c
 */
 
 #include <stdlib.h>
-#include <string.h>	// for memset
+#include <string.h>	// for memset/memcpy
 #include <math.h>
 
 #include "../../stdtype.h"
@@ -555,6 +555,8 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_CLOCK | RWF_WRITE, DEVRW_VALUE, 0, ay8910_set_clock},
 	{RWF_SRATE | RWF_READ, DEVRW_VALUE, 0, ay8910_get_sample_rate},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, ay8910_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_ALL, 0, ay8910_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_ALL, 0, ay8910_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 DEV_DEF devDef_AY8910_MAME =
@@ -1578,6 +1580,43 @@ UINT8 ay8910_read(void *chip, UINT8 addr)
 	else return psg->regs[r];
 }
 
+// The state snapshot is a copy of the context. Loading it restores the
+// registers, counters and envelope, but keeps the chip setup and tables.
+UINT32 ay8910_save_state(void *chip, void *buffer)
+{
+	ay8910_context *psg = (ay8910_context *)chip;
+	
+	if (buffer != NULL)
+		memcpy(buffer, psg, sizeof(ay8910_context));
+	return sizeof(ay8910_context);
+}
+
+void ay8910_load_state(void *chip, const void *buffer)
+{
+	ay8910_context *psg = (ay8910_context *)chip;
+	const ay8910_context *state = (const ay8910_context *)buffer;
+	
+	psg->active = state->active;
+	psg->register_latch = state->register_latch;
+	memcpy(psg->regs, state->regs, sizeof(psg->regs));
+	psg->last_enable = state->last_enable;
+	memcpy(psg->count, state->count, sizeof(psg->count));
+	memcpy(psg->output, state->output, sizeof(psg->output));
+	psg->prescale_noise = state->prescale_noise;
+	psg->count_noise = state->count_noise;
+	psg->count_env = state->count_env;
+	psg->env_step = state->env_step;
+	psg->env_volume = state->env_volume;
+	psg->hold = state->hold;
+	psg->alternate = state->alternate;
+	psg->attack = state->attack;
+	psg->holding = state->holding;
+	psg->rng = state->rng;
+	memcpy(psg->vol_enabled, state->vol_enabled, sizeof(psg->vol_enabled));
+	
+	return;
+}
+
 void ay8910_set_mute_mask(void *chip, UINT32 MuteMask)
 {
 	ay8910_context *psg = (ay8910_context *)chip;
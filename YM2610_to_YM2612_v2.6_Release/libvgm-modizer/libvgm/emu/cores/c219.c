@@ -298,6 +298,7 @@ static void c219_fetch_sample(c219_state *chip, UINT32 vid)
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
+#include "../modizer_voices.h"
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -312,18 +313,12 @@ static void c219_update(void *param, UINT32 samples, DEV_SMPL **outputs)
     //search first voice linked to current chip
     int m_voice_ofs=-1;
     int m_total_channels=MAX_VOICE;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
-    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/chip->sample_rate;//m_voice_current_samplerate;
+    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/chip->sample_rate;//mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
     
     //YOYOFR
@@ -215,6 +215,7 @@ static void c352_ramp_volume(C352_Voice* v,int ch,UINT8 val)
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
+#include "../modizer_voices.h"
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -232,18 +233,12 @@ static void c352_update(void *chip, UINT32 samples, DEV_SMPL **outputs)
     //search first voice linked to current chip
     int m_voice_ofs=-1;
     int m_total_channels=C352_VOICES;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
-    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/(c->sample_rate_base);//m_voice_current_samplerate;
+    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/(c->sample_rate_base);//mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
 
 	memset(outputs[0], 0, samples * sizeof(DEV_SMPL));
@@ -43,6 +43,7 @@
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
+#include "../modizer_voices.h"
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -58,6 +59,8 @@ static DEVDEF_RWFUNC devFunc[] =
 	{RWF_SRATE | RWF_WRITE, DEVRW_VALUE, 0, EPSG_set_rate},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, EPSG_setMuteMask},
 	{RWF_CHN_PAN | RWF_WRITE, DEVRW_ALL, 0, ay8910_emu_pan},
+	{RWF_STATE | RWF_READ, DEVRW_ALL, 0, EPSG_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_ALL, 0, EPSG_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 DEV_DEF devDef_YM2149_Emu =
@@ -324,6 +327,53 @@ EPSG_reset (EPSG * psg)
 
 }
 
+/* state snapshot: a copy of the EPSG struct, loading it takes only the
+   sound generator state (clock, rate, volume mode, masks and panning stay) */
+UINT32
+EPSG_save_state (EPSG * psg, void *buffer)
+{
+  if (buffer != NULL)
+    memcpy (buffer, psg, sizeof (EPSG));
+  return sizeof (EPSG);
+}
+
+void
+EPSG_load_state (EPSG * psg, const void *buffer)
+{
+  const EPSG *state = (const EPSG *) buffer;
+
+  memcpy (psg->reg, state->reg, sizeof (psg->reg));
+  memcpy (psg->count, state->count, sizeof (psg->count));
+  memcpy (psg->volume, state->volume, sizeof (psg->volume));
+  memcpy (psg->freq, state->freq, sizeof (psg->freq));
+  memcpy (psg->edge, state->edge, sizeof (psg->edge));
+  memcpy (psg->tmask, state->tmask, sizeof (psg->tmask));
+  memcpy (psg->nmask, state->nmask, sizeof (psg->nmask));
+  psg->pcm3ch = state->pcm3ch;
+  psg->base_count = state->base_count;
+
+  psg->env_ptr = state->env_ptr;
+  psg->env_face = state->env_face;
+  psg->env_continue = state->env_continue;
+  psg->env_attack = state->env_attack;
+  psg->env_alternate = state->env_alternate;
+  psg->env_hold = state->env_hold;
+  psg->env_pause = state->env_pause;
+  psg->env_freq = state->env_freq;
+  psg->env_count = state->env_count;
+
+  psg->noise_seed = state->noise_seed;
+  psg->noise_count = state->noise_count;
+  psg->noise_freq = state->noise_freq;
+
+  psg->psgtime = state->psgtime;
+  memcpy (psg->sprev, state->sprev, sizeof (psg->sprev));
+  memcpy (psg->snext, state->snext, sizeof (psg->snext));
+
+  psg->adr = state->adr;
+  memcpy (psg->ch_out, state->ch_out, sizeof (psg->ch_out));
+}
+
 void
 EPSG_delete (EPSG * psg)
 {
@@ -506,18 +556,12 @@ EPSG_calc_stereo (EPSG * psg, UINT32 samples, DEV_SMPL **out)
     //search first voice linked to current chip
     int m_voice_ofs=-1;
     int m_total_channels=4;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
-    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
 
     //YOYOFR
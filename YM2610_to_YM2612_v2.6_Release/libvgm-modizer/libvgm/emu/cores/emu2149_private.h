@@ -98,6 +98,8 @@ extern "C"
   void EPSG_setMuteMask (EPSG *, UINT32 mask);
   void EPSG_setStereoMask (EPSG *psg, UINT32 mask);
   void EPSG_set_pan (EPSG * psg, uint8_t ch, int16_t pan);
+  UINT32 EPSG_save_state (EPSG * psg, void *buffer);
+  void EPSG_load_state (EPSG * psg, const void *buffer);
   static void ay8910_emu_set_options(void *chip, UINT32 Flags);
   static void ay8910_emu_pan(void* chip, const INT16* PanVals);
     
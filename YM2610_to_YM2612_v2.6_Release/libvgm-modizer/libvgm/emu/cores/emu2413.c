@@ -27,8 +27,9 @@
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
-static int64_t smplIncr;
-static int m_voice_ofs;
+#include "../modizer_voices.h"
+static MZV_THREAD_LOCAL int64_t smplIncr;
+static MZV_THREAD_LOCAL int m_voice_ofs;
 static int m_total_channels;
 //TODO:  MODIZER changes end / YOYOFR
 
@@ -1098,6 +1099,7 @@ INLINE static void mix_output_stereo(EOPLL *opll) {
   out[0] = out[1] = 0;
   for (i = 0; i < 14; i++) {
       
+#ifndef MODIZER_NO_OSCILLO
       //YOYOFR
       /* 0..8:tone 9:bd 10:hh 11:sd 12:tom 13:cym */
       int jj=i;
@@ -1109,12 +1111,14 @@ INLINE static void mix_output_stereo(EOPLL *opll) {
       else if (i==12) jj=8;
       else if (i==13) jj=8;
       //YOYOFR
+#endif
       
     if (opll->pan[i] & 2)
       out[0] += APPLY_PANNING_S(opll->ch_out[i], opll->pan_fine[i][0]);
     if (opll->pan[i] & 1)
       out[1] += APPLY_PANNING_S(opll->ch_out[i], opll->pan_fine[i][1]);
       
+#ifndef MODIZER_NO_OSCILLO
       //YOYOFR
       if ((m_voice_ofs>=0)&&(jj<m_total_channels)&&(jj>=0)) {
           
@@ -1143,19 +1147,23 @@ INLINE static void mix_output_stereo(EOPLL *opll) {
           }
       }
       //YOYOFR
+#endif
   }
   if (opll->conv) {
     EOPLL_RateConv_putData(opll->conv, 0, out[0]);
     EOPLL_RateConv_putData(opll->conv, 1, out[1]);
   }
     
+#ifndef MODIZER_NO_OSCILLO
     //YOYOFR
+    if (m_voice_ofs>=0)
     for (int jj = 0; jj < 9; jj++) {
         int64_t ofs_end=(m_voice_current_ptr[m_voice_ofs+jj]+smplIncr);
         while ((ofs_end>>MODIZER_OSCILLO_OFFSET_FIXEDPOINT)>=SOUND_BUFFER_SIZE_SAMPLE*4*2) ofs_end-=(SOUND_BUFFER_SIZE_SAMPLE*4*2<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT);
         m_voice_current_ptr[m_voice_ofs+jj]=ofs_end;
     }
     //YOYOFR
+#endif
 }
 
 /***********************************************************
@@ -1638,26 +1646,21 @@ static void ym2413_update_emu(void *chip, UINT32 samples, DEV_SMPL **out)
 	int32_t buffers[2];
 	uint32_t i;
     
+#ifndef MODIZER_NO_OSCILLO
     //TODO:  MODIZER changes start / YOYOFR
     //search first voice linked to current chip
     m_voice_ofs=-1;
     m_total_channels=(vgmVRC7?6:9);
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
-    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
     
     //YOYOFR
-    static INT32 old_out_fm[9]; //YOYOFR
+    static MZV_THREAD_LOCAL INT32 old_out_fm[9]; //YOYOFR
     if (m_voice_ofs>=0) {
         for (int ii=0;ii<9;ii++) {
             int64_t freq;
@@ -1749,6 +1752,7 @@ static void ym2413_update_emu(void *chip, UINT32 samples, DEV_SMPL **out)
         }
     }
     //YOYOFR
+#endif
 	
 	for (i=0; i < samples; i++)
 	{
@@ -50,6 +50,7 @@
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
+#include "../modizer_voices.h"
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -246,19 +247,13 @@ static void es5503_pcm_update(void *param, UINT32 samples, DEV_SMPL **outputs)
     //search first voice linked to current chip
     int64_t m_voice_ofs=-1;
     int m_total_channels=32;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    m_voice_current_samplerate=es5503_get_sample_rate(chip);
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
+    mzv_ctx->samplerate=es5503_get_sample_rate(chip);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
-    int smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    int smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
 
 	memset(outputs[0], 0, samples * sizeof(DEV_SMPL));
@@ -386,7 +381,7 @@ static void es5503_pcm_update(void *param, UINT32 samples, DEV_SMPL **outputs)
             ES5503Osc *pOsc = &chip->oscillators[v];
             int j=v;
             if (!pOsc->Muted && pOsc->vol && (pOsc->freq>0)) {
-                double freq=(double)(pOsc->freq)*(double)m_voice_current_samplerate/(1<<(17+pOsc->wavetblsize));
+                double freq=(double)(pOsc->freq)*(double)mzv_ctx->samplerate/(1<<(17+pOsc->wavetblsize));
                 vgm_last_note[j+m_voice_ofs]=freq;
                 vgm_last_vol[j+m_voice_ofs]=1;
                 vgm_last_instr[j+m_voice_ofs]=j+m_voice_ofs;
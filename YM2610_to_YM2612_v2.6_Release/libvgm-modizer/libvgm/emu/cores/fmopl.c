@@ -82,7 +82,8 @@ Revision History:
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
-static int64_t smplIncr,cur_channel,m_voice_ofs;
+#include "../modizer_voices.h"
+static MZV_THREAD_LOCAL int64_t smplIncr,cur_channel,m_voice_ofs;
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -607,7 +608,7 @@ static int num_lock = 0;
 
 
 
-static UINT8 tablesInit = 0;
+static EMU_ONCE tablesInit = EMU_ONCE_INIT;
 
 /* status set and IRQ handling */
 INLINE void OPL_STATUS_SET(FM_OPL *OPL,int flag)
@@ -893,6 +894,7 @@ INLINE signed int op_calc1(UINT32 phase, unsigned int env, signed int pm, unsign
 }
 
 //TODO:  MODIZER changes start / YOYOFR
+#ifndef MODIZER_NO_OSCILLO
 #define MDZ_OUTPUT(val,channel) \
 if (m_voice_ofs>=0) { \
     int64_t ofs_start=m_voice_current_ptr[m_voice_ofs+channel]; \
@@ -933,11 +935,18 @@ if (m_voice_ofs>=0) { \
 }
 
 #define MDZ_ADVANCE \
+if (m_voice_ofs>=0) \
 for (int ii=0;ii<m_total_channels;ii++) {\
 int64_t ofs_end=(m_voice_current_ptr[m_voice_ofs+ii]+smplIncr); \
 while ((ofs_end>>MODIZER_OSCILLO_OFFSET_FIXEDPOINT)>=SOUND_BUFFER_SIZE_SAMPLE*4*2) ofs_end-=(SOUND_BUFFER_SIZE_SAMPLE*4*2<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT); \
 m_voice_current_ptr[m_voice_ofs+ii]=ofs_end; \
 }
+#else
+#define MDZ_OUTPUT(val,channel) {}
+#define MDZ_OUTPUT_ADD(val,channel) {}
+#define MDZ_SKIP(channel) {}
+#define MDZ_ADVANCE
+#endif
 
 //TODO:  MODIZER changes end / YOYOFR
 
@@ -1240,9 +1249,8 @@ static int init_tables(void)
 	signed int n;
 	double o,m;
 
-	if (tablesInit)
+	if (! emu_once_begin(&tablesInit))
 		return 1;
-	tablesInit = 1;
 
 	for (x=0; x<TL_RES_LEN; x++)
 	{
@@ -1336,6 +1344,7 @@ static int init_tables(void)
 	/*logerror("FMOPL.C: ENV_QUIET= %08x (dec*8=%i)\n", ENV_QUIET, ENV_QUIET*8 );*/
 
 
+	emu_once_end(&tablesInit);
 	return 1;
 }
 
@@ -2164,26 +2173,21 @@ void ym3812_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
 		return;
 	}
     
+#ifndef MODIZER_NO_OSCILLO
     //TODO:  MODIZER changes start / YOYOFR
     //search first voice linked to current chip
     m_voice_ofs=-1;
     int m_total_channels=9;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
-    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
     
     //YOYOFR
-    static INT32 old_out_fm[9]; //YOYOFR
+    static MZV_THREAD_LOCAL INT32 old_out_fm[9]; //YOYOFR
     if (m_voice_ofs>=0) {
         for (int ii=0;ii<9;ii++) {
             if (!(OPL->P_CH[ii].Muted)) {
@@ -2212,6 +2216,7 @@ void ym3812_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
         }
     }
     //YOYOFR
+#endif
 
 	bufL = buffer[0];
 	bufR = buffer[1];
@@ -2363,26 +2368,21 @@ void ym3526_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
 		return;
 	}
     
+#ifndef MODIZER_NO_OSCILLO
     //TODO:  MODIZER changes start / YOYOFR
     //search first voice linked to current chip
     m_voice_ofs=-1;
     int m_total_channels=9;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
-    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
     
     //YOYOFR
-    static INT32 old_out_fm[9]; //YOYOFR
+    static MZV_THREAD_LOCAL INT32 old_out_fm[9]; //YOYOFR
     if (m_voice_ofs>=0) {
         for (int ii=0;ii<9;ii++) {
             if (!(OPL->P_CH[ii].Muted)) {
@@ -2411,6 +2411,7 @@ void ym3526_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
         }
     }
     //YOYOFR
+#endif
 	
 	bufL = buffer[0];
 	bufR = buffer[1];
@@ -2495,7 +2496,7 @@ void *y8950_init(UINT32 clock, UINT32 rate)
 		return NULL;
 	
 	Y8950->deltat->logger = &Y8950->logger;
-	Y8950->deltat->memory = NULL;
+	rommap_init(&Y8950->deltat->memory);
 	Y8950->deltat->memory_size = 0x00;
 	Y8950->deltat->memory_mask = 0x00;
 
@@ -2521,8 +2522,7 @@ void y8950_shutdown(void *chip)
 {
 	FM_OPL *Y8950 = (FM_OPL *)chip;
 	
-	free(Y8950->deltat->memory);
-	Y8950->deltat->memory = NULL;
+	rommap_free(&Y8950->deltat->memory);
 	
 	/* emulator shutdown */
 	OPLDestroy(Y8950);
@@ -2572,9 +2572,8 @@ void y8950_alloc_pcmrom(void* chip, UINT32 memsize)
 	
 	if (Y8950->deltat->memory_size == memsize)
 		return;
-	Y8950->deltat->memory = (UINT8*)realloc(Y8950->deltat->memory, memsize);
-	Y8950->deltat->memory_size = memsize;
-	memset(Y8950->deltat->memory, 0xFF, memsize);
+	rommap_alloc(&Y8950->deltat->memory, memsize);
+	Y8950->deltat->memory_size = Y8950->deltat->memory.size;
 	YM_DELTAT_calc_mem_mask(Y8950->deltat);
 	
 	return;
@@ -2584,12 +2583,7 @@ void y8950_write_pcmrom(void* chip, UINT32 offset, UINT32 length, const UINT8* d
 {
 	FM_OPL *Y8950 = (FM_OPL *)chip;
 	
-	if (offset > Y8950->deltat->memory_size)
-		return;
-	if (offset + length > Y8950->deltat->memory_size)
-		length = Y8950->deltat->memory_size - offset;
-	
-	memcpy(Y8950->deltat->memory + offset, data, length);
+	rommap_write(&Y8950->deltat->memory, offset, length, data);
 	
 	return;
 }
@@ -2616,26 +2610,21 @@ void y8950_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
 		return;
 	}
     
+#ifndef MODIZER_NO_OSCILLO
     //TODO:  MODIZER changes start / YOYOFR
     //search first voice linked to current chip
     m_voice_ofs=-1;
     int m_total_channels=10;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
-    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
     
     //YOYOFR
-    static INT32 old_out_fm[9]; //YOYOFR
+    static MZV_THREAD_LOCAL INT32 old_out_fm[9]; //YOYOFR
     if (m_voice_ofs>=0) {
         for (int ii=0;ii<9;ii++) {
             if (!(OPL->P_CH[ii].Muted)) {
@@ -2674,6 +2663,7 @@ void y8950_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
         }
     }
     //YOYOFR
+#endif
 	
 	bufL = buffer[0];
 	bufR = buffer[1];
@@ -2721,6 +2711,7 @@ void y8950_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
 
 		lt = OPL->output[0] + (OPL->output_deltat[0]>>11);
         
+#ifndef MODIZER_NO_OSCILLO
         if (m_voice_ofs>=0) 
             if( DELTAT->portstate&0x80 && ! OPL->MuteSpc[5] ) {
                 int64_t ofs_start=m_voice_current_ptr[m_voice_ofs+9];
@@ -2732,6 +2723,7 @@ void y8950_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
                         if (ofs_start>=ofs_end) break;
                     }
             }
+#endif
 
         
 
@@ -168,6 +168,7 @@
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
+#include "../modizer_voices.h"
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -179,6 +180,7 @@
 #endif
 
 #include "fmopn.h"
+#include "opnintf.h"	// for ADPCMA_CACHE
 
 
 /* include external DELTA-T unit (when needed) */
@@ -241,12 +243,12 @@
 *   TL_RES_LEN - sinus resolution (X axis)
 */
 #define TL_TAB_LEN (13*2*TL_RES_LEN)
-static signed int tl_tab[TL_TAB_LEN];
 
-#define ENV_QUIET       (TL_TAB_LEN>>3)
+/* tl_tab, sin_tab (sin waveform in 'decibel' scale), lfo_pm_table and jedi_table,
+   generated by fmopn_tablegen.c */
+#include "fmopn_tables.h"
 
-/* sin waveform table in 'decibel' scale */
-static unsigned int sin_tab[SIN_LEN];
+#define ENV_QUIET       (TL_TAB_LEN>>3)
 
 /* sustain level table (3dB per step) */
 /* bit0, bit1, bit2, bit3, bit4, bit5, bit6 */
@@ -444,102 +446,8 @@ static const UINT8 lfo_ams_depth_shift[4] = {8, 3, 1, 0};
 
 
 
-/*There are 8 different LFO PM depths available, they are:
-  0, 3.4, 6.7, 10, 14, 20, 40, 80 (cents)
-
-  Modulation level at each depth depends on F-NUMBER bits: 4,5,6,7,8,9,10
-  (bits 8,9,10 = FNUM MSB from OCT/FNUM register)
-
-  Here we store only first quarter (positive one) of full waveform.
-  Full table (lfo_pm_table) containing all 128 waveforms is build
-  at run (init) time.
-
-  One value in table below represents 4 (four) basic LFO steps
-  (1 PM step = 4 AM steps).
-
-  For example:
-   at LFO SPEED=0 (which is 108 samples per basic LFO step)
-   one value from "lfo_pm_output" table lasts for 432 consecutive
-   samples (4*108=432) and one full LFO waveform cycle lasts for 13824
-   samples (32*432=13824; 32 because we store only a quarter of whole
-            waveform in the table below)
-*/
-static const UINT8 lfo_pm_output[7*8][8]={
-/* 7 bits meaningful (of F-NUMBER), 8 LFO output levels per one depth (out of 32), 8 LFO depths */
-/* FNUM BIT 4: 000 0001xxxx */
-/* DEPTH 0 */ {0,   0,   0,   0,   0,   0,   0,   0},
-/* DEPTH 1 */ {0,   0,   0,   0,   0,   0,   0,   0},
-/* DEPTH 2 */ {0,   0,   0,   0,   0,   0,   0,   0},
-/* DEPTH 3 */ {0,   0,   0,   0,   0,   0,   0,   0},
-/* DEPTH 4 */ {0,   0,   0,   0,   0,   0,   0,   0},
-/* DEPTH 5 */ {0,   0,   0,   0,   0,   0,   0,   0},
-/* DEPTH 6 */ {0,   0,   0,   0,   0,   0,   0,   0},
-/* DEPTH 7 */ {0,   0,   0,   0,   1,   1,   1,   1},
-
-/* FNUM BIT 5: 000 0010xxxx */
-/* DEPTH 0 */ {0,   0,   0,   0,   0,   0,   0,   0},
-/* DEPTH 1 */ {0,   0,   0,   0,   0,   0,   0,   0},
-/* DEPTH 2 */ {0,   0,   0,   0,   0,   0,   0,   0},
-/* DEPTH 3 */ {0,   0,   0,   0,   0,   0,   0,   0},
-/* DEPTH 4 */ {0,   0,   0,   0,   0,   0,   0,   0},
-/* DEPTH 5 */ {0,   0,   0,   0,   0,   0,   0,   0},
-/* DEPTH 6 */ {0,   0,   0,   0,   1,   1,   1,   1},
-/* DEPTH 7 */ {0,   0,   1,   1,   2,   2,   2,   3},
-
-/* FNUM BIT 6: 000 0100xxxx */
-/* DEPTH 0 */ {0,   0,   0,   0,   0,   0,   0,   0},
-/* DEPTH 1 */ {0,   0,   0,   0,   0,   0,   0,   0},
-/* DEPTH 2 */ {0,   0,   0,   0,   0,   0,   0,   0},
-/* DEPTH 3 */ {0,   0,   0,   0,   0,   0,   0,   0},
-/* DEPTH 4 */ {0,   0,   0,   0,   0,   0,   0,   1},
-/* DEPTH 5 */ {0,   0,   0,   0,   1,   1,   1,   1},
-/* DEPTH 6 */ {0,   0,   1,   1,   2,   2,   2,   3},
-/* DEPTH 7 */ {0,   0,   2,   3,   4,   4,   5,   6},
-
-/* FNUM BIT 7: 000 1000xxxx */
-/* DEPTH 0 */ {0,   0,   0,   0,   0,   0,   0,   0},
-/* DEPTH 1 */ {0,   0,   0,   0,   0,   0,   0,   0},
-/* DEPTH 2 */ {0,   0,   0,   0,   0,   0,   1,   1},
-/* DEPTH 3 */ {0,   0,   0,   0,   1,   1,   1,   1},
-/* DEPTH 4 */ {0,   0,   0,   1,   1,   1,   1,   2},
-/* DEPTH 5 */ {0,   0,   1,   1,   2,   2,   2,   3},
-/* DEPTH 6 */ {0,   0,   2,   3,   4,   4,   5,   6},
-/* DEPTH 7 */ {0,   0,   4,   6,   8,   8, 0xa, 0xc},
-
-/* FNUM BIT 8: 001 0000xxxx */
-/* DEPTH 0 */ {0,   0,   0,   0,   0,   0,   0,   0},
-/* DEPTH 1 */ {0,   0,   0,   0,   1,   1,   1,   1},
-/* DEPTH 2 */ {0,   0,   0,   1,   1,   1,   2,   2},
-/* DEPTH 3 */ {0,   0,   1,   1,   2,   2,   3,   3},
-/* DEPTH 4 */ {0,   0,   1,   2,   2,   2,   3,   4},
-/* DEPTH 5 */ {0,   0,   2,   3,   4,   4,   5,   6},
-/* DEPTH 6 */ {0,   0,   4,   6,   8,   8, 0xa, 0xc},
-/* DEPTH 7 */ {0,   0,   8, 0xc,0x10,0x10,0x14,0x18},
-
-/* FNUM BIT 9: 010 0000xxxx */
-/* DEPTH 0 */ {0,   0,   0,   0,   0,   0,   0,   0},
-/* DEPTH 1 */ {0,   0,   0,   0,   2,   2,   2,   2},
-/* DEPTH 2 */ {0,   0,   0,   2,   2,   2,   4,   4},
-/* DEPTH 3 */ {0,   0,   2,   2,   4,   4,   6,   6},
-/* DEPTH 4 */ {0,   0,   2,   4,   4,   4,   6,   8},
-/* DEPTH 5 */ {0,   0,   4,   6,   8,   8, 0xa, 0xc},
-/* DEPTH 6 */ {0,   0,   8, 0xc,0x10,0x10,0x14,0x18},
-/* DEPTH 7 */ {0,   0,0x10,0x18,0x20,0x20,0x28,0x30},
-
-/* FNUM BIT10: 100 0000xxxx */
-/* DEPTH 0 */ {0,   0,   0,   0,   0,   0,   0,   0},
-/* DEPTH 1 */ {0,   0,   0,   0,   4,   4,   4,   4},
-/* DEPTH 2 */ {0,   0,   0,   4,   4,   4,   8,   8},
-/* DEPTH 3 */ {0,   0,   4,   4,   8,   8, 0xc, 0xc},
-/* DEPTH 4 */ {0,   0,   4,   8,   8,   8, 0xc,0x10},
-/* DEPTH 5 */ {0,   0,   8, 0xc,0x10,0x10,0x14,0x18},
-/* DEPTH 6 */ {0,   0,0x10,0x18,0x20,0x20,0x28,0x30},
-/* DEPTH 7 */ {0,   0,0x20,0x30,0x40,0x40,0x50,0x60},
-
-};
-
-/* all 128 LFO PM waveforms */
-static INT32 lfo_pm_table[128*8*32]; /* 128 combinations of 7 bits meaningful (of F-NUMBER), 8 LFO depths, 32 LFO output levels per one depth */
+/* LFO PM: lfo_pm_table holds all 128 waveforms (128 combinations of 7 bits meaningful (of F-NUMBER),
+   8 LFO depths, 32 LFO output levels per one depth), see fmopn_tablegen.c */
 
 /* register number to channel number , slot offset */
 #define OPN_CHAN(N) (N&3)
@@ -707,6 +615,9 @@ typedef struct
 	INT32   mem;            /* one sample delay memory */
 
 	INT32   out_fm[6];      /* outputs of working channels */
+	INT32   old_out_fm[6];  /* outputs of the previous update (MODIZER note tracking) */ //YOYOFR
+	UINT8   old_dacen;      //YOYOFR
+	INT32   old_out_fm_2610[4]; /* same for the YM2610's 4 FM channels (ym2610_update_one) */ //YOYOFR
 
 #if (BUILD_YM2608||BUILD_YM2610||BUILD_YM2610B)
 	INT32   out_adpcm[4];   /* channel output NONE,LEFT,RIGHT or CENTER for YM2608/YM2610 ADPCM */
@@ -737,8 +648,6 @@ typedef struct
 }
 
 
-static UINT8 tablesInit = 0;
-
 /* status set and IRQ handling */
 INLINE void FM_STATUS_SET(FM_ST *ST,int flag)
 {
@@ -2119,127 +2028,6 @@ static void reset_channels( FM_ST *ST , FM_CH *CH , int num )
 	}
 }
 
-/* initialize generic tables */
-static void init_tables(void)
-{
-	signed int i,x;
-	signed int n;
-	double o,m;
-
-	if (tablesInit)
-		return;
-	tablesInit = 1;
-
-	/* build Linear Power Table */
-	for (x=0; x<TL_RES_LEN; x++)
-	{
-		m = (1<<16) / pow(2, (x+1) * (ENV_STEP/4.0) / 8.0);
-		m = floor(m);
-
-		/* we never reach (1<<16) here due to the (x+1) */
-		/* result fits within 16 bits at maximum */
-
-		n = (int)m;     /* 16 bits here */
-		n >>= 4;        /* 12 bits here */
-		if (n&1)        /* round to nearest */
-			n = (n>>1)+1;
-		else
-			n = n>>1;
-						/* 11 bits here (rounded) */
-		n <<= 2;        /* 13 bits here (as in real chip) */
-
-
-		/* 14 bits (with sign bit) */
-		tl_tab[ x*2 + 0 ] = n;
-		tl_tab[ x*2 + 1 ] = -tl_tab[ x*2 + 0 ];
-
-		/* one entry in the 'Power' table use the following format, xxxxxyyyyyyyys with:            */
-		/*        s = sign bit                                                                      */
-		/* yyyyyyyy = 8-bits decimal part (0-TL_RES_LEN)                                            */
-		/* xxxxx    = 5-bits integer 'shift' value (0-31) but, since Power table output is 13 bits, */
-		/*            any value above 13 (included) would be discarded.                             */
-		for (i=1; i<13; i++)
-		{
-			tl_tab[ x*2+0 + i*2*TL_RES_LEN ] =  tl_tab[ x*2+0 ]>>i;
-			tl_tab[ x*2+1 + i*2*TL_RES_LEN ] = -tl_tab[ x*2+0 + i*2*TL_RES_LEN ];
-		}
-#if 0
-		logerror("tl %04i", x);
-		for (i=0; i<13; i++)
-			logerror(", [%02i] %4x", i*2, tl_tab[ x*2 /*+1*/ + i*2*TL_RES_LEN ]);
-		logerror("\n");
-#endif
-	}
-	/*logerror("FM.C: TL_TAB_LEN = %i elements (%i bytes)\n",TL_TAB_LEN, (int)sizeof(tl_tab));*/
-
-
-	/* build Logarithmic Sinus table */
-	for (i=0; i<SIN_LEN; i++)
-	{
-		/* non-standard sinus */
-		m = sin( ((i*2)+1) * M_PI / SIN_LEN ); /* checked against the real chip */
-		/* we never reach zero here due to ((i*2)+1) */
-
-		if (m>0.0)
-			o = 8*log(1.0/m)/log(2.0);  /* convert to 'decibels' */
-		else
-			o = 8*log(-1.0/m)/log(2.0); /* convert to 'decibels' */
-
-		o = o / (ENV_STEP/4);
-
-		n = (int)(2.0*o);
-		if (n&1)            /* round to nearest */
-			n = (n>>1)+1;
-		else
-			n = n>>1;
-
-		/* 13-bits (8.5) value is formatted for above 'Power' table */
-		sin_tab[ i ] = n*2 + (m>=0.0? 0: 1 );
-		/*logerror("FM.C: sin [%4i]= %4i (tl_tab value=%5i)\n", i, sin_tab[i],tl_tab[sin_tab[i]]);*/
-	}
-
-	/*logerror("FM.C: ENV_QUIET= %08x\n",ENV_QUIET );*/
-
-
-	/* build LFO PM modulation table */
-	for(i = 0; i < 8; i++) /* 8 PM depths */
-	{
-		UINT8 fnum;
-		for (fnum=0; fnum<128; fnum++) /* 7 bits meaningful of F-NUMBER */
-		{
-			UINT8 value;
-			UINT8 step;
-			UINT32 offset_depth = i;
-			UINT32 offset_fnum_bit;
-			UINT32 bit_tmp;
-
-			for (step=0; step<8; step++)
-			{
-				value = 0;
-				for (bit_tmp=0; bit_tmp<7; bit_tmp++) /* 7 bits */
-				{
-					if (fnum & (1<<bit_tmp)) /* only if bit "bit_tmp" is set */
-					{
-						offset_fnum_bit = bit_tmp * 8;
-						value += lfo_pm_output[offset_fnum_bit + offset_depth][step];
-					}
-				}
-				/* 32 steps for LFO PM (sinus) */
-				lfo_pm_table[(fnum*32*8) + (i*32) + step   + 0] = value;
-				lfo_pm_table[(fnum*32*8) + (i*32) +(step^7)+ 8] = value;
-				lfo_pm_table[(fnum*32*8) + (i*32) + step   +16] = -value;
-				lfo_pm_table[(fnum*32*8) + (i*32) +(step^7)+24] = -value;
-			}
-#if 0
-			logerror("LFO depth=%1x FNUM=%04x (<<4=%4x): ", i, fnum, fnum<<4);
-			for (step=0; step<16; step++) /* dump only positive part of waveforms */
-				logerror("%02x ", lfo_pm_table[(fnum*32*8) + (i*32) + step] );
-			logerror("\n");
-#endif
-
-		}
-	}
-}
 
 #endif /* BUILD_OPN */
 
@@ -2361,6 +2149,42 @@ static void OPNSetSmplRateChgCallback(FM_OPN *OPN, DEVCB_SRATE_CHG cbFunc, void*
 	return;
 }
 
+/* chip settings that are kept when loading a state snapshot */
+typedef struct
+{
+	UINT8   LegacyMode;
+	DEVCB_SRATE_CHG smpRateFunc;
+	void*   smpRateData;
+	DEV_LOGGER logger;
+	UINT8   Muted[6];
+} OPN_SETTINGS;
+
+static void OPNGetSettings(const FM_OPN *OPN, const FM_CH *CH, OPN_SETTINGS *set)
+{
+	UINT8 c;
+	
+	set->LegacyMode = OPN->LegacyMode;
+	set->smpRateFunc = OPN->smpRateFunc;
+	set->smpRateData = OPN->smpRateData;
+	set->logger = OPN->logger;
+	for (c = 0; c < 6; c ++)
+		set->Muted[c] = CH[c].Muted;
+	return;
+}
+
+static void OPNSetSettings(FM_OPN *OPN, FM_CH *CH, const OPN_SETTINGS *set)
+{
+	UINT8 c;
+	
+	OPN->LegacyMode = set->LegacyMode;
+	OPN->smpRateFunc = set->smpRateFunc;
+	OPN->smpRateData = set->smpRateData;
+	OPN->logger = set->logger;
+	for (c = 0; c < 6; c ++)
+		CH[c].Muted = set->Muted[c];
+	return;
+}
+
 
 #if BUILD_YM2203
 /*****************************************************************************/
@@ -2404,29 +2228,22 @@ void ym2203_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
     int m_voice_ofs=-1;
     int m_total_channels=3;
     if (length)
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
     //printf("opn:%d / %lf delta:%lf\n",OPN->ST.rate,OPN->ST.freqbase,DELTAT->freqbase);
     int64_t smplIncr;
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
-    if (length) smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    if (length) smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
     
     //YOYOFR
-    static INT32 old_out_fm[3]; //YOYOFR
     if (m_voice_ofs>=0) {
         for (int ii=0;ii<3;ii++) {
             if (!(cch[ii]->Muted)) {
                 if (cch[ii]->block_fnum==0) {
-                    if ((OPN->out_fm[ii]!=old_out_fm[ii])) {
+                    if ((OPN->out_fm[ii]!=OPN->old_out_fm[ii])) {
                         vgm_last_note[ii+m_voice_ofs]=220.0f; //arbitrary choosing A-3
                         vgm_last_instr[ii+m_voice_ofs]=ii+m_voice_ofs;
                         int newvol=cch[ii]->keyonff_triggered+1;
@@ -2434,7 +2251,7 @@ void ym2203_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
                         if (vgm_last_vol[ii+m_voice_ofs]<newvol) vgm_last_vol[ii+m_voice_ofs]=newvol;
                     }
                 } else {
-                    if ((OPN->out_fm[ii]!=old_out_fm[ii])) {
+                    if ((OPN->out_fm[ii]!=OPN->old_out_fm[ii])) {
                         int freq=(cch[ii]->block_fnum)&0x7FF;
                         int octave=((cch[ii]->block_fnum)>>11)&0x7;
                         vgm_last_note[ii+m_voice_ofs]=(freq<<octave)*110.0f/1081.0f; //1148.0f;
@@ -2445,7 +2262,7 @@ void ym2203_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
                     }
                 }
             }
-            old_out_fm[ii]=OPN->out_fm[ii];
+            OPN->old_out_fm[ii]=OPN->out_fm[ii];
         }
     }
     //YOYOFR
@@ -2617,9 +2434,6 @@ void * ym2203_init(void *param, UINT32 clock, UINT32 rate,
 	if( F2203==NULL)
 		return NULL;
 
-	/* allocate total level table (128kb space) */
-	init_tables();
-
 	F2203->OPN.ST.param = param;
 	F2203->OPN.type = TYPE_YM2203;
 	F2203->OPN.P_CH = F2203->CH;
@@ -2769,6 +2583,35 @@ void ym2203_set_log_cb(void* chip, DEVCB_LOG func, void* param)
 
 #if (BUILD_YM2608||BUILD_YM2610||BUILD_YM2610B)
 
+/* ADPCM type A decoded sample (YM2610 sample cache) */
+typedef struct _adpcma_cache_entry ADPCMA_CACHE_ENTRY;
+struct _adpcma_cache_entry
+{
+	UINT32      start;          /* start address (key)      */
+	UINT32      end;            /* end address (key)        */
+	UINT8       usable;         /* 0 = region can't be cached, decode live */
+	UINT32      length;         /* nibbles up to the end address */
+	INT16       *acc;           /* accumulator after each nibble */
+	UINT8       *rom;           /* ROM bytes the region was decoded from */
+	UINT32      romGen;         /* cache ROM generation the bytes were last checked in */
+	ADPCMA_CACHE_ENTRY *next;
+};
+#define ADPCMA_CACHE_BUCKETS 64
+#define ADPCMA_CACHE_MAXLEN  (1<<21)    /* nibbles, regions longer than this decode live */
+#define ADPCMA_CACHE_MAXENTRIES 1024    /* the cache starts over when it holds this many regions */
+#define ADPCMA_CACHE_MAXTOTAL (1<<24)   /* ... or this many decoded nibbles (32 MB) */
+
+/* ADPCM type A sample cache of one YM2610, or shared by several that run one after another */
+struct _adpcma_cache
+{
+	ADPCMA_CACHE_ENTRY *bucket[ADPCMA_CACHE_BUCKETS];
+	UINT32      entries;        /* regions in the cache */
+	UINT32      total;          /* decoded nibbles in the cache */
+	UINT32      romGen;         /* changes with the ROM of the chip using the cache */
+	UINT32      decoded;        /* regions decoded */
+	UINT32      reused;         /* regions kept over a ROM change (same ROM bytes) */
+};
+
 /* ADPCM type A channel struct */
 typedef struct
 {
@@ -2788,6 +2631,8 @@ typedef struct
 	UINT8       vol_shift;      /* volume in "-6dB" steps   */
 	INT32       *pan;           /* &out_adpcm[OPN_xxxx]     */
 	UINT8       Muted;
+	const ADPCMA_CACHE_ENTRY *cache;    /* decoded sample being played, NULL = decode live */
+	UINT32      cache_pos;      /* nibbles played from the cache */
 } ADPCM_CH;
 
 /* here's the virtual YM2610 */
@@ -2801,7 +2646,7 @@ typedef struct
 	UINT8       addr_A1;            /* address line A1      */
 
 	/* ADPCM-A unit */
-	UINT8       *pcmbuf;            /* pcm rom buffer       */
+	ROM_MAP     pcmrom;             /* pcm rom              */
 	UINT32      pcm_size;           /* size of pcm rom      */
 	UINT8       adpcmTL;            /* adpcmA total level   */
 	ADPCM_CH    adpcm[6];           /* adpcm channels       */
@@ -2809,6 +2654,10 @@ typedef struct
 	UINT8       adpcm_arrivedEndAddress;
 	YM_DELTAT   deltaT;             /* Delta-T ADPCM unit   */
 	UINT8       MuteDeltaT;
+	UINT8       PCMOnly;            /* skip FM emulation (YM2610 only) */
+	UINT8       ADPCMACache;        /* play ADPCM-A from acache (YM2610 only) */
+	ADPCMA_CACHE *acache;           /* ADPCM-A sample cache, NULL = not created yet */
+	UINT8       acache_own;         /* acache belongs to this chip (not shared) */
 
 	UINT8       flagmask;           /* YM2608 only */
 	UINT8       irqmask;            /* YM2608 only */
@@ -2821,48 +2670,267 @@ typedef YM2610 YM2608;
 /**** YM2610 ADPCM defines ****/
 #define ADPCM_SHIFT    (16)      /* frequency step rate   */
 #define ADPCMA_ADDRESS_SHIFT 8   /* adpcm A address shift */
+#define YM2610_DELTAT_BLOCK 256  /* ADPCM-B samples decoded per YM_DELTAT_ADPCM_CALC_BLOCK call (power of 2) */
 
 /* Algorithm and tables verified on real YM2608 and YM2610 */
-
-/* usual ADPCM table (16 * 1.1^N) */
-static const int steps[49] =
-{
-	 16,  17,   19,   21,   23,   25,   28,
-	 31,  34,   37,   41,   45,   50,   55,
-	 60,  66,   73,   80,   88,   97,  107,
-	118, 130,  143,  157,  173,  190,  209,
-	230, 253,  279,  307,  337,  371,  408,
-	449, 494,  544,  598,  658,  724,  796,
-	876, 963, 1060, 1166, 1282, 1411, 1552
-};
+/* (jedi_table is in fmopn_tables.h, built from the usual ADPCM step table by fmopn_tablegen.c) */
 
 /* different from the usual ADPCM table */
 static const int step_inc[8] = { -1*16, -1*16, -1*16, -1*16, 2*16, 5*16, 7*16, 9*16 };
 
-/* speedup purposes only */
-static int jedi_table[ 49*16 ];
 
+/* ADPCM A : end address reached? (lower 20 bits only, the 4 MSB bits are sample bank) */
+#define ADPCMA_AT_END(ch, end_addr) \
+	(((ch)->now_addr & ((1<<21)-1)) == (((end_addr)<<1) & ((1<<21)-1)))
+
+/* ADPCM A : decode the next nibble into the accumulator */
+INLINE void ADPCMA_decode_nibble( YM2610 *F2610, ADPCM_CH *ch )
+{
+	UINT8  data;
+
+	if ( ch->now_addr&1 )
+		data = ch->now_data & 0x0f;
+	else
+	{
+		ch->now_data = ROMMAP_READ(&F2610->pcmrom, ch->now_addr>>1);
+		data = (ch->now_data >> 4) & 0x0f;
+	}
+
+	ch->now_addr++;
+
+	ch->adpcm_acc += jedi_table[ch->adpcm_step + data];
+
+	/* the 12-bit accumulator wraps on the ym2610 and ym2608 (like the msm5205), it does not saturate (like the msm5218) */
+	ch->adpcm_acc &= 0xfff;
+
+	/* extend 12-bit signed int */
+	if (ch->adpcm_acc & 0x800)
+		ch->adpcm_acc |= ~0xfff;
+
+	ch->adpcm_step += step_inc[data & 7];
+	Limit( ch->adpcm_step, 48*16, 0*16 );
+}
+
+/* ADPCM A : decode a start/end region for the sample cache */
+static void ADPCMA_cache_decode( YM2610 *F2610, ADPCMA_CACHE_ENTRY *entry )
+{
+	ADPCM_CH ch;
+	UINT32 alloc = 0;
+
+	free(entry->acc);
+	free(entry->rom);
+	memset(&ch, 0, sizeof(ADPCM_CH));
+	ch.now_addr = entry->start<<1;
+	entry->usable = 0;
+	entry->length = 0;
+	entry->acc = NULL;
+	entry->rom = NULL;
+
+	while (! ADPCMA_AT_END(&ch, entry->end))
+	{
+		/* regions that run past the ROM (or practically forever) stay uncached */
+		if ((ch.now_addr>>1) >= F2610->pcm_size || entry->length >= ADPCMA_CACHE_MAXLEN)
+		{
+			free(entry->acc);
+			entry->acc = NULL;
+			entry->length = 0;
+			return;
+		}
+		if (entry->length >= alloc)
+		{
+			INT16 *newAcc;
+
+			alloc = alloc ? alloc * 2 : 0x1000;
+			newAcc = (INT16*)realloc(entry->acc, alloc * sizeof(INT16));
+			if (newAcc == NULL)
+			{
+				free(entry->acc);
+				entry->acc = NULL;
+				entry->length = 0;
+				return;
+			}
+			entry->acc = newAcc;
+		}
+		ADPCMA_decode_nibble(F2610, &ch);
+		entry->acc[entry->length++] = (INT16)ch.adpcm_acc;
+	}
+
+	/* keep the ROM bytes, so the region can be checked after a ROM change */
+	entry->rom = (UINT8*)malloc(((entry->length + 1) >> 1) + 1);
+	if (entry->rom == NULL)
+	{
+		free(entry->acc);
+		entry->acc = NULL;
+		entry->length = 0;
+		return;
+	}
+	rommap_read(&F2610->pcmrom, entry->start, (entry->length + 1) >> 1, entry->rom);
+	entry->usable = 1;
+}
+
+/* ADPCM A : does the ROM still hold the bytes a cached region was decoded from? */
+static UINT8 ADPCMA_cache_check( YM2610 *F2610, const ADPCMA_CACHE_ENTRY *entry )
+{
+	UINT32 bytes = (entry->length + 1) >> 1;
+
+	if (! entry->usable || bytes > F2610->pcm_size || entry->start > F2610->pcm_size - bytes)
+		return 0;
+	return ! rommap_compare(&F2610->pcmrom, entry->start, bytes, entry->rom);
+}
+
+/* ADPCM A : switch a channel that plays from the cache back to live decoding */
+static void ADPCMA_cache_detach( YM2610 *F2610, ADPCM_CH *ch )
+{
+	UINT32 pos;
+
+	if (ch->cache == NULL)
+		return;
+
+	if (! ch->flag)
+	{
+		/* stopped: only the address is left to restore, key-on resets the rest */
+		ch->now_addr = (ch->cache->start<<1) + ch->cache_pos;
+		ch->cache = NULL;
+		return;
+	}
+
+	/* replay the region up to the current position to restore the decoder state */
+	ch->now_addr   = ch->cache->start<<1;
+	ch->adpcm_acc  = 0;
+	ch->adpcm_step = 0;
+	for (pos = 0; pos < ch->cache_pos; pos ++)
+		ADPCMA_decode_nibble(F2610, ch);
+	ch->cache = NULL;
+}
+
+/* ADPCM A : switch all channels back to live decoding */
+static void ADPCMA_cache_detach_all( YM2610 *F2610 )
+{
+	int i;
 
-static void Init_ADPCMATable(void)
+	for (i = 0; i < 6; i++)
+		ADPCMA_cache_detach(F2610, &F2610->adpcm[i]);
+}
+
+/* ADPCM A : free all cached samples */
+static void ADPCMA_cache_clear( ADPCMA_CACHE *cache )
 {
-	int step, nib;
+	int i;
 
-	for (step = 0; step < 49; step++)
+	for (i = 0; i < ADPCMA_CACHE_BUCKETS; i++)
 	{
-		/* loop over all nibbles and compute the difference */
-		for (nib = 0; nib < 16; nib++)
+		while (cache->bucket[i] != NULL)
 		{
-			int value = (2*(nib & 0x07) + 1) * steps[step] / 8;
-			jedi_table[step*16 + nib] = (nib&0x08) ? -value : value;
+			ADPCMA_CACHE_ENTRY *entry = cache->bucket[i];
+			cache->bucket[i] = entry->next;
+			free(entry->acc);
+			free(entry->rom);
+			free(entry);
 		}
 	}
+	cache->entries = 0;
+	cache->total = 0;
+}
+
+/* ADPCM A : drop all cached samples */
+static void ADPCMA_cache_flush( YM2610 *F2610 )
+{
+	ADPCMA_cache_detach_all(F2610);
+	if (F2610->acache != NULL)
+		ADPCMA_cache_clear(F2610->acache);
+}
+
+/* ADPCM A : the ROM is about to change, cached samples are checked against it when they are used next */
+static void ADPCMA_cache_romchange( YM2610 *F2610 )
+{
+	ADPCMA_cache_detach_all(F2610);
+	if (F2610->acache != NULL)
+		F2610->acache->romGen ++;
+}
+
+/* ADPCM A : cached decode of start/end, decoding it on first use (NULL = out of memory) */
+static const ADPCMA_CACHE_ENTRY* ADPCMA_cache_get( YM2610 *F2610, UINT32 start, UINT32 end )
+{
+	UINT32 bucket = ((start >> ADPCMA_ADDRESS_SHIFT) ^ (end >> ADPCMA_ADDRESS_SHIFT)) % ADPCMA_CACHE_BUCKETS;
+	ADPCMA_CACHE *cache = F2610->acache;
+	ADPCMA_CACHE_ENTRY *entry;
+
+	if (cache == NULL)
+	{
+		cache = ym2610_adpcma_cache_create();
+		if (cache == NULL)
+			return NULL;
+		F2610->acache = cache;
+		F2610->acache_own = 1;
+	}
+
+	for (entry = cache->bucket[bucket]; entry != NULL; entry = entry->next)
+	{
+		if (entry->start != start || entry->end != end)
+			continue;
+		if (entry->romGen != cache->romGen)
+		{
+			/* decoded from an earlier ROM: keep it if its bytes did not change */
+			if (ADPCMA_cache_check(F2610, entry))
+			{
+				cache->reused ++;
+			}
+			else
+			{
+				cache->total -= entry->length;
+				ADPCMA_cache_decode(F2610, entry);
+				cache->total += entry->length;
+				cache->decoded ++;
+			}
+			entry->romGen = cache->romGen;
+		}
+		return entry;
+	}
+
+	/* a song that keeps playing new regions must not grow the cache without bound */
+	if (cache->entries >= ADPCMA_CACHE_MAXENTRIES || cache->total >= ADPCMA_CACHE_MAXTOTAL)
+		ADPCMA_cache_flush(F2610);
+
+	entry = (ADPCMA_CACHE_ENTRY*)malloc(sizeof(ADPCMA_CACHE_ENTRY));
+	if (entry == NULL)
+		return NULL;
+	entry->start = start;
+	entry->end = end;
+	entry->acc = NULL;
+	entry->rom = NULL;
+	ADPCMA_cache_decode(F2610, entry);
+	entry->romGen = cache->romGen;
+	entry->next = cache->bucket[bucket];
+	cache->bucket[bucket] = entry;
+	cache->entries ++;
+	cache->total += entry->length;
+	cache->decoded ++;
+	return entry;
+}
+
+ADPCMA_CACHE* ym2610_adpcma_cache_create(void)
+{
+	return (ADPCMA_CACHE*)calloc(1, sizeof(ADPCMA_CACHE));
+}
+
+void ym2610_adpcma_cache_free(ADPCMA_CACHE* cache)
+{
+	if (cache == NULL)
+		return;
+	ADPCMA_cache_clear(cache);
+	free(cache);
+}
+
+void ym2610_adpcma_cache_stats(const ADPCMA_CACHE* cache, UINT32* decoded, UINT32* reused)
+{
+	*decoded = cache->decoded;
+	*reused = cache->reused;
 }
 
 /* ADPCM A (Non control type) : calculate one channel output */
 INLINE void ADPCMA_calc_chan( YM2610 *F2610, ADPCM_CH *ch )
 {
 	UINT32 step;
-	UINT8  data;
 
 	if (ch->Muted)
 		return;
@@ -2873,13 +2941,28 @@ INLINE void ADPCMA_calc_chan( YM2610 *F2610, ADPCM_CH *ch )
 	{
 		step = ch->now_step >> ADPCM_SHIFT;
 		ch->now_step &= (1<<ADPCM_SHIFT)-1;
+		if (ch->cache != NULL)
+		{
+			/* cached: the end check happens before each nibble, as below */
+			if (ch->cache_pos + step > ch->cache->length)
+			{
+				ch->cache_pos = ch->cache->length;
+				ch->flag = 0;
+				F2610->adpcm_arrivedEndAddress |= ch->flagMask;
+				ADPCMA_cache_detach(F2610, ch);
+				return;
+			}
+			ch->cache_pos += step;
+			ch->adpcm_acc = ch->cache->acc[ch->cache_pos - 1];
+		}
+		else
 		do{
 			/* end check */
 			/* 11-06-2001 JB: corrected comparison. Was > instead of == */
 			/* YM2610 checks lower 20 bits only, the 4 MSB bits are sample bank */
 			/* Here we use 1<<21 to compensate for nibble calculations */
 
-			if (   (ch->now_addr & ((1<<21)-1)) == ((ch->end<<1) & ((1<<21)-1))	   )
+			if ( ADPCMA_AT_END(ch, ch->end) )
 			{
 				ch->flag = 0;
 				F2610->adpcm_arrivedEndAddress |= ch->flagMask;
@@ -2892,27 +2975,7 @@ INLINE void ADPCMA_calc_chan( YM2610 *F2610, ADPCM_CH *ch )
 				return;
 			}
 #endif
-			if ( ch->now_addr&1 )
-				data = ch->now_data & 0x0f;
-			else
-			{
-				ch->now_data = F2610->pcmbuf[ch->now_addr>>1];
-				data = (ch->now_data >> 4) & 0x0f;
-			}
-
-			ch->now_addr++;
-
-			ch->adpcm_acc += jedi_table[ch->adpcm_step + data];
-
-			/* the 12-bit accumulator wraps on the ym2610 and ym2608 (like the msm5205), it does not saturate (like the msm5218) */
-			ch->adpcm_acc &= 0xfff;
-
-			/* extend 12-bit signed int */
-			if (ch->adpcm_acc & 0x800)
-				ch->adpcm_acc |= ~0xfff;
-
-			ch->adpcm_step += step_inc[data & 7];
-			Limit( ch->adpcm_step, 48*16, 0*16 );
+			ADPCMA_decode_nibble(F2610, ch);
 
 		}while(--step);
 
@@ -2950,8 +3013,9 @@ static void FM_ADPCMAWrite(YM2610 *F2610,int r,int v)
 					adpcm[c].adpcm_step= 0;
 					adpcm[c].adpcm_out = 0;
 					adpcm[c].flag      = 1;
+					adpcm[c].cache     = NULL;
 
-					if(F2610->pcmbuf==NULL)
+					if(! F2610->pcm_size)
 					{                   /* Check ROM Mapped */
 						emu_logf(&F2610->OPN.logger, DEVLOG_WARN, "ADPCM-A rom not mapped\n");
 						adpcm[c].flag = 0;
@@ -2969,6 +3033,15 @@ static void FM_ADPCMAWrite(YM2610 *F2610,int r,int v)
 							adpcm[c].flag = 0;
 						}
 					}
+					if (adpcm[c].flag && F2610->ADPCMACache)
+					{
+						const ADPCMA_CACHE_ENTRY *entry = ADPCMA_cache_get(F2610, adpcm[c].start, adpcm[c].end);
+						if (entry != NULL && entry->usable)
+						{
+							adpcm[c].cache     = entry;
+							adpcm[c].cache_pos = 0;
+						}
+					}
 				}
 			}
 		}
@@ -2977,7 +3050,10 @@ static void FM_ADPCMAWrite(YM2610 *F2610,int r,int v)
 			/* KEY OFF */
 			for( c = 0; c < 6; c++ )
 				if( (v>>c)&1 )
+				{
 					adpcm[c].flag = 0;
+					ADPCMA_cache_detach(F2610, &adpcm[c]);
+				}
 		}
 		break;
 	case 0x01:  /* B0-5 = TL */
@@ -3033,10 +3109,12 @@ static void FM_ADPCMAWrite(YM2610 *F2610,int r,int v)
 			break;
 		case 0x10:
 		case 0x18:
+			ADPCMA_cache_detach(F2610, &adpcm[c]);	/* a playing channel must see the new address */
 			adpcm[c].start  = ( (F2610->adpcmreg[0x18 + c]*0x0100 | F2610->adpcmreg[0x10 + c]) << ADPCMA_ADDRESS_SHIFT);
 			break;
 		case 0x20:
 		case 0x28:
+			ADPCMA_cache_detach(F2610, &adpcm[c]);
 			adpcm[c].end    = ( (F2610->adpcmreg[0x28 + c]*0x0100 | F2610->adpcmreg[0x20 + c]) << ADPCMA_ADDRESS_SHIFT);
 			adpcm[c].end   += (1<<ADPCMA_ADDRESS_SHIFT) - 1;
 			break;
@@ -3132,28 +3210,21 @@ void ym2608_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
     //search first voice linked to current chip
     int m_voice_ofs=-1;
     int m_total_channels=13;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
     //printf("opn:%d / %lf delta:%lf\n",OPN->ST.rate,OPN->ST.freqbase,DELTAT->freqbase);
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
-    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
     
     //YOYOFR
-    static INT32 old_out_fm[6]; //YOYOFR
     if (m_voice_ofs>=0) {
         for (int ii=0;ii<6;ii++) {
             if (!(cch[ii]->Muted)) {
                 if (cch[ii]->block_fnum==0) {
-                    if ((out_fm[ii]!=old_out_fm[ii])) {
+                    if ((out_fm[ii]!=OPN->old_out_fm[ii])) {
                         vgm_last_note[ii+m_voice_ofs]=220.0f; //arbitrary choosing A-3
                         vgm_last_instr[ii+m_voice_ofs]=ii+m_voice_ofs;
                         int newvol=cch[ii]->keyonff_triggered+1;
@@ -3161,7 +3232,7 @@ void ym2608_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
                         if (vgm_last_vol[ii+m_voice_ofs]<newvol) vgm_last_vol[ii+m_voice_ofs]=newvol;
                     }
                 } else {
-                    if ((out_fm[ii]!=old_out_fm[ii])) {
+                    if ((out_fm[ii]!=OPN->old_out_fm[ii])) {
                         int freq=(cch[ii]->block_fnum)&0x7FF;
                         int octave=((cch[ii]->block_fnum)>>11)&0x7;
                         vgm_last_note[ii+m_voice_ofs]=(freq<<octave)*110.0f/1081.0f; //1148.0f;
@@ -3172,7 +3243,7 @@ void ym2608_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
                     }
                 }
             }
-            old_out_fm[ii]=out_fm[ii];
+            OPN->old_out_fm[ii]=out_fm[ii];
         }
         //Rythm box - 6 channels
         for (int ii=0;ii<6;ii++) {
@@ -3392,9 +3463,6 @@ void * ym2608_init(void *param, UINT32 clock, UINT32 rate,
 	if( F2608==NULL)
 		return NULL;
 
-	/* allocate total level table (128kb space) */
-	init_tables();
-
 	F2608->OPN.ST.param = param;
 	F2608->OPN.type = TYPE_YM2608;
 	F2608->OPN.P_CH = F2608->CH;
@@ -3410,7 +3478,7 @@ void * ym2608_init(void *param, UINT32 clock, UINT32 rate,
 
 	/* DELTA-T */
 	F2608->deltaT.logger = &F2608->OPN.logger;
-	F2608->deltaT.memory = NULL;
+	rommap_init(&F2608->deltaT.memory);
 	F2608->deltaT.memory_size = 0x00;
 	F2608->deltaT.memory_mask = 0x00;
 
@@ -3427,10 +3495,10 @@ void * ym2608_init(void *param, UINT32 clock, UINT32 rate,
 	YM_DELTAT_ADPCM_Init(&F2608->deltaT,YM_DELTAT_EMULATION_MODE_NORMAL,5,F2608->OPN.out_delta,1<<23);
 
 	/* ADPCM Rhythm */
-	F2608->pcmbuf   = (UINT8*)YM2608_ADPCM_ROM;
-	F2608->pcm_size = 0x2000;
-
-	Init_ADPCMATable();
+	rommap_init(&F2608->pcmrom);
+	rommap_alloc(&F2608->pcmrom, 0x2000);
+	rommap_ref(&F2608->pcmrom, 0x00, 0x2000, YM2608_ADPCM_ROM);
+	F2608->pcm_size = F2608->pcmrom.size;
 
 	ym2608_set_mute_mask(F2608, 0x00);
 
@@ -3460,7 +3528,8 @@ void ym2608_shutdown(void *chip)
 {
 	YM2608 *F2608 = (YM2608 *)chip;
 
-	free(F2608->deltaT.memory); F2608->deltaT.memory = NULL;
+	rommap_free(&F2608->pcmrom);
+	rommap_free(&F2608->deltaT.memory);
 
 	free(F2608);
 }
@@ -3539,6 +3608,7 @@ void ym2608_reset_chip(void *chip)
 		F2608->adpcm[i].adpcm_acc = 0;
 		F2608->adpcm[i].adpcm_step= 0;
 		F2608->adpcm[i].adpcm_out = 0;
+		F2608->adpcm[i].cache     = NULL;
 	}
 	F2608->adpcmTL = 0x3f;
 
@@ -3732,9 +3802,8 @@ void ym2608_alloc_pcmromb(void* chip, UINT32 memsize)
 	
 	if (F2608->deltaT.memory_size == memsize)
 		return;
-	F2608->deltaT.memory = (UINT8*)realloc(F2608->deltaT.memory, memsize);
-	F2608->deltaT.memory_size = memsize;
-	memset(F2608->deltaT.memory, 0xFF, memsize);
+	rommap_alloc(&F2608->deltaT.memory, memsize);
+	F2608->deltaT.memory_size = F2608->deltaT.memory.size;
 	YM_DELTAT_calc_mem_mask(&F2608->deltaT);
 	
 	return;
@@ -3744,12 +3813,16 @@ void ym2608_write_pcmromb(void* chip, UINT32 offset, UINT32 length, const UINT8*
 {
 	YM2608* F2608 = (YM2608*)chip;
 	
-	if (offset > F2608->deltaT.memory_size)
-		return;
-	if (offset + length > F2608->deltaT.memory_size)
-		length = F2608->deltaT.memory_size - offset;
+	rommap_write(&F2608->deltaT.memory, offset, length, data);
+	
+	return;
+}
+
+void ym2608_ref_pcmromb(void* chip, UINT32 offset, UINT32 length, const UINT8* data)
+{
+	YM2608* F2608 = (YM2608*)chip;
 	
-	memcpy(F2608->deltaT.memory + offset, data, length);
+	rommap_ref(&F2608->deltaT.memory, offset, length, data);
 	
 	return;
 }
@@ -3792,24 +3865,20 @@ void ym2610_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
 	DEV_SMPL  *bufL,*bufR;
 	FM_CH   *cch[4];
 	INT32 *out_fm = OPN->out_fm;
+	INT32 deltaBuf[YM2610_DELTAT_BLOCK];
+	UINT8 deltaOn = 0;
     
     //TODO:  MODIZER changes start / YOYOFR
     //search first voice linked to current chip
     int m_voice_ofs=-1;
     int m_total_channels=11;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
     //printf("opn:%d / %lf delta:%lf\n",OPN->ST.rate,OPN->ST.freqbase,DELTAT->freqbase);
-    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
 
 	/* buffer setup */
@@ -3829,12 +3898,11 @@ void ym2610_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
 	cch[3] = &F2610->CH[5];
     
     //YOYOFR
-    static INT32 old_out_fm[4]; //YOYOFR
     if (m_voice_ofs>=0) {
         for (int ii=0;ii<4;ii++) {
             if (!(cch[ii]->Muted)) {
                 if (cch[ii]->block_fnum==0) {
-                    if ((out_fm[ii]!=old_out_fm[ii])) {
+                    if ((out_fm[ii]!=OPN->old_out_fm_2610[ii])) {
                         vgm_last_note[ii+m_voice_ofs]=220.0f; //arbitrary choosing A-3
                         vgm_last_instr[ii+m_voice_ofs]=ii+m_voice_ofs;
                         int newvol=cch[ii]->keyonff_triggered+1;
@@ -3842,7 +3910,7 @@ void ym2610_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
                         if (vgm_last_vol[ii+m_voice_ofs]<newvol) vgm_last_vol[ii+m_voice_ofs]=newvol;
                     }
                 } else {
-                    if ((out_fm[ii]!=old_out_fm[ii])) {
+                    if ((out_fm[ii]!=OPN->old_out_fm_2610[ii])) {
                         int freq=(cch[ii]->block_fnum)&0x7FF;
                         int octave=((cch[ii]->block_fnum)>>11)&0x7;
                         vgm_last_note[ii+m_voice_ofs]=(freq<<octave)*110.0f/1081.0f; //1148.0f;
@@ -3854,10 +3922,10 @@ void ym2610_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
                 }
             }
         }
-        old_out_fm[0]=out_fm[1];
-        old_out_fm[1]=out_fm[2];
-        old_out_fm[2]=out_fm[4];
-        old_out_fm[3]=out_fm[5];
+        OPN->old_out_fm_2610[0]=out_fm[1];
+        OPN->old_out_fm_2610[1]=out_fm[2];
+        OPN->old_out_fm_2610[2]=out_fm[4];
+        OPN->old_out_fm_2610[3]=out_fm[5];
         //ADPCM-A
         for (int ii=0;ii<6;ii++) {
             if ( (!(F2610->adpcm[ii].Muted)) && (F2610->adpcm[ii].flag) ) {
@@ -3899,28 +3967,31 @@ void ym2610_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
 #endif
 
 	/* refresh PG and EG */
-	refresh_fc_eg_chan( OPN, cch[0] );
-	if( (OPN->ST.mode & 0xc0) )
+	if (! F2610->PCMOnly)
 	{
-		/* 3SLOT MODE */
-		if( cch[1]->SLOT[SLOT1].Incr==-1)
+		refresh_fc_eg_chan( OPN, cch[0] );
+		if( (OPN->ST.mode & 0xc0) )
 		{
-			refresh_fc_eg_slot(OPN, &cch[1]->SLOT[SLOT1] , OPN->SL3.fc[1] , OPN->SL3.kcode[1] );
-			refresh_fc_eg_slot(OPN, &cch[1]->SLOT[SLOT2] , OPN->SL3.fc[2] , OPN->SL3.kcode[2] );
-			refresh_fc_eg_slot(OPN, &cch[1]->SLOT[SLOT3] , OPN->SL3.fc[0] , OPN->SL3.kcode[0] );
-			refresh_fc_eg_slot(OPN, &cch[1]->SLOT[SLOT4] , cch[1]->fc , cch[1]->kcode );
+			/* 3SLOT MODE */
+			if( cch[1]->SLOT[SLOT1].Incr==-1)
+			{
+				refresh_fc_eg_slot(OPN, &cch[1]->SLOT[SLOT1] , OPN->SL3.fc[1] , OPN->SL3.kcode[1] );
+				refresh_fc_eg_slot(OPN, &cch[1]->SLOT[SLOT2] , OPN->SL3.fc[2] , OPN->SL3.kcode[2] );
+				refresh_fc_eg_slot(OPN, &cch[1]->SLOT[SLOT3] , OPN->SL3.fc[0] , OPN->SL3.kcode[0] );
+				refresh_fc_eg_slot(OPN, &cch[1]->SLOT[SLOT4] , cch[1]->fc , cch[1]->kcode );
+			}
+		}
+		else
+			refresh_fc_eg_chan( OPN, cch[1] );
+		refresh_fc_eg_chan( OPN, cch[2] );
+		refresh_fc_eg_chan( OPN, cch[3] );
+		if (! length)
+		{
+			update_ssg_eg_channel(&cch[0]->SLOT[SLOT1]);
+			update_ssg_eg_channel(&cch[1]->SLOT[SLOT1]);
+			update_ssg_eg_channel(&cch[2]->SLOT[SLOT1]);
+			update_ssg_eg_channel(&cch[3]->SLOT[SLOT1]);
 		}
-	}
-	else
-		refresh_fc_eg_chan( OPN, cch[1] );
-	refresh_fc_eg_chan( OPN, cch[2] );
-	refresh_fc_eg_chan( OPN, cch[3] );
-	if (! length)
-	{
-		update_ssg_eg_channel(&cch[0]->SLOT[SLOT1]);
-		update_ssg_eg_channel(&cch[1]->SLOT[SLOT1]);
-		update_ssg_eg_channel(&cch[2]->SLOT[SLOT1]);
-		update_ssg_eg_channel(&cch[3]->SLOT[SLOT1]);
 	}
     
     
@@ -3938,21 +4009,30 @@ void ym2610_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
 		out_fm[4] = 0;
 		out_fm[5] = 0;
 
-		/* update SSG-EG output */
-		update_ssg_eg_channel(&cch[0]->SLOT[SLOT1]);
-		update_ssg_eg_channel(&cch[1]->SLOT[SLOT1]);
-		update_ssg_eg_channel(&cch[2]->SLOT[SLOT1]);
-		update_ssg_eg_channel(&cch[3]->SLOT[SLOT1]);
-
-		/* calculate FM */
-		chan_calc(OPN, cch[0], 1 );	/*remapped to 1*/
-		chan_calc(OPN, cch[1], 2 );	/*remapped to 2*/
-		chan_calc(OPN, cch[2], 4 );	/*remapped to 4*/
-		chan_calc(OPN, cch[3], 5 );	/*remapped to 5*/
+		if (! F2610->PCMOnly)
+		{
+			/* update SSG-EG output */
+			update_ssg_eg_channel(&cch[0]->SLOT[SLOT1]);
+			update_ssg_eg_channel(&cch[1]->SLOT[SLOT1]);
+			update_ssg_eg_channel(&cch[2]->SLOT[SLOT1]);
+			update_ssg_eg_channel(&cch[3]->SLOT[SLOT1]);
+
+			/* calculate FM */
+			chan_calc(OPN, cch[0], 1 );	/*remapped to 1*/
+			chan_calc(OPN, cch[1], 2 );	/*remapped to 2*/
+			chan_calc(OPN, cch[2], 4 );	/*remapped to 4*/
+			chan_calc(OPN, cch[3], 5 );	/*remapped to 5*/
+		}
 
-		/* deltaT ADPCM */
-		if( DELTAT->portstate&0x80 && ! F2610->MuteDeltaT )
-			YM_DELTAT_ADPCM_CALC(DELTAT);
+		/* deltaT ADPCM, decoded a block at a time */
+		if( (i & (YM2610_DELTAT_BLOCK-1)) == 0 )
+		{
+			deltaOn = (DELTAT->portstate&0x80) && ! F2610->MuteDeltaT;
+			if( deltaOn )
+				YM_DELTAT_ADPCM_CALC_BLOCK(DELTAT, deltaBuf, (length - i < YM2610_DELTAT_BLOCK) ? length - i : YM2610_DELTAT_BLOCK);
+		}
+		if( deltaOn )
+			*(DELTAT->pan) += deltaBuf[i & (YM2610_DELTAT_BLOCK-1)];
 
 		/* ADPCMA */
 		for( j = 0; j < 6; j++ )
@@ -3961,20 +4041,23 @@ void ym2610_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
 				ADPCMA_calc_chan( F2610, &F2610->adpcm[j]);
 		}
 
-		/* advance LFO */
-		advance_lfo(OPN);
-
-		/* advance envelope generator */
-		OPN->eg_timer += OPN->eg_timer_add;
-		while (OPN->eg_timer >= OPN->eg_timer_overflow)
+		if (! F2610->PCMOnly)
 		{
-			OPN->eg_timer -= OPN->eg_timer_overflow;
-			OPN->eg_cnt++;
+			/* advance LFO */
+			advance_lfo(OPN);
 
-			advance_eg_channel(OPN, &cch[0]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[1]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[2]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[3]->SLOT[SLOT1]);
+			/* advance envelope generator */
+			OPN->eg_timer += OPN->eg_timer_add;
+			while (OPN->eg_timer >= OPN->eg_timer_overflow)
+			{
+				OPN->eg_timer -= OPN->eg_timer_overflow;
+				OPN->eg_cnt++;
+
+				advance_eg_channel(OPN, &cch[0]->SLOT[SLOT1]);
+				advance_eg_channel(OPN, &cch[1]->SLOT[SLOT1]);
+				advance_eg_channel(OPN, &cch[2]->SLOT[SLOT1]);
+				advance_eg_channel(OPN, &cch[3]->SLOT[SLOT1]);
+			}
 		}
 
 		/* buffering */
@@ -4025,7 +4108,7 @@ void ym2610_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
                         }
                     }
                     
-                    if( DELTAT->portstate&0x80 && ! F2610->MuteDeltaT ) m_voice_buff[m_voice_ofs+10][(ofs_start>>MODIZER_OSCILLO_OFFSET_FIXEDPOINT)&(SOUND_BUFFER_SIZE_SAMPLE*4*2-1)]=LIMIT8((F2610->deltaT.adpcml)>>15);
+                    if( deltaOn ) m_voice_buff[m_voice_ofs+10][(ofs_start>>MODIZER_OSCILLO_OFFSET_FIXEDPOINT)&(SOUND_BUFFER_SIZE_SAMPLE*4*2-1)]=LIMIT8((deltaBuf[i & (YM2610_DELTAT_BLOCK-1)])>>15);
                     
                     ofs_start+=1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT;
                     if (ofs_start>=ofs_end) break;
@@ -4076,6 +4159,8 @@ void ym2610b_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
 	DEV_SMPL  *bufL,*bufR;
 	FM_CH   *cch[6];
 	INT32 *out_fm = OPN->out_fm;
+	INT32 deltaBuf[YM2610_DELTAT_BLOCK];
+	UINT8 deltaOn = 0;
 
 	/* buffer setup */
 	if (buffer != NULL)
@@ -4099,28 +4184,21 @@ void ym2610b_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
     //search first voice linked to current chip
     int m_voice_ofs=-1;
     int m_total_channels=13;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
     //printf("opn:%d / %lf delta:%lf\n",OPN->ST.rate,OPN->ST.freqbase,DELTAT->freqbase);
-    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
     
     //YOYOFR
-    static INT32 old_out_fm[6]; //YOYOFR
     if (m_voice_ofs>=0) {
         for (int ii=0;ii<6;ii++) {
             if (!(cch[ii]->Muted)) {
                 if (cch[ii]->block_fnum==0) {
-                    if ((out_fm[ii]!=old_out_fm[ii])) {
+                    if ((out_fm[ii]!=OPN->old_out_fm[ii])) {
                         vgm_last_note[ii+m_voice_ofs]=220.0f; //arbitrary choosing A-3
                         vgm_last_instr[ii+m_voice_ofs]=ii+m_voice_ofs;
                         int newvol=cch[ii]->keyonff_triggered+1;
@@ -4128,7 +4206,7 @@ void ym2610b_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
                         if (vgm_last_vol[ii+m_voice_ofs]<newvol) vgm_last_vol[ii+m_voice_ofs]=newvol;
                     }
                 } else {
-                    if ((out_fm[ii]!=old_out_fm[ii])) {
+                    if ((out_fm[ii]!=OPN->old_out_fm[ii])) {
                         int freq=(cch[ii]->block_fnum)&0x7FF;
                         int octave=((cch[ii]->block_fnum)>>11)&0x7;
                         vgm_last_note[ii+m_voice_ofs]=(freq<<octave)*110.0f/1081.0f; //1148.0f;
@@ -4139,7 +4217,7 @@ void ym2610b_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
                     }
                 }
             }
-            old_out_fm[ii]=out_fm[ii];
+            OPN->old_out_fm[ii]=out_fm[ii];
         }
         //ADPCM-A
         for (int ii=0;ii<6;ii++) {
@@ -4165,32 +4243,35 @@ void ym2610b_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
     }
 
 	/* refresh PG and EG */
-	refresh_fc_eg_chan( OPN, cch[0] );
-	refresh_fc_eg_chan( OPN, cch[1] );
-	if( (OPN->ST.mode & 0xc0) )
+	if (! F2610->PCMOnly)
 	{
-		/* 3SLOT MODE */
-		if( cch[2]->SLOT[SLOT1].Incr==-1)
+		refresh_fc_eg_chan( OPN, cch[0] );
+		refresh_fc_eg_chan( OPN, cch[1] );
+		if( (OPN->ST.mode & 0xc0) )
 		{
-			refresh_fc_eg_slot(OPN, &cch[2]->SLOT[SLOT1] , OPN->SL3.fc[1] , OPN->SL3.kcode[1] );
-			refresh_fc_eg_slot(OPN, &cch[2]->SLOT[SLOT2] , OPN->SL3.fc[2] , OPN->SL3.kcode[2] );
-			refresh_fc_eg_slot(OPN, &cch[2]->SLOT[SLOT3] , OPN->SL3.fc[0] , OPN->SL3.kcode[0] );
-			refresh_fc_eg_slot(OPN, &cch[2]->SLOT[SLOT4] , cch[2]->fc , cch[2]->kcode );
+			/* 3SLOT MODE */
+			if( cch[2]->SLOT[SLOT1].Incr==-1)
+			{
+				refresh_fc_eg_slot(OPN, &cch[2]->SLOT[SLOT1] , OPN->SL3.fc[1] , OPN->SL3.kcode[1] );
+				refresh_fc_eg_slot(OPN, &cch[2]->SLOT[SLOT2] , OPN->SL3.fc[2] , OPN->SL3.kcode[2] );
+				refresh_fc_eg_slot(OPN, &cch[2]->SLOT[SLOT3] , OPN->SL3.fc[0] , OPN->SL3.kcode[0] );
+				refresh_fc_eg_slot(OPN, &cch[2]->SLOT[SLOT4] , cch[2]->fc , cch[2]->kcode );
+			}
+		}
+		else
+			refresh_fc_eg_chan( OPN, cch[2] );
+		refresh_fc_eg_chan( OPN, cch[3] );
+		refresh_fc_eg_chan( OPN, cch[4] );
+		refresh_fc_eg_chan( OPN, cch[5] );
+		if (! length)
+		{
+			update_ssg_eg_channel(&cch[0]->SLOT[SLOT1]);
+			update_ssg_eg_channel(&cch[1]->SLOT[SLOT1]);
+			update_ssg_eg_channel(&cch[2]->SLOT[SLOT1]);
+			update_ssg_eg_channel(&cch[3]->SLOT[SLOT1]);
+			update_ssg_eg_channel(&cch[4]->SLOT[SLOT1]);
+			update_ssg_eg_channel(&cch[5]->SLOT[SLOT1]);
 		}
-	}
-	else
-		refresh_fc_eg_chan( OPN, cch[2] );
-	refresh_fc_eg_chan( OPN, cch[3] );
-	refresh_fc_eg_chan( OPN, cch[4] );
-	refresh_fc_eg_chan( OPN, cch[5] );
-	if (! length)
-	{
-		update_ssg_eg_channel(&cch[0]->SLOT[SLOT1]);
-		update_ssg_eg_channel(&cch[1]->SLOT[SLOT1]);
-		update_ssg_eg_channel(&cch[2]->SLOT[SLOT1]);
-		update_ssg_eg_channel(&cch[3]->SLOT[SLOT1]);
-		update_ssg_eg_channel(&cch[4]->SLOT[SLOT1]);
-		update_ssg_eg_channel(&cch[5]->SLOT[SLOT1]);
 	}
 
 	/* buffering */
@@ -4207,25 +4288,34 @@ void ym2610b_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
 		out_fm[4] = 0;
 		out_fm[5] = 0;
 
-		/* update SSG-EG output */
-		update_ssg_eg_channel(&cch[0]->SLOT[SLOT1]);
-		update_ssg_eg_channel(&cch[1]->SLOT[SLOT1]);
-		update_ssg_eg_channel(&cch[2]->SLOT[SLOT1]);
-		update_ssg_eg_channel(&cch[3]->SLOT[SLOT1]);
-		update_ssg_eg_channel(&cch[4]->SLOT[SLOT1]);
-		update_ssg_eg_channel(&cch[5]->SLOT[SLOT1]);
-
-		/* calculate FM */
-		chan_calc(OPN, cch[0], 0 );
-		chan_calc(OPN, cch[1], 1 );
-		chan_calc(OPN, cch[2], 2 );
-		chan_calc(OPN, cch[3], 3 );
-		chan_calc(OPN, cch[4], 4 );
-		chan_calc(OPN, cch[5], 5 );
+		if (! F2610->PCMOnly)
+		{
+			/* update SSG-EG output */
+			update_ssg_eg_channel(&cch[0]->SLOT[SLOT1]);
+			update_ssg_eg_channel(&cch[1]->SLOT[SLOT1]);
+			update_ssg_eg_channel(&cch[2]->SLOT[SLOT1]);
+			update_ssg_eg_channel(&cch[3]->SLOT[SLOT1]);
+			update_ssg_eg_channel(&cch[4]->SLOT[SLOT1]);
+			update_ssg_eg_channel(&cch[5]->SLOT[SLOT1]);
+
+			/* calculate FM */
+			chan_calc(OPN, cch[0], 0 );
+			chan_calc(OPN, cch[1], 1 );
+			chan_calc(OPN, cch[2], 2 );
+			chan_calc(OPN, cch[3], 3 );
+			chan_calc(OPN, cch[4], 4 );
+			chan_calc(OPN, cch[5], 5 );
+		}
 
-		/* deltaT ADPCM */
-		if( DELTAT->portstate&0x80 && ! F2610->MuteDeltaT )
-			YM_DELTAT_ADPCM_CALC(DELTAT);
+		/* deltaT ADPCM, decoded a block at a time */
+		if( (i & (YM2610_DELTAT_BLOCK-1)) == 0 )
+		{
+			deltaOn = (DELTAT->portstate&0x80) && ! F2610->MuteDeltaT;
+			if( deltaOn )
+				YM_DELTAT_ADPCM_CALC_BLOCK(DELTAT, deltaBuf, (length - i < YM2610_DELTAT_BLOCK) ? length - i : YM2610_DELTAT_BLOCK);
+		}
+		if( deltaOn )
+			*(DELTAT->pan) += deltaBuf[i & (YM2610_DELTAT_BLOCK-1)];
 
 		/* ADPCMA */
 		for( j = 0; j < 6; j++ )
@@ -4234,22 +4324,25 @@ void ym2610b_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
 				ADPCMA_calc_chan( F2610, &F2610->adpcm[j]);
 		}
 
-		/* advance LFO */
-		advance_lfo(OPN);
-
-		/* advance envelope generator */
-		OPN->eg_timer += OPN->eg_timer_add;
-		while (OPN->eg_timer >= OPN->eg_timer_overflow)
+		if (! F2610->PCMOnly)
 		{
-			OPN->eg_timer -= OPN->eg_timer_overflow;
-			OPN->eg_cnt++;
+			/* advance LFO */
+			advance_lfo(OPN);
 
-			advance_eg_channel(OPN, &cch[0]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[1]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[2]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[3]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[4]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[5]->SLOT[SLOT1]);
+			/* advance envelope generator */
+			OPN->eg_timer += OPN->eg_timer_add;
+			while (OPN->eg_timer >= OPN->eg_timer_overflow)
+			{
+				OPN->eg_timer -= OPN->eg_timer_overflow;
+				OPN->eg_cnt++;
+
+				advance_eg_channel(OPN, &cch[0]->SLOT[SLOT1]);
+				advance_eg_channel(OPN, &cch[1]->SLOT[SLOT1]);
+				advance_eg_channel(OPN, &cch[2]->SLOT[SLOT1]);
+				advance_eg_channel(OPN, &cch[3]->SLOT[SLOT1]);
+				advance_eg_channel(OPN, &cch[4]->SLOT[SLOT1]);
+				advance_eg_channel(OPN, &cch[5]->SLOT[SLOT1]);
+			}
 		}
 
 
@@ -4298,7 +4391,7 @@ void ym2610b_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
                         }
                     }
                     
-                    if( DELTAT->portstate&0x80 && ! F2610->MuteDeltaT ) m_voice_buff[m_voice_ofs+12][(ofs_start>>MODIZER_OSCILLO_OFFSET_FIXEDPOINT)&(SOUND_BUFFER_SIZE_SAMPLE*4*2-1)]=LIMIT8( (F2610->deltaT.adpcml)>>15 );
+                    if( deltaOn ) m_voice_buff[m_voice_ofs+12][(ofs_start>>MODIZER_OSCILLO_OFFSET_FIXEDPOINT)&(SOUND_BUFFER_SIZE_SAMPLE*4*2-1)]=LIMIT8((deltaBuf[i & (YM2610_DELTAT_BLOCK-1)])>>15);
                     
                     ofs_start+=1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT;
                     if (ofs_start>=ofs_end) break;
@@ -4355,9 +4448,6 @@ void *ym2610_init(void *param, UINT32 clock, UINT32 rate,
 	if( F2610==NULL)
 		return NULL;
 
-	/* allocate total level table (128kb space) */
-	init_tables();
-
 	/* FM */
 	F2610->OPN.ST.param = param;
 	F2610->OPN.type = TYPE_YM2610;
@@ -4371,11 +4461,11 @@ void *ym2610_init(void *param, UINT32 clock, UINT32 rate,
 	OPNLinkSSG(&F2610->OPN, NULL, NULL);
 	OPNSetSmplRateChgCallback(&F2610->OPN, NULL, NULL);
 	/* ADPCM */
-	F2610->pcmbuf   = NULL;
+	rommap_init(&F2610->pcmrom);
 	F2610->pcm_size = 0x00;
 	/* DELTA-T */
 	F2610->deltaT.logger = &F2610->OPN.logger;
-	F2610->deltaT.memory = NULL;
+	rommap_init(&F2610->deltaT.memory);
 	F2610->deltaT.memory_size = 0x00;
 	F2610->deltaT.memory_mask = 0x00;
 
@@ -4386,8 +4476,6 @@ void *ym2610_init(void *param, UINT32 clock, UINT32 rate,
 
 	YM_DELTAT_ADPCM_Init(&F2610->deltaT,YM_DELTAT_EMULATION_MODE_YM2610,8,F2610->OPN.out_delta,1<<23);
 
-	Init_ADPCMATable();
-
 	ym2610_set_mute_mask(F2610, 0x00);
 
 	return F2610;
@@ -4408,8 +4496,10 @@ void ym2610_shutdown(void *chip)
 {
 	YM2610 *F2610 = (YM2610 *)chip;
 
-	free(F2610->pcmbuf);        F2610->pcmbuf = NULL;
-	free(F2610->deltaT.memory); F2610->deltaT.memory = NULL;
+	if (F2610->acache_own)
+		ym2610_adpcma_cache_free(F2610->acache);
+	rommap_free(&F2610->pcmrom);
+	rommap_free(&F2610->deltaT.memory);
 
 	free(F2610);
 }
@@ -4475,6 +4565,7 @@ void ym2610_reset_chip(void *chip)
 		F2610->adpcm[i].adpcm_acc = 0;
 		F2610->adpcm[i].adpcm_step= 0;
 		F2610->adpcm[i].adpcm_out = 0;
+		F2610->adpcm[i].cache     = NULL;
 	}
 	F2610->adpcmTL = 0x3f;
 
@@ -4650,9 +4741,9 @@ void ym2610_alloc_pcmroma(void* chip, UINT32 memsize)
 	
 	if (F2610->pcm_size == memsize)
 		return;
-	F2610->pcmbuf = (UINT8*)realloc(F2610->pcmbuf, memsize);
-	F2610->pcm_size = memsize;
-	memset(F2610->pcmbuf, 0xFF, memsize);
+	ADPCMA_cache_romchange(F2610);
+	rommap_alloc(&F2610->pcmrom, memsize);
+	F2610->pcm_size = F2610->pcmrom.size;
 	
 	return;
 }
@@ -4661,12 +4752,18 @@ void ym2610_write_pcmroma(void* chip, UINT32 offset, UINT32 length, const UINT8*
 {
 	YM2610 *F2610 = (YM2610 *)chip;
 	
-	if (offset > F2610->pcm_size)
-		return;
-	if (offset + length > F2610->pcm_size)
-		length = F2610->pcm_size - offset;
+	ADPCMA_cache_romchange(F2610);
+	rommap_write(&F2610->pcmrom, offset, length, data);
+	
+	return;
+}
+
+void ym2610_ref_pcmroma(void* chip, UINT32 offset, UINT32 length, const UINT8* data)
+{
+	YM2610 *F2610 = (YM2610 *)chip;
 	
-	memcpy(F2610->pcmbuf + offset, data, length);
+	ADPCMA_cache_romchange(F2610);
+	rommap_ref(&F2610->pcmrom, offset, length, data);
 	
 	return;
 }
@@ -4677,9 +4774,8 @@ void ym2610_alloc_pcmromb(void* chip, UINT32 memsize)
 	
 	if (F2610->deltaT.memory_size == memsize)
 		return;
-	F2610->deltaT.memory = (UINT8*)realloc(F2610->deltaT.memory, memsize);
-	F2610->deltaT.memory_size = memsize;
-	memset(F2610->deltaT.memory, 0xFF, memsize);
+	rommap_alloc(&F2610->deltaT.memory, memsize);
+	F2610->deltaT.memory_size = F2610->deltaT.memory.size;
 	YM_DELTAT_calc_mem_mask(&F2610->deltaT);
 	
 	return;
@@ -4689,12 +4785,16 @@ void ym2610_write_pcmromb(void* chip, UINT32 offset, UINT32 length, const UINT8*
 {
 	YM2610 *F2610 = (YM2610 *)chip;
 	
-	if (offset > F2610->deltaT.memory_size)
-		return;
-	if (offset + length > F2610->deltaT.memory_size)
-		length = F2610->deltaT.memory_size - offset;
+	rommap_write(&F2610->deltaT.memory, offset, length, data);
+	
+	return;
+}
+
+void ym2610_ref_pcmromb(void* chip, UINT32 offset, UINT32 length, const UINT8* data)
+{
+	YM2610 *F2610 = (YM2610 *)chip;
 	
-	memcpy(F2610->deltaT.memory + offset, data, length);
+	rommap_ref(&F2610->deltaT.memory, offset, length, data);
 	
 	return;
 }
@@ -4713,6 +4813,102 @@ void ym2610_set_mute_mask(void *chip, UINT32 MuteMask)
 	return;
 }
 
+/* Emulation state snapshots are a copy of the chip structure and can only be
+   loaded into the chip they were saved from. Options, muting and the sample
+   ROMs stay as they are when loading. */
+UINT32 ym2610_save_state(void *chip, void *buffer)
+{
+	YM2610 *F2610 = (YM2610 *)chip;
+	YM2610 *state = (YM2610 *)buffer;
+	int c;
+	
+	if (state == NULL)
+		return sizeof(YM2610);
+	
+	memcpy(state, F2610, sizeof(YM2610));
+	/* the sample cache may be flushed before the snapshot is loaded */
+	for (c = 0; c < 6; c++)
+		ADPCMA_cache_detach(state, &state->adpcm[c]);
+	return sizeof(YM2610);
+}
+
+void ym2610_load_state(void *chip, const void *buffer)
+{
+	YM2610 *F2610 = (YM2610 *)chip;
+	const YM2610 *state = (const YM2610 *)buffer;
+	OPN_SETTINGS set;
+	ROM_MAP pcmrom = F2610->pcmrom;
+	UINT32 pcm_size = F2610->pcm_size;
+	UINT8 MuteDeltaT = F2610->MuteDeltaT;
+	UINT8 PCMOnly = F2610->PCMOnly;
+	UINT8 ADPCMACache = F2610->ADPCMACache;
+	ADPCMA_CACHE *acache = F2610->acache;
+	UINT8 acache_own = F2610->acache_own;
+	UINT8 adpcmMuted[6];
+	YM_DELTAT deltaT = F2610->deltaT;
+	int c;
+	
+	OPNGetSettings(&F2610->OPN, F2610->CH, &set);
+	for (c = 0; c < 6; c++)
+		adpcmMuted[c] = F2610->adpcm[c].Muted;
+	
+	memcpy(F2610, state, sizeof(YM2610));
+	
+	OPNSetSettings(&F2610->OPN, F2610->CH, &set);
+	F2610->pcmrom = pcmrom;
+	F2610->pcm_size = pcm_size;
+	F2610->MuteDeltaT = MuteDeltaT;
+	F2610->PCMOnly = PCMOnly;
+	F2610->ADPCMACache = ADPCMACache;
+	F2610->acache = acache;
+	F2610->acache_own = acache_own;
+	for (c = 0; c < 6; c++)
+		F2610->adpcm[c].Muted = adpcmMuted[c];
+	YM_DELTAT_ADPCM_LoadState(&deltaT, &state->deltaT);
+	F2610->deltaT = deltaT;
+	
+	return;
+}
+
+void ym2610_set_options(void *chip, UINT32 Flags)
+{
+	YM2610 *F2610 = (YM2610 *)chip;
+	
+	// PCM-only: the FM channels are neither calculated nor clocked (their
+	// envelopes stay frozen), ADPCM-A/B, timers and CSM run as usual
+	F2610->PCMOnly = (Flags >> 0) & 0x01;
+	// ADPCM-A cache: samples are decoded once per start/end pair at key-on
+	F2610->ADPCMACache = (Flags >> 1) & 0x01;
+	if (! F2610->ADPCMACache)
+	{
+		ADPCMA_cache_detach_all(F2610);
+		if (F2610->acache_own)
+			ADPCMA_cache_clear(F2610->acache);
+	}
+	
+	return;
+}
+
+void ym2610_set_adpcma_cache(void *chip, void *cache)
+{
+	YM2610 *F2610 = (YM2610 *)chip;
+	ADPCMA_CACHE *newCache = (ADPCMA_CACHE *)cache;
+	
+	// NULL = private cache (created on first use)
+	if (newCache == F2610->acache || (newCache == NULL && F2610->acache_own))
+		return;
+	ADPCMA_cache_detach_all(F2610);
+	if (F2610->acache_own)
+		ym2610_adpcma_cache_free(F2610->acache);
+	F2610->acache = newCache;
+	F2610->acache_own = 0;
+	// the samples in a shared cache come from another chip's ROM
+	if (newCache != NULL)
+		newCache->romGen ++;
+	
+	return;
+}
+
 void ym2610_set_log_cb(void* chip, DEVCB_LOG func, void* param)
 {
 	YM2610 *F2610 = (YM2610 *)chip;
@@ -4727,6 +4923,8 @@ void ym2610_set_log_cb(void* chip, DEVCB_LOG func, void* param)
 /*      YM2612 local section                                                   */
 /*******************************************************************************/
 
+#define YM2612_DACQ_SIZE	0x400	/* queued DAC writes (power of 2) */
+
 /* here's the virtual YM2612 */
 typedef struct
 {
@@ -4743,11 +4941,36 @@ typedef struct
 	INT32       dacout;
 	UINT8       MuteDAC;
 	
+	/* timestamped DAC writes (ym2612_queue_dac), consumed by ym2612_update_one */
+	UINT32      dacQSmpl;           /* samples rendered so far (queue time base) */
+	UINT16      dacQHead;
+	UINT16      dacQTail;
+	UINT32      dacQPos[YM2612_DACQ_SIZE];
+	UINT8       dacQData[YM2612_DACQ_SIZE];
+	
 	UINT8       WaveOutMode;
 	INT32       WaveL;
 	INT32       WaveR;
 } YM2612;
 
+/* apply the queued DAC writes that are due before sample 'smpl' of the current update,
+   returns the sample of the next queued write (or 'length' if there is none before it) */
+static UINT32 ym2612_dac_queue_run(YM2612 *F2612, UINT32 smpl, UINT32 length)
+{
+	while (F2612->dacQHead != F2612->dacQTail)
+	{
+		INT32 ofs = (INT32)(F2612->dacQPos[F2612->dacQHead] - F2612->dacQSmpl);
+		if (ofs > (INT32)smpl)
+			return ((UINT32)ofs < length) ? (UINT32)ofs : length;
+		
+		/* same as writing register 0x2A */
+		F2612->dacout &= 0x01;
+		F2612->dacout |= ((int)F2612->dacQData[F2612->dacQHead] - 0x80) << 1;
+		F2612->dacQHead = (F2612->dacQHead + 1) & (YM2612_DACQ_SIZE - 1);
+	}
+	return length;
+}
+
 /* Generate samples for one of the YM2612s */
 void ym2612_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
 {
@@ -4759,8 +4982,7 @@ void ym2612_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
 	INT32 dacout;
 	FM_CH   *cch[6];
 	INT32 lt,rt;
-    static INT32 old_out_fm[6]; //YOYOFR
-    static UINT8 old_dacen; //YOYOFR
+	UINT32 dacNext;
 
 	/* set buffer */
 	if (buffer != NULL)
@@ -4781,6 +5003,7 @@ void ym2612_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
 	cch[4]   = &F2612->CH[4];
 	cch[5]   = &F2612->CH[5];
 	
+	dacNext = ym2612_dac_queue_run(F2612, 0, length);
 	if (! F2612->MuteDAC)
 		dacout = F2612->dacout << 5;    /* level unknown */
 	else
@@ -4820,23 +5043,25 @@ void ym2612_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
     //search first voice linked to current chip
     int m_voice_ofs=-1;
     int m_total_channels=6;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
-    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
 
 	/* buffering */
 	for(i=0; i < length ; i++)
 	{
+		/* queued DAC writes that are due at this sample */
+		if (i == dacNext)
+		{
+			dacNext = ym2612_dac_queue_run(F2612, i, length);
+			if (! F2612->MuteDAC)
+				dacout = F2612->dacout << 5;
+		}
+
 		/* clear outputs */
 		out_fm[0] = 0;
 		out_fm[1] = 0;
@@ -4980,17 +5205,18 @@ void ym2612_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
 			OPN->SL3.key_csm = 0;
 		}
 	}
+	F2612->dacQSmpl += length;
     
     //YOYOFR
     if (m_voice_ofs>=0)
         for (int ii=0;ii<6;ii++) {
             if (!(cch[ii]->Muted) ) {
                 if (cch[ii]->block_fnum==0) {
-                   if ((out_fm[ii]!=old_out_fm[ii])) {
+                   if ((out_fm[ii]!=OPN->old_out_fm[ii])) {
                         vgm_last_note[ii+m_voice_ofs]=220.0f; //arbitrary choosing A-3
                         vgm_last_instr[ii+m_voice_ofs]=ii+m_voice_ofs;
                         if ((ii==5)&&(F2612->dacen)) {
-                            if (!old_dacen) {
+                            if (!OPN->old_dacen) {
                                 vgm_last_vol[ii+m_voice_ofs]=2;
                             } else vgm_last_vol[ii+m_voice_ofs]=1;
                         } else {
@@ -5000,7 +5226,7 @@ void ym2612_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
                         }
                     }
                 } else {
-                    if ((out_fm[ii]!=old_out_fm[ii])) {
+                    if ((out_fm[ii]!=OPN->old_out_fm[ii])) {
                         int freq=(cch[ii]->block_fnum)&0x7FF;
                         int octave=((cch[ii]->block_fnum)>>11)&0x7;
                         vgm_last_note[ii+m_voice_ofs]=(freq<<octave)*110.0f/1081.0f; //1148.0f;
@@ -5014,8 +5240,8 @@ void ym2612_update_one(void *chip, UINT32 length, DEV_SMPL **buffer)
         }
     
     for (int ii=0;ii<6;ii++) {
-        old_out_fm[ii]=out_fm[ii];
-        old_dacen=F2612->dacen;
+        OPN->old_out_fm[ii]=out_fm[ii];
+        OPN->old_dacen=F2612->dacen;
     }
     //YOYOFR
 
@@ -5039,9 +5265,6 @@ void * ym2612_init(void *param, UINT32 clock, UINT32 rate,
 	if (F2612 == NULL)
 		return NULL;
 
-	/* allocate total level table (128kb space) */
-	init_tables();
-
 	/* FM */
 	F2612->OPN.ST.param = param;
 	F2612->OPN.type = TYPE_YM2612;
@@ -5116,6 +5339,8 @@ void ym2612_reset_chip(void *chip)
 	F2612->dacen = 0;
 	F2612->dac_test = 0;
 	F2612->dacout = 0;
+	F2612->dacQSmpl = 0;
+	F2612->dacQHead = F2612->dacQTail = 0;
 	
 	F2612->WaveOutMode >>= 1;
 	F2612->WaveL = F2612->WaveR = 0;
@@ -5133,6 +5358,10 @@ void ym2612_write(void *chip, UINT8 a, UINT8 v)
 
 	//v &= 0xff;  /* adjust to 8 bit bus */
 
+	/* queued DAC writes that are due now go first */
+	if (F2612->dacQHead != F2612->dacQTail)
+		ym2612_dac_queue_run(F2612, 0, 0);
+
 	switch( a&3 )
 	{
 	case 0: /* address port 0 */
@@ -5203,6 +5432,32 @@ void ym2612_write(void *chip, UINT8 a, UINT8 v)
 	return;
 }
 
+/* queue a write to the DAC data register (0x2A), to be applied 'smplOfs' samples
+   after the current render position. Writes must be queued in chronological order. */
+void ym2612_queue_dac(void *chip, UINT32 smplOfs, UINT8 v)
+{
+	YM2612 *F2612 = (YM2612 *)chip;
+	UINT16 next = (F2612->dacQTail + 1) & (YM2612_DACQ_SIZE - 1);
+	
+	if (next == F2612->dacQHead)
+	{
+		/* queue full: apply the oldest write early */
+		F2612->dacout &= 0x01;
+		F2612->dacout |= ((int)F2612->dacQData[F2612->dacQHead] - 0x80) << 1;
+		F2612->dacQHead = (F2612->dacQHead + 1) & (YM2612_DACQ_SIZE - 1);
+	}
+	F2612->dacQPos[F2612->dacQTail] = F2612->dacQSmpl + smplOfs;
+	F2612->dacQData[F2612->dacQTail] = v;
+	F2612->dacQTail = next;
+	
+	/* leave the register state as if the write was done now */
+	F2612->OPN.ST.address = 0x2a;
+	F2612->addr_A1 = 0;
+	F2612->REGS[0x2a] = v;
+	
+	return;
+}
+
 UINT8 ym2612_read(void *chip, UINT8 a)
 {
 	YM2612 *F2612 = (YM2612 *)chip;
@@ -5255,6 +5510,34 @@ void ym2612_set_mute_mask(void *chip, UINT32 MuteMask)
 	return;
 }
 
+/* state snapshots, see ym2610_save_state */
+UINT32 ym2612_save_state(void *chip, void *buffer)
+{
+	YM2612 *F2612 = (YM2612 *)chip;
+	
+	if (buffer != NULL)
+		memcpy(buffer, F2612, sizeof(YM2612));
+	return sizeof(YM2612);
+}
+
+void ym2612_load_state(void *chip, const void *buffer)
+{
+	YM2612 *F2612 = (YM2612 *)chip;
+	OPN_SETTINGS set;
+	UINT8 MuteDAC = F2612->MuteDAC;
+	UINT8 WaveOutMode = F2612->WaveOutMode;
+	
+	OPNGetSettings(&F2612->OPN, F2612->CH, &set);
+	memcpy(F2612, buffer, sizeof(YM2612));
+	OPNSetSettings(&F2612->OPN, F2612->CH, &set);
+	F2612->MuteDAC = MuteDAC;
+	F2612->WaveOutMode = WaveOutMode;
+	/* queued DAC writes belong to the render position the state was left at */
+	F2612->dacQHead = F2612->dacQTail = 0;
+	
+	return;
+}
+
 void ym2612_set_options(void *chip, UINT32 Flags)
 {
 	YM2612 *F2612 = (YM2612 *)chip;
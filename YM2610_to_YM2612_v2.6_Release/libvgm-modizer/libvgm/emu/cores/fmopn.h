@@ -161,6 +161,7 @@ UINT8 ym2608_read(void *chip, UINT8 a);
 UINT8 ym2608_timer_over(void *chip, UINT8 c );
 void ym2608_alloc_pcmromb(void* chip, UINT32 memsize);
 void ym2608_write_pcmromb(void* chip, UINT32 offset, UINT32 length, const UINT8* data);
+void ym2608_ref_pcmromb(void* chip, UINT32 offset, UINT32 length, const UINT8* data);
 
 void ym2608_set_mute_mask(void *chip, UINT32 MuteMask);
 void ym2608_set_log_cb(void* chip, DEVCB_LOG func, void* param);
@@ -184,10 +185,16 @@ UINT8 ym2610_read(void *chip, UINT8 a);
 UINT8 ym2610_timer_over(void *chip, UINT8 c );
 void ym2610_alloc_pcmroma(void* chip, UINT32 memsize);
 void ym2610_write_pcmroma(void* chip, UINT32 offset, UINT32 length, const UINT8* data);
+void ym2610_ref_pcmroma(void* chip, UINT32 offset, UINT32 length, const UINT8* data);
 void ym2610_alloc_pcmromb(void* chip, UINT32 memsize);
 void ym2610_write_pcmromb(void* chip, UINT32 offset, UINT32 length, const UINT8* data);
+void ym2610_ref_pcmromb(void* chip, UINT32 offset, UINT32 length, const UINT8* data);
 
 void ym2610_set_mute_mask(void *chip, UINT32 MuteMask);
+UINT32 ym2610_save_state(void *chip, void *buffer);
+void ym2610_load_state(void *chip, const void *buffer);
+void ym2610_set_options(void *chip, UINT32 Flags);
+void ym2610_set_adpcma_cache(void *chip, void *cache);
 void ym2610_set_log_cb(void* chip, DEVCB_LOG func, void* param);
 #endif /* (BUILD_YM2610||BUILD_YM2610B) */
 
@@ -199,10 +206,13 @@ void ym2612_reset_chip(void *chip);
 void ym2612_update_one(void *chip, UINT32 length, DEV_SMPL **buffer);
 
 void ym2612_write(void *chip, UINT8 a, UINT8 v);
+void ym2612_queue_dac(void *chip, UINT32 smplOfs, UINT8 v);
 UINT8 ym2612_read(void *chip, UINT8 a);
 UINT8 ym2612_timer_over(void *chip, UINT8 c );
 
 void ym2612_set_mute_mask(void *chip, UINT32 MuteMask);
+UINT32 ym2612_save_state(void *chip, void *buffer);
+void ym2612_load_state(void *chip, const void *buffer);
 void ym2612_set_options(void *chip, UINT32 Flags);
 void ym2612_set_log_cb(void* chip, DEVCB_LOG func, void* param);
 #endif /* (BUILD_YM2612||BUILD_YM3438) */
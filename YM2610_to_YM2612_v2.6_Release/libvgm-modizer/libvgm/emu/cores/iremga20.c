@@ -54,6 +54,7 @@ Revisions:
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
+#include "../modizer_voices.h"
 //TODO:  MODIZER changes end / YOYOFR
 
 static void IremGA20_update(void *param, UINT32 samples, DEV_SMPL **outputs);
@@ -177,24 +178,20 @@ static void IremGA20_update(void *param, UINT32 samples, DEV_SMPL **outputs)
 		return;
 	}
     
+#ifndef MODIZER_NO_OSCILLO
     //TODO:  MODIZER changes start / YOYOFR
     //search first voice linked to current chip
     int m_voice_ofs=-1;
     int m_total_channels=4;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
     int64_t smplIncr;
-    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
+#endif
 
 	for (i = 0; i < samples; i++)
 	{
@@ -204,6 +201,7 @@ static void IremGA20_update(void *param, UINT32 samples, DEV_SMPL **outputs)
 		{
 			ch = &chip->channel[j];
             if (ch->Muted || ! ch->play) {
+#ifndef MODIZER_NO_OSCILLO
                 //YOYOFR
                 if (m_voice_ofs>=0) {
                     int64_t ofs_end=(m_voice_current_ptr[m_voice_ofs+j]+smplIncr);
@@ -211,6 +209,7 @@ static void IremGA20_update(void *param, UINT32 samples, DEV_SMPL **outputs)
                     m_voice_current_ptr[m_voice_ofs+j]=ofs_end;
                 }
                 //YOYOFR
+#endif
                 continue;
             }
             
@@ -230,6 +229,7 @@ static void IremGA20_update(void *param, UINT32 samples, DEV_SMPL **outputs)
                 chanout=(smpl_int * (INT32)ch->volume) >> RATE_SHIFT; //YOYOFR
 			}
             
+#ifndef MODIZER_NO_OSCILLO
             //YOYOFR
             if (m_voice_ofs>=0) {
                 int64_t ofs_start=m_voice_current_ptr[m_voice_ofs+j];
@@ -260,6 +260,7 @@ static void IremGA20_update(void *param, UINT32 samples, DEV_SMPL **outputs)
                 }
             }
             //YOYOFR
+#endif
             
 			ch->frac += ch->fracrate;
 			ch->counter ++;
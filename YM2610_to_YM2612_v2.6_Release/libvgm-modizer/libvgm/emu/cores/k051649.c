@@ -43,6 +43,7 @@
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
+#include "../modizer_voices.h"
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -143,24 +144,20 @@ static void k051649_update(void *param, UINT32 samples, DEV_SMPL **outputs)
     DEV_SMPL *buffer2 = outputs[1];
     UINT32 i,j;
     
+#ifndef MODIZER_NO_OSCILLO
     //TODO:  MODIZER changes start / YOYOFR
     //search first voice linked to current chip
     int m_voice_ofs=-1;
     int m_total_channels=5;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
     int64_t smplIncr;
-    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
+#endif
     
     // zap the contents of the mixer buffer
     memset(buffer, 0, samples * sizeof(DEV_SMPL));
@@ -173,6 +170,7 @@ static void k051649_update(void *param, UINT32 samples, DEV_SMPL **outputs)
         {
             UINT32 step = (UINT32)(((INT64)info->mclock * (1 << FREQ_BITS)) / (float)((voice[j].frequency + 1) * info->rate / 2.0f) + 0.5f);
             
+#ifndef MODIZER_NO_OSCILLO
             //YOYOFR
             if (voice[j].key) {
                 int vol=voice[j].volume;
@@ -188,6 +186,7 @@ static void k051649_update(void *param, UINT32 samples, DEV_SMPL **outputs)
                 }
             }
             //YOYOFR
+#endif
             
             for (i = 0; i < samples; i++)
             {
@@ -201,6 +200,7 @@ static void k051649_update(void *param, UINT32 samples, DEV_SMPL **outputs)
                     smpl >>= 4;	// results in [-600 .. +600]
                     buffer[i] += smpl;
                     
+#ifndef MODIZER_NO_OSCILLO
                     //TODO:  MODIZER changes start / YOYOFR
                     if (m_voice_ofs>=0) {
                         int64_t ofs_start=m_voice_current_ptr[m_voice_ofs+j];
@@ -219,9 +219,11 @@ static void k051649_update(void *param, UINT32 samples, DEV_SMPL **outputs)
                         m_voice_current_ptr[m_voice_ofs+j]=ofs_end;
                     }
                     //TODO:  MODIZER changes end / YOYOFR
+#endif
                 }
             }
         } else {
+#ifndef MODIZER_NO_OSCILLO
             //TODO:  MODIZER changes start / YOYOFR
             if (m_voice_ofs>=0) {
                 int64_t ofs_start=m_voice_current_ptr[m_voice_ofs+j];
@@ -230,6 +232,7 @@ static void k051649_update(void *param, UINT32 samples, DEV_SMPL **outputs)
                     m_voice_current_ptr[m_voice_ofs+j]=ofs_end;
             }
             //TODO:  MODIZER changes end / YOYOFR
+#endif
         }
     }
     for (i = 0; i < samples; i++)
@@ -67,6 +67,7 @@
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
+#include "../modizer_voices.h"
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -421,24 +422,20 @@ static void k053260_update(void* param, UINT32 samples, DEV_SMPL **outputs)
 {
     k053260_state *info = (k053260_state *)param;
     
+#ifndef MODIZER_NO_OSCILLO
     //TODO:  MODIZER changes start / YOYOFR
     //search first voice linked to current chip
     int m_voice_ofs=-1;
     int m_total_channels=4;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
     int64_t smplIncr;
-    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
+#endif
     
     if ((info->mode & 2) && info->rom != NULL)
     {
@@ -458,6 +455,7 @@ static void k053260_update(void* param, UINT32 samples, DEV_SMPL **outputs)
                 if (info->voice[i].playing && !info->voice[i].Muted)
                     KDSC_play(&info->voice[i], buffer, cycles);
                 
+#ifndef MODIZER_NO_OSCILLO
                 //TODO:  MODIZER changes start / YOYOFR
                 if (m_voice_ofs>=0) {
                     int64_t ofs_start=m_voice_current_ptr[m_voice_ofs+i];
@@ -482,7 +480,9 @@ static void k053260_update(void* param, UINT32 samples, DEV_SMPL **outputs)
                     }
                 }
                 //TODO:  MODIZER changes end / YOYOFR
+#endif
                 
+#ifndef MODIZER_NO_OSCILLO
                 //YOYOFR
                 if (info->voice[i].playing && !info->voice[i].Muted) {
                     int vol=info->voice[i].volume;
@@ -499,6 +499,7 @@ static void k053260_update(void* param, UINT32 samples, DEV_SMPL **outputs)
                     }
                 }
                 //YOYOFR
+#endif
             }
             
             outputs[0][j] = buffer[0];
@@ -24,6 +24,7 @@
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
+#include "../modizer_voices.h"
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -211,24 +212,20 @@ static void k054539_update(void *param, UINT32 samples, DEV_SMPL **outputs)
 		return;
 	}
     
+#ifndef MODIZER_NO_OSCILLO
     //TODO:  MODIZER changes start / YOYOFR
     //search first voice linked to current chip
     int m_voice_ofs=-1;
     int m_total_channels=8;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
     int64_t smplIncr;
-    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
+#endif
     
     
 
@@ -419,6 +416,7 @@ static void k054539_update(void *param, UINT32 samples, DEV_SMPL **outputs)
 					base1[0x0e] = cur_pos>>16 & 0xff;
 				}
                 
+#ifndef MODIZER_NO_OSCILLO
                 //TODO:  MODIZER changes start / YOYOFR
                 if (m_voice_ofs>=0) {
                     int64_t ofs_start=m_voice_current_ptr[m_voice_ofs+ch];
@@ -434,7 +432,9 @@ static void k054539_update(void *param, UINT32 samples, DEV_SMPL **outputs)
                     m_voice_current_ptr[m_voice_ofs+ch]=ofs_end;
                 }
                 //TODO:  MODIZER changes end / YOYOFR
+#endif
                 
+#ifndef MODIZER_NO_OSCILLO
                 //YOYOFR
                 if (sample==0) {
                     float vol=lvol+rvol;
@@ -450,7 +450,9 @@ static void k054539_update(void *param, UINT32 samples, DEV_SMPL **outputs)
                     }
                 }
                 //YOYOFR
+#endif
             } else {
+#ifndef MODIZER_NO_OSCILLO
                 //TODO:  MODIZER changes start / YOYOFR
                 if (m_voice_ofs>=0) {
                     int64_t ofs_end=(m_voice_current_ptr[m_voice_ofs+ch]+smplIncr);
@@ -458,6 +460,7 @@ static void k054539_update(void *param, UINT32 samples, DEV_SMPL **outputs)
                     m_voice_current_ptr[m_voice_ofs+ch]=ofs_end;
                 }
                 //TODO:  MODIZER changes end / YOYOFR
+#endif
             }
 		info->reverb_pos = (info->reverb_pos + 1) & 0x1fff;
 		outputs[0][sample] = (DEV_SMPL)(lval);
@@ -49,6 +49,7 @@
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
+#include "../modizer_voices.h"
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -211,7 +212,7 @@ struct _MultiPCM
 };
 
 
-static UINT8 IsInit = 0;
+static EMU_ONCE IsInit = EMU_ONCE_INIT;
 
 static INT32 left_pan_table[0x800];
 static INT32 right_pan_table[0x800];
@@ -574,12 +575,10 @@ static UINT8 device_start_multipcm(const DEV_GEN_CFG* cfg, DEV_INFO* retDevInf)
 	ptChip->ROMMask = 0x00;
 	ptChip->rate = (float)cfg->clock / MULTIPCM_CLOCKDIV;
 
-	if (! IsInit)
+	if (emu_once_begin(&IsInit))
 	{
 	INT32 level;
 
-	IsInit = 1;
-
 	// Volume + pan table
 	for (level = 0; level < 0x80; ++level)
 	{
@@ -640,6 +639,7 @@ static UINT8 device_start_multipcm(const DEV_GEN_CFG* cfg, DEV_INFO* retDevInf)
 	}
 
 	lfo_init();
+	emu_once_end(&IsInit);
 	}
 
 	// Pitch steps
@@ -802,24 +802,20 @@ static void MultiPCM_update(void *info, UINT32 samples, DEV_SMPL **outputs)
 		return;
 	}
     
+#ifndef MODIZER_NO_OSCILLO
     //TODO:  MODIZER changes start / YOYOFR
     //search first voice linked to current chip
     int m_voice_ofs=-1;
     int m_total_channels=28;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
     int64_t smplIncr;
-    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
+#endif
 
 	for (i = 0; i < samples; ++i)
 	{
@@ -900,6 +896,7 @@ static void MultiPCM_update(void *info, UINT32 samples, DEV_SMPL **outputs)
 				smpl += (left_pan_table[vol] * sample) >> TL_SHIFT;
 				smpr += (right_pan_table[vol] * sample) >> TL_SHIFT;
                 
+#ifndef MODIZER_NO_OSCILLO
                 //TODO:  MODIZER changes start / YOYOFR
                 if (m_voice_ofs>=0) {
                     int64_t ofs_start=m_voice_current_ptr[m_voice_ofs+sl];
@@ -915,7 +912,9 @@ static void MultiPCM_update(void *info, UINT32 samples, DEV_SMPL **outputs)
                     m_voice_current_ptr[m_voice_ofs+sl]=ofs_end;
                 }
                 //TODO:  MODIZER changes end / YOYOFR
+#endif
                 
+#ifndef MODIZER_NO_OSCILLO
                 //YOYOFR
                 if (i==0) {
                     INT32 volume=left_pan_table[vol]+right_pan_table[vol];
@@ -931,10 +930,15 @@ static void MultiPCM_update(void *info, UINT32 samples, DEV_SMPL **outputs)
                     }
                 }
                 //YOYOFR
+#endif
             } else {
-                int64_t ofs_end=(m_voice_current_ptr[m_voice_ofs+sl]+smplIncr);
-                while ((ofs_end>>MODIZER_OSCILLO_OFFSET_FIXEDPOINT)>=SOUND_BUFFER_SIZE_SAMPLE*4*2) ofs_end-=(SOUND_BUFFER_SIZE_SAMPLE*4*2<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT);
-                m_voice_current_ptr[m_voice_ofs+sl]=ofs_end;
+#ifndef MODIZER_NO_OSCILLO
+                if (m_voice_ofs>=0) {
+                    int64_t ofs_end=(m_voice_current_ptr[m_voice_ofs+sl]+smplIncr);
+                    while ((ofs_end>>MODIZER_OSCILLO_OFFSET_FIXEDPOINT)>=SOUND_BUFFER_SIZE_SAMPLE*4*2) ofs_end-=(SOUND_BUFFER_SIZE_SAMPLE*4*2<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT);
+                    m_voice_current_ptr[m_voice_ofs+sl]=ofs_end;
+                }
+#endif
             }
 		}
 
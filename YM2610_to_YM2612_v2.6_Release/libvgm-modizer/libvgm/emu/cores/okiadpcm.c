@@ -13,6 +13,7 @@
 #include <math.h>
 
 #include "../../stdtype.h"
+#include "../EmuHelper.h"
 #include "okiadpcm.h"
 
 
@@ -21,7 +22,7 @@
 //**************************************************************************
 
 // ADPCM state and tables
-static UINT8 s_tables_computed = 0;
+static EMU_ONCE s_tables_computed = EMU_ONCE_INIT;
 static const INT8 s_index_shift[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
 static INT16 s_diff_lookup[49*16];
 
@@ -121,9 +122,8 @@ static void compute_tables(void)
 	int step, nib;
 
 	// skip if we already did it
-	if (s_tables_computed)
+	if (! emu_once_begin(&s_tables_computed))
 		return;
-	s_tables_computed = 1;
 
 	// loop over all possible steps
 	for (step = 0; step <= 48; step++)
@@ -141,6 +141,6 @@ static void compute_tables(void)
 					stepval/8);
 		}
 	}
-	
+	emu_once_end(&s_tables_computed);
 	return;
 }
@@ -139,7 +139,7 @@ static const int index_shift[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
 static int diff_lookup[49*16];
 
 /* tables computed? */
-static int tables_computed = 0;
+static EMU_ONCE tables_computed = EMU_ONCE_INIT;
 
 
 INLINE UINT32 ReadLE32(const UINT8* buffer)
@@ -176,7 +176,7 @@ static void compute_tables(void)
 
 	int step, nib;
 
-	if (tables_computed)
+	if (! emu_once_begin(&tables_computed))
 		return;
 	
 	/* loop over all possible steps */
@@ -196,7 +196,7 @@ static void compute_tables(void)
 		}
 	}
 
-	tables_computed = 1;
+	emu_once_end(&tables_computed);
 }
 
 
@@ -228,6 +228,7 @@ static INT16 clock_adpcm(okim6258_state *chip, UINT8 nibble)
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
+#include "../modizer_voices.h"
 #include <sys/types.h>
 //TODO:  MODIZER changes end / YOYOFR
 
@@ -248,18 +249,12 @@ static void okim6258_update(void *param, UINT32 samples, DEV_SMPL **outputs)
     //search first voice linked to current chip
     int m_voice_ofs=-1;
     int m_total_channels=1;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
-    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //printf("okim clock: %d\n",smplFreq);
     //TODO:  MODIZER changes end / YOYOFR
 
@@ -63,8 +63,9 @@
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
-static int m_voice_ofs;
-static int64_t smplIncr;
+#include "../modizer_voices.h"
+static MZV_THREAD_LOCAL int m_voice_ofs;
+static MZV_THREAD_LOCAL int64_t smplIncr;
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -276,6 +277,7 @@ static void generate_adpcm(okim6295_state *chip, okim_voice *voice, DEV_SMPL *bu
         INT16 val=oki_adpcm_clock(&voice->adpcm, nibble) * voice->volume / 2;
         buffer[i] += val;
         
+#ifndef MODIZER_NO_OSCILLO
         if (m_voice_ofs>=0) {
             int64_t ofs_start=m_voice_current_ptr[m_voice_ofs];
             int64_t ofs_end=(m_voice_current_ptr[m_voice_ofs]+smplIncr);
@@ -290,6 +292,7 @@ static void generate_adpcm(okim6295_state *chip, okim_voice *voice, DEV_SMPL *bu
             while ((ofs_end>>MODIZER_OSCILLO_OFFSET_FIXEDPOINT)>=SOUND_BUFFER_SIZE_SAMPLE*4*2) ofs_end-=(SOUND_BUFFER_SIZE_SAMPLE*4*2<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT);
             m_voice_current_ptr[m_voice_ofs+i]=ofs_end;
         }
+#endif
         //TODO:  MODIZER changes end / YOYOFR
 
 		// next!
@@ -314,24 +317,20 @@ static void okim6295_update(void* info, UINT32 samples, DEV_SMPL** outputs)
 	okim6295_state *chip = (okim6295_state *)info;
 	int i;
     
+#ifndef MODIZER_NO_OSCILLO
     //TODO:  MODIZER changes start / YOYOFR
     //search first voice linked to current chip
     int m_total_channels=4;
     m_voice_ofs=-1;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
-    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //printf("okim clock: %d\n",smplFreq);
     //TODO:  MODIZER changes end / YOYOFR
+#endif
 
 	// reset the output stream
 	memset(outputs[0], 0, samples * sizeof(*outputs[0]));
@@ -341,6 +340,7 @@ static void okim6295_update(void* info, UINT32 samples, DEV_SMPL** outputs)
 		// iterate over voices and accumulate sample data
         for (i = 0; i < OKIM6295_VOICES; i++) {
             
+#ifndef MODIZER_NO_OSCILLO
             //YOYOFR
             if (m_voice_ofs>=0) {
                 if (chip->voice[i].playing && chip->voice[i].volume && !(chip->voice[i].Muted)) {
@@ -353,10 +353,13 @@ static void okim6295_update(void* info, UINT32 samples, DEV_SMPL** outputs)
                 }
             }
             //YOYOFR
+#endif
             
             generate_adpcm(chip, &chip->voice[i], outputs[0], samples);
             
+#ifndef MODIZER_NO_OSCILLO
             if (m_voice_ofs>=0) m_voice_ofs++; //YOYOFR
+#endif
         }
 	}
 
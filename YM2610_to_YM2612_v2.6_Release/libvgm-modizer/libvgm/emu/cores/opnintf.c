@@ -86,6 +86,7 @@ static DEVDEF_RWFUNC devFunc_MAME_2608[] =
 	{RWF_REGISTER | RWF_READ, DEVRW_A8D8, 0, ym2608_read},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 'B', ym2608_write_pcmromb},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 'B', ym2608_alloc_pcmromb},
+	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCKREF, 'B', ym2608_ref_pcmromb},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, ym2608_set_mute_mask},
 	{0x00, 0x00, 0, NULL}
 };
@@ -122,9 +123,14 @@ static DEVDEF_RWFUNC devFunc_MAME_2610[] =
 	{RWF_REGISTER | RWF_READ, DEVRW_A8D8, 0, ym2610_read},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 'A', ym2610_write_pcmroma},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 'A', ym2610_alloc_pcmroma},
+	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCKREF, 'A', ym2610_ref_pcmroma},
+	{RWF_MEMORY | RWF_WRITE, DEVRW_CACHE, 'A', ym2610_set_adpcma_cache},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 'B', ym2610_write_pcmromb},
 	{RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 'B', ym2610_alloc_pcmromb},
+	{RWF_MEMORY | RWF_WRITE, DEVRW_BLOCKREF, 'B', ym2610_ref_pcmromb},
 	{RWF_CHN_MUTE | RWF_WRITE, DEVRW_ALL, 0, ym2610_set_mute_mask},
+	{RWF_STATE | RWF_READ, DEVRW_ALL, 0, ym2610_save_state},
+	{RWF_STATE | RWF_WRITE, DEVRW_ALL, 0, ym2610_load_state},
 	{0x00, 0x00, 0, NULL}
 };
 static DEV_DEF devDef_MAME_2610 =
@@ -136,7 +142,7 @@ static DEV_DEF devDef_MAME_2610 =
 	ym2610_reset_chip,
 	ym2610_update_one,
 	
-	NULL,	// SetOptionBits
+	ym2610_set_options,	// SetOptionBits
 	ym2610_set_mute_mask,	// SetMuteMask
 	NULL,	// SetPanning
 	NULL,	// SetSampleRateChangeCallback (not required, the YM2610 lacks the "prescaler" register)
@@ -154,7 +160,7 @@ static DEV_DEF devDef_MAME_2610B =
 	ym2610_reset_chip,
 	ym2610b_update_one,
 	
-	NULL,	// SetOptionBits
+	ym2610_set_options,	// SetOptionBits
 	ym2610_set_mute_mask,	 // SetMuteMask
 	NULL,	// SetPanning
 	NULL,	// SetSampleRateChangeCallback (not required, the YM2610 lacks the "prescaler" register)
@@ -5,6 +5,27 @@
 
 // YM2610 cfg.flags: 0 = YM2610 mode (4 FM channels), 1 = YM2610B mode (6 FM channels)
 
+#define OPT_YM2610_PCM_ONLY		0x01	// render ADPCM-A/B only, skip FM and the SSG (default: disabled)
+#define OPT_YM2610_ADPCMA_CACHE	0x02	// decode each ADPCM-A sample once and replay it from a cache (default: disabled)
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// ADPCM-A sample cache (OPT_YM2610_ADPCMA_CACHE)
+// Several YM2610s can use the same cache one after another (DEVRW_CACHE, PLR_DEV_OPTS::sampleCache),
+// so the songs of one game decode their common samples once. Samples are checked against the ROM before reuse.
+typedef struct _adpcma_cache ADPCMA_CACHE;
+ADPCMA_CACHE* ym2610_adpcma_cache_create(void);
+void ym2610_adpcma_cache_free(ADPCMA_CACHE* cache);
+// decoded: samples decoded so far, reused: samples kept over a ROM change
+void ym2610_adpcma_cache_stats(const ADPCMA_CACHE* cache, UINT32* decoded, UINT32* reused);
+
+#ifdef __cplusplus
+}
+#endif
+
 #ifdef SNDDEV_YM2203
 extern const DEV_DEF* devDefList_YM2203[];
 #endif
@@ -97,6 +97,7 @@
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
+#include "../modizer_voices.h"
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -881,30 +882,27 @@ void pokey_update(void *info, UINT32 samples, DEV_SMPL **outputs)
 	pokey_device *d = (pokey_device *)info;
 	UINT32 sampindex;
     
+#ifndef MODIZER_NO_OSCILLO
     //TODO:  MODIZER changes start / YOYOFR
     //search first voice linked to current chip
     int m_voice_ofs=-1;
     int m_total_channels=4;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
     int64_t smplIncr;
     int period[4];
-    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
+#endif
 
 	for(sampindex = 0; sampindex < samples; sampindex++)
 	{
 		pokey_execute_run(d);
         
+#ifndef MODIZER_NO_OSCILLO
         //YOYOFR
         if (sampindex==0) {
             int div=(d->m_AUDCTL&1?114:28);
@@ -946,6 +944,7 @@ void pokey_update(void *info, UINT32 samples, DEV_SMPL **outputs)
             }
         }
         //YOYOFR
+#endif
 
 		if (d->m_output_type == LEGACY_LINEAR)
 		{
@@ -954,6 +953,7 @@ void pokey_update(void *info, UINT32 samples, DEV_SMPL **outputs)
             for (i = 0; i < 4; i++) {
                 out += ((d->m_out_raw >> (4*i)) & 0x0f);
                 
+#ifndef MODIZER_NO_OSCILLO
                 //TODO:  MODIZER changes start / YOYOFR
                 if (m_voice_ofs>=0) {
                     int64_t ofs_start=m_voice_current_ptr[m_voice_ofs+i];
@@ -986,6 +986,7 @@ void pokey_update(void *info, UINT32 samples, DEV_SMPL **outputs)
                     }
                 }
                 //YOYOFR
+#endif
             }
             
             
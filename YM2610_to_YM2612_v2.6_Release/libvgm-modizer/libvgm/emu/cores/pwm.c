@@ -31,6 +31,7 @@
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
+#include "../modizer_voices.h"
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -104,6 +105,9 @@ struct _pwm_chip
 	//UINT8 PWM_Loudness;
 	
 	UINT32 clock;
+	
+	int last_out[2];			//YOYOFR
+	int last_out_same_cnt[2];	//YOYOFR
 };
 
 
@@ -184,24 +188,16 @@ static void PWM_Update(void* info, UINT32 length, DEV_SMPL **buf)
     
     //TODO:  MODIZER changes start / YOYOFR
     //search first voice linked to current chip
-    static int last_out[2];
-    static int last_out_same_cnt[2]={0,0};
     int m_voice_ofs=-1;
     int m_total_channels=2;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
     if (m_voice_ofs>=0) m_voicesForceOfs=m_voice_ofs;
     //printf("opn:%d / %lf delta:%lf\n",OPN->ST.rate,OPN->ST.freqbase,DELTAT->freqbase);
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
-    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
 	
 	// New PWM scaling algorithm provided by Chilly Willy on the Sonic Retro forums.
@@ -210,27 +206,27 @@ static void PWM_Update(void* info, UINT32 length, DEV_SMPL **buf)
     
     //YOYOFR
     if (m_voice_ofs>=0) {
-        int limit_silence=(int64_t)m_voice_current_samplerate*50/1000;  //50ms
-        if (last_out[0]==tmpOutL) last_out_same_cnt[0]+=length;
-        else last_out_same_cnt[0]=0;
-        if (last_out[1]==tmpOutR) last_out_same_cnt[1]+=length;
-        else last_out_same_cnt[1]=0;
+        int limit_silence=(int64_t)mzv_ctx->samplerate*50/1000;  //50ms
+        if (chip->last_out[0]==tmpOutL) chip->last_out_same_cnt[0]+=length;
+        else chip->last_out_same_cnt[0]=0;
+        if (chip->last_out[1]==tmpOutR) chip->last_out_same_cnt[1]+=length;
+        else chip->last_out_same_cnt[1]=0;
         
         if (chip->PWM_Cycle)
-            if (!(chip->PWM_Mute&1) && (last_out_same_cnt[0]<limit_silence) ) {
+            if (!(chip->PWM_Mute&1) && (chip->last_out_same_cnt[0]<limit_silence) ) {
             vgm_last_note[0+m_voice_ofs]=440.0f*((double)chip->clock/chip->PWM_Cycle)/22050.0f;
             vgm_last_instr[0+m_voice_ofs]=m_voice_ofs+0;
             int newvol=1;
             vgm_last_vol[0+m_voice_ofs]=newvol;
         }
-        if (!(chip->PWM_Mute&2) && (last_out_same_cnt[1]<limit_silence) ) {
+        if (!(chip->PWM_Mute&2) && (chip->last_out_same_cnt[1]<limit_silence) ) {
             vgm_last_note[1+m_voice_ofs]=440.0f*((double)chip->clock/chip->PWM_Cycle)/22050.0f;
             vgm_last_instr[1+m_voice_ofs]=m_voice_ofs+0;
             int newvol=1;
             vgm_last_vol[1+m_voice_ofs]=newvol;
         }
-        last_out[0]=tmpOutL;
-        last_out[1]=tmpOutR;
+        chip->last_out[0]=tmpOutL;
+        chip->last_out[1]=tmpOutR;
     }
     //YOYOFR
     
@@ -0,0 +1,215 @@
+// Paged sample memory that can reference ROM data in place.
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../stdtype.h"
+#include "../EmuHelper.h"
+#include "rommap.h"
+
+static const UINT8 rommap_fill[ROMMAP_PAGE_SIZE] =
+{
+#define FF8		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+#define FF64	FF8, FF8, FF8, FF8, FF8, FF8, FF8, FF8
+#define FF512	FF64, FF64, FF64, FF64, FF64, FF64, FF64, FF64
+	FF512, FF512
+#undef FF512
+#undef FF64
+#undef FF8
+};
+static const UINT8* rommap_nopage[1] = {rommap_fill};	// page table of an empty memory
+
+static UINT8* rommap_own_page(ROM_MAP* map, UINT32 pg);
+
+
+void rommap_init(ROM_MAP* map)
+{
+	map->page = rommap_nopage;
+	map->priv = NULL;
+	map->pageMask = 0x00;
+	map->size = 0x00;
+
+	return;
+}
+
+void rommap_free(ROM_MAP* map)
+{
+	UINT32 curPg;
+
+	if (map->priv != NULL)
+	{
+		for (curPg = 0; curPg <= map->pageMask; curPg ++)
+			free(map->priv[curPg]);
+		free(map->priv);
+		free((void*)map->page);
+	}
+	rommap_init(map);
+
+	return;
+}
+
+void rommap_alloc(ROM_MAP* map, UINT32 size)
+{
+	UINT32 pgCount;
+	UINT32 curPg;
+
+	rommap_free(map);
+	if (! size)
+		return;
+
+	pgCount = pow2_mask((size + ROMMAP_PAGE_MASK) >> ROMMAP_PAGE_BITS) + 1;
+	map->page = (const UINT8**)malloc(pgCount * sizeof(const UINT8*));
+	map->priv = (UINT8**)calloc(pgCount, sizeof(UINT8*));
+	if (map->page == NULL || map->priv == NULL)
+	{
+		free((void*)map->page);
+		free(map->priv);
+		rommap_init(map);
+		return;
+	}
+	for (curPg = 0; curPg < pgCount; curPg ++)
+		map->page[curPg] = rommap_fill;
+	map->pageMask = pgCount - 1;
+	map->size = size;
+
+	return;
+}
+
+static UINT8* rommap_own_page(ROM_MAP* map, UINT32 pg)
+{
+	UINT8* pgData = map->priv[pg];
+
+	if (pgData == NULL)
+	{
+		pgData = (UINT8*)malloc(ROMMAP_PAGE_SIZE);
+		if (pgData == NULL)
+			return NULL;
+		map->priv[pg] = pgData;
+	}
+	if (map->page[pg] != pgData)
+	{
+		memcpy(pgData, map->page[pg], ROMMAP_PAGE_SIZE);
+		map->page[pg] = pgData;
+	}
+	return pgData;
+}
+
+void rommap_write(ROM_MAP* map, UINT32 offset, UINT32 length, const UINT8* data)
+{
+	UINT8* pgData;
+	UINT32 pgOfs;
+	UINT32 wrtLen;
+
+	if (offset > map->size)
+		return;
+	if (offset + length > map->size)
+		length = map->size - offset;
+
+	while(length)
+	{
+		pgOfs = offset & ROMMAP_PAGE_MASK;
+		wrtLen = ROMMAP_PAGE_SIZE - pgOfs;
+		if (wrtLen > length)
+			wrtLen = length;
+		pgData = rommap_own_page(map, offset >> ROMMAP_PAGE_BITS);
+		if (pgData != NULL)
+			memcpy(&pgData[pgOfs], data, wrtLen);
+		offset += wrtLen;
+		data += wrtLen;
+		length -= wrtLen;
+	}
+
+	return;
+}
+
+void rommap_write_byte(ROM_MAP* map, UINT32 addr, UINT8 data)
+{
+	UINT8* pgData;
+
+	if (map->priv == NULL)
+		return;	// no memory
+	pgData = rommap_own_page(map, (addr >> ROMMAP_PAGE_BITS) & map->pageMask);
+	if (pgData != NULL)
+		pgData[addr & ROMMAP_PAGE_MASK] = data;
+
+	return;
+}
+
+void rommap_ref(ROM_MAP* map, UINT32 offset, UINT32 length, const UINT8* data)
+{
+	UINT32 curPg;
+	UINT32 wrtLen;
+
+	if (offset > map->size)
+		return;
+	if (offset + length > map->size)
+		length = map->size - offset;
+
+	// partly covered pages at the start and end of the block get copied
+	if (offset & ROMMAP_PAGE_MASK)
+	{
+		wrtLen = ROMMAP_PAGE_SIZE - (offset & ROMMAP_PAGE_MASK);
+		if (wrtLen > length)
+			wrtLen = length;
+		rommap_write(map, offset, wrtLen, data);
+		offset += wrtLen;
+		data += wrtLen;
+		length -= wrtLen;
+	}
+	while(length >= ROMMAP_PAGE_SIZE)
+	{
+		curPg = offset >> ROMMAP_PAGE_BITS;
+		free(map->priv[curPg]);
+		map->priv[curPg] = NULL;
+		map->page[curPg] = data;
+		offset += ROMMAP_PAGE_SIZE;
+		data += ROMMAP_PAGE_SIZE;
+		length -= ROMMAP_PAGE_SIZE;
+	}
+	if (length)
+		rommap_write(map, offset, length, data);
+
+	return;
+}
+
+void rommap_read(const ROM_MAP* map, UINT32 offset, UINT32 length, UINT8* data)
+{
+	UINT32 pgOfs;
+	UINT32 rdLen;
+
+	while(length)
+	{
+		pgOfs = offset & ROMMAP_PAGE_MASK;
+		rdLen = ROMMAP_PAGE_SIZE - pgOfs;
+		if (rdLen > length)
+			rdLen = length;
+		memcpy(data, &map->page[(offset >> ROMMAP_PAGE_BITS) & map->pageMask][pgOfs], rdLen);
+		offset += rdLen;
+		data += rdLen;
+		length -= rdLen;
+	}
+
+	return;
+}
+
+int rommap_compare(const ROM_MAP* map, UINT32 offset, UINT32 length, const UINT8* data)
+{
+	UINT32 pgOfs;
+	UINT32 cmpLen;
+	int retVal;
+
+	while(length)
+	{
+		pgOfs = offset & ROMMAP_PAGE_MASK;
+		cmpLen = ROMMAP_PAGE_SIZE - pgOfs;
+		if (cmpLen > length)
+			cmpLen = length;
+		retVal = memcmp(&map->page[(offset >> ROMMAP_PAGE_BITS) & map->pageMask][pgOfs], data, cmpLen);
+		if (retVal)
+			return retVal;
+		offset += cmpLen;
+		data += cmpLen;
+		length -= cmpLen;
+	}
+
+	return 0;
+}
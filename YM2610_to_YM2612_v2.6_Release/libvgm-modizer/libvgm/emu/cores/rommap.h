@@ -0,0 +1,44 @@
+#ifndef __ROMMAP_H__
+#define __ROMMAP_H__
+
+#include "../../stdtype.h"
+
+/* Paged sample ROM/RAM for the ADPCM units of the Yamaha chips.
+** Every page either points into memory that belongs to someone else (the loaded
+** file, a ROM image shared by several chips, the YM2608 internal ROM), into a
+** private copy owned by the map or to a shared page of 0xFF bytes.
+** So a large ROM costs no memory until it is written and data that is
+** referenced with rommap_ref() is never copied. */
+
+#define ROMMAP_PAGE_BITS	10
+#define ROMMAP_PAGE_SIZE	(1 << ROMMAP_PAGE_BITS)
+#define ROMMAP_PAGE_MASK	(ROMMAP_PAGE_SIZE - 1)
+
+typedef struct _rom_map
+{
+	const UINT8** page;	/* page data (the table size is a power of 2) */
+	UINT8** priv;		/* private page copies, NULL = none */
+	UINT32 pageMask;	/* page table size - 1 */
+	UINT32 size;		/* memory size in bytes */
+} ROM_MAP;
+
+/* Addresses outside the table wrap around. Pages past the memory size read as 0xFF. */
+#define ROMMAP_READ(map, addr)	((map)->page[((addr) >> ROMMAP_PAGE_BITS) & (map)->pageMask][(addr) & ROMMAP_PAGE_MASK])
+
+void rommap_init(ROM_MAP* map);
+void rommap_free(ROM_MAP* map);
+/* set the memory size, the whole memory is filled with 0xFF */
+void rommap_alloc(ROM_MAP* map, UINT32 size);
+/* copy data into the memory */
+void rommap_write(ROM_MAP* map, UINT32 offset, UINT32 length, const UINT8* data);
+void rommap_write_byte(ROM_MAP* map, UINT32 addr, UINT8 data);
+/* map data into the memory without copying it (only pages that are partly
+** covered are copied), data must stay valid until the range is written or
+** referenced again, the memory is resized or the map is freed */
+void rommap_ref(ROM_MAP* map, UINT32 offset, UINT32 length, const UINT8* data);
+/* copy memory contents to data (addresses wrap like ROMMAP_READ) */
+void rommap_read(const ROM_MAP* map, UINT32 offset, UINT32 length, UINT8* data);
+/* compare memory contents with data, 0 = equal (like memcmp) */
+int rommap_compare(const ROM_MAP* map, UINT32 offset, UINT32 length, const UINT8* data);
+
+#endif	// __ROMMAP_H__
@@ -28,6 +28,7 @@
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
+#include "../modizer_voices.h"
 //TODO:  MODIZER changes end / YOYOFR
 
 static void vsu_stream_update(void *param, UINT32 samples, DEV_SMPL **outputs);
@@ -523,24 +524,20 @@ static void vsu_stream_update(void *param, UINT32 samples, DEV_SMPL **outputs)
 	vsu_state* chip = (vsu_state*)param;
 	UINT32 curSmpl;
     
+#ifndef MODIZER_NO_OSCILLO
     //TODO:  MODIZER changes start / YOYOFR
     //search first voice linked to current chip
     int m_voice_ofs=-1;
     int m_total_channels=6;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
     int64_t smplIncr;
-    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
+#endif
 	
 	for (curSmpl = 0; curSmpl < samples; curSmpl ++)
 	{
@@ -556,6 +553,7 @@ static void vsu_stream_update(void *param, UINT32 samples, DEV_SMPL **outputs)
 		outputs[0][curSmpl] <<= 3;
 		outputs[1][curSmpl] <<= 3;
         
+#ifndef MODIZER_NO_OSCILLO
         //YOYOFR
         if (m_voice_ofs>=0) {
             for (int jj=0;jj<6;jj++) {
@@ -576,8 +574,10 @@ static void vsu_stream_update(void *param, UINT32 samples, DEV_SMPL **outputs)
             }
         }
         //YOYOFR
+#endif
 	}
     
+#ifndef MODIZER_NO_OSCILLO
     //YOYOFR
     for (int jj=0;jj<6;jj++) {
         if  ((chip->IntlControl[jj] & 0x80) && !(chip->Muted[jj]) ) {
@@ -597,6 +597,7 @@ static void vsu_stream_update(void *param, UINT32 samples, DEV_SMPL **outputs)
         }
     }
     //YOYOFR
+#endif
 	return;
 }
 
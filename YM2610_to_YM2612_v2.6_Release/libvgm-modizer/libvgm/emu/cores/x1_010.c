@@ -66,6 +66,7 @@ Registers:
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
+#include "../modizer_voices.h"
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -191,24 +192,20 @@ static void seta_update(void *param, UINT32 samples, DEV_SMPL **outputs)
 	if (info->rom == NULL)
 		return;
     
+#ifndef MODIZER_NO_OSCILLO
     //TODO:  MODIZER changes start / YOYOFR
     //search first voice linked to current chip
     int m_voice_ofs=-1;
     int m_total_channels=16;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
     int64_t smplIncr;
-    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
+#endif
 
 //	if( info->sound_enable == 0 ) return;
 
@@ -239,6 +236,7 @@ static void seta_update(void *param, UINT32 samples, DEV_SMPL **outputs)
                     if( start+delta >= end ) {
                         reg->status &= ~0x01;                   // Key off
                         
+#ifndef MODIZER_NO_OSCILLO
                         //YOYOFR
                         if (m_voice_ofs>=0) {
                             int jj=ch;
@@ -247,6 +245,7 @@ static void seta_update(void *param, UINT32 samples, DEV_SMPL **outputs)
                             m_voice_current_ptr[m_voice_ofs+jj]=ofs_end;
                         }
                         //YOYOFR
+#endif
                         
                         break;
                     }
@@ -255,6 +254,7 @@ static void seta_update(void *param, UINT32 samples, DEV_SMPL **outputs)
                     bufR[i] += (data*volR/256);
                     smp_offs += smp_step;
                     
+#ifndef MODIZER_NO_OSCILLO
                     //YOYOFR
                     if (m_voice_ofs>=0) {
                         int jj=ch;
@@ -272,9 +272,11 @@ static void seta_update(void *param, UINT32 samples, DEV_SMPL **outputs)
                         
                     }
                     //YOYOFR
+#endif
 				}
 				info->smp_offset[ch] = smp_offs;
                 
+#ifndef MODIZER_NO_OSCILLO
                 //YOYOFR
                 INT32 volume=volL+volR;
                 if (volume && (reg->status&1)) {
@@ -287,6 +289,7 @@ static void seta_update(void *param, UINT32 samples, DEV_SMPL **outputs)
                     }
                 }
                 //YOYOFR
+#endif
                 
 			} else {                                            // Wave form
 				start    = (INT8 *)&(info->reg[reg->volume*128+0x1000]);
@@ -310,6 +313,7 @@ static void seta_update(void *param, UINT32 samples, DEV_SMPL **outputs)
 					if( (reg->status&4) != 0 && delta >= 0x80 ) {
 						reg->status &= ~0x01;                   // Key off
                         
+#ifndef MODIZER_NO_OSCILLO
                         //YOYOFR
                         if (m_voice_ofs>=0) {
                             int jj=ch;
@@ -318,6 +322,7 @@ static void seta_update(void *param, UINT32 samples, DEV_SMPL **outputs)
                             m_voice_current_ptr[m_voice_ofs+jj]=ofs_end;
                         }
                         //YOYOFR
+#endif
                         
 						break;
 					}
@@ -330,6 +335,7 @@ static void seta_update(void *param, UINT32 samples, DEV_SMPL **outputs)
 					smp_offs += smp_step;
 					env_offs += env_step;
                     
+#ifndef MODIZER_NO_OSCILLO
                     //YOYOFR
                     if (m_voice_ofs>=0) {
                         int jj=ch;
@@ -346,10 +352,12 @@ static void seta_update(void *param, UINT32 samples, DEV_SMPL **outputs)
                         m_voice_current_ptr[m_voice_ofs+jj]=ofs_end;
                     }
                     //YOYOFR
+#endif
 				}
 				info->smp_offset[ch] = smp_offs;
 				info->env_offset[ch] = env_offs;
                 
+#ifndef MODIZER_NO_OSCILLO
                 //YOYOFR
                 INT32 volume=volL+volR;
                 if (volume && (reg->status&1)) {
@@ -362,6 +370,7 @@ static void seta_update(void *param, UINT32 samples, DEV_SMPL **outputs)
                     }
                 }
                 //YOYOFR
+#endif
 			}
 		}
 	}
@@ -527,16 +527,15 @@ static const UINT8 lfo_noise_waveform[256] = {
 
 
 
-static UINT8 tablesInit = 0;
+static EMU_ONCE tablesInit = EMU_ONCE_INIT;
 
 static void init_tables(void)
 {
 	signed int i,x,n;
 	double o,m;
 
-	if (tablesInit)
+	if (! emu_once_begin(&tablesInit))
 		return;
-	tablesInit = 1;
 
 	for (x=0; x<TL_RES_LEN; x++)
 	{
@@ -591,6 +590,8 @@ static void init_tables(void)
 	{
 		d1l_tab[i] = (i!=15 ? i : i+16) * (4.0/ENV_STEP);   /* every 3 'dB' except for all bits = 1 = 45+48 'dB' */
 	}
+
+	emu_once_end(&tablesInit);
 }
 
 
@@ -1950,6 +1951,7 @@ INLINE void advance(YM2151 *PSG)
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
+#include "../modizer_voices.h"
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -1965,24 +1967,18 @@ static void ym2151_update_one(void *chip, UINT32 length, DEV_SMPL **buffers)
 	UINT32 i;
 	int ch;
 	DEV_SMPL outl, outr;
-    static INT32 last_chanout[8]; //YOYOFR
+    static MZV_THREAD_LOCAL INT32 last_chanout[8]; //YOYOFR
     
     //TODO:  MODIZER changes start / YOYOFR
     //search first voice linked to current chip
     int m_voice_ofs=-1;
     int m_total_channels=8;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
-    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
     
     //YOYOFR
@@ -598,7 +598,7 @@ static unsigned char vrc7_instable[(16 + 3) * 8] =
 #define SLOT8_2 (&chip->P_CH[8].SLOT[SLOT2])
 
 
-static UINT8 tablesInit = 0;
+static EMU_ONCE tablesInit = EMU_ONCE_INIT;
 
 /* advance LFO to next sample */
 INLINE void advance_lfo(YM2413 *chip)
@@ -1122,9 +1122,8 @@ static int init_tables(void)
 	signed int n;
 	double o,m;
 
-	if (tablesInit)
+	if (! emu_once_begin(&tablesInit))
 		return 1;
-	tablesInit = 1;
 
 	for (x=0; x<TL_RES_LEN; x++)
 	{
@@ -1180,6 +1179,7 @@ static int init_tables(void)
 			sin_tab[1*SIN_LEN+i] = sin_tab[i];
 	}
 
+	emu_once_end(&tablesInit);
 	return 1;
 }
 
@@ -39,9 +39,7 @@
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
-static int m_voice_ofs=-1;
-static int64_t smplIncr;
-static int cur_chan=0;
+#include "../modizer_voices.h"
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -1365,7 +1363,7 @@ void NOPN2_Clock(ym3438_t *chip, Bit32s *buffer)
     buffer[0] = chip->mol;
     buffer[1] = chip->mor;
     
-    chip->chan_out[cur_chan]+=chip->mol+chip->mor; //YOYOFR
+    chip->chan_out[chip->cur_chan]+=chip->mol+chip->mor; //YOYOFR
     
 
     if (chip->status_time)
@@ -1519,27 +1517,27 @@ void NOPN2_GenerateResampled(ym3438_t *chip, Bit32s *buf)
             switch (chip->cycles >> 2)
             {
             case 0: // Ch 2
-                    cur_chan=1;//YOYOFR
+                    chip->cur_chan=1;//YOYOFR
                 mute = chip->mute[1];
                 break;
             case 1: // Ch 6, DAC
-                    cur_chan=5;//YOYOFR
+                    chip->cur_chan=5;//YOYOFR
                 mute = chip->mute[5 + chip->dacen];
                 break;
             case 2: // Ch 4
-                    cur_chan=3;//YOYOFR
+                    chip->cur_chan=3;//YOYOFR
                 mute = chip->mute[3];
                 break;
             case 3: // Ch 1
-                    cur_chan=0;//YOYOFR
+                    chip->cur_chan=0;//YOYOFR
                 mute = chip->mute[0];
                 break;
             case 4: // Ch 5
-                    cur_chan=4;//YOYOFR
+                    chip->cur_chan=4;//YOYOFR
                 mute = chip->mute[4];
                 break;
             case 5: // Ch 3
-                    cur_chan=2;//YOYOFR
+                    chip->cur_chan=2;//YOYOFR
                 mute = chip->mute[2];
                 break;
             default:
@@ -1568,26 +1566,28 @@ void NOPN2_GenerateResampled(ym3438_t *chip, Bit32s *buf)
         }
         
         
+#ifndef MODIZER_NO_OSCILLO
         //TODO:  MODIZER changes start / YOYOFR
-        if (m_voice_ofs>=0) {
+        if (chip->voice_ofs>=0) {
             for (int jj=0;jj<6;jj++) {
-                int64_t ofs_start=m_voice_current_ptr[m_voice_ofs+jj];
-                int64_t ofs_end=(m_voice_current_ptr[m_voice_ofs+jj]+smplIncr);
+                int64_t ofs_start=m_voice_current_ptr[chip->voice_ofs+jj];
+                int64_t ofs_end=(m_voice_current_ptr[chip->voice_ofs+jj]+chip->voice_smplIncr);
                 
                 
                 if (!chip->mute[jj] && (ofs_end>ofs_start))
                 for (;;) {
-                    m_voice_buff[m_voice_ofs+jj][(ofs_start>>MODIZER_OSCILLO_OFFSET_FIXEDPOINT)&(SOUND_BUFFER_SIZE_SAMPLE*4*2-1)]=LIMIT8(((chip->chan_out[jj])>>4));
+                    m_voice_buff[chip->voice_ofs+jj][(ofs_start>>MODIZER_OSCILLO_OFFSET_FIXEDPOINT)&(SOUND_BUFFER_SIZE_SAMPLE*4*2-1)]=LIMIT8(((chip->chan_out[jj])>>4));
                     
                     ofs_start+=1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT;
                     if (ofs_start>=ofs_end) break;
                 }
                 
                 while ((ofs_end>>MODIZER_OSCILLO_OFFSET_FIXEDPOINT)>=SOUND_BUFFER_SIZE_SAMPLE*4*2) ofs_end-=(SOUND_BUFFER_SIZE_SAMPLE*4*2<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT);
-                m_voice_current_ptr[m_voice_ofs+jj]=ofs_end;
+                m_voice_current_ptr[chip->voice_ofs+jj]=ofs_end;
             }
         }
         //YOYOFR
+#endif
         
         
         if(!chip->use_filter)
@@ -1618,62 +1618,56 @@ void nukedopn2_update(void *chip, UINT32 numsamples, DEV_SMPL **sndptr)
     smpl = sndptr[0];
     smpr = sndptr[1];
     
+#ifndef MODIZER_NO_OSCILLO
     //TODO:  MODIZER changes start / YOYOFR
     //search first voice linked to current chip
-    static INT32 old_out_fm[6]; //YOYOFR
-    static UINT8 old_dacen; //YOYOFR
     
     int m_total_channels=6;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    opn2->voice_ofs=modizer_voices_find_slot(m_total_channels);
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
-    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    opn2->voice_smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
 
     
     //YOYOFR
-    if (m_voice_ofs>=0)
+    if (opn2->voice_ofs>=0)
         for (int ii=0;ii<6;ii++) {
             if (!(opn2->mute[ii])) {
                 if (opn2->fnum[ii]==0) {
-                    if ((opn2->ch_out[ii]!=old_out_fm[ii])) {
-                        vgm_last_note[ii+m_voice_ofs]=220.0f; //arbitrary choosing A-3
-                        vgm_last_instr[ii+m_voice_ofs]=ii+m_voice_ofs;
+                    if ((opn2->ch_out[ii]!=opn2->old_out_fm[ii])) {
+                        vgm_last_note[ii+opn2->voice_ofs]=220.0f; //arbitrary choosing A-3
+                        vgm_last_instr[ii+opn2->voice_ofs]=ii+opn2->voice_ofs;
                         if ((ii==5)&&(opn2->dacen)) {
-                            if (!old_dacen) {
-                                vgm_last_vol[ii+m_voice_ofs]=2;
-                            } else vgm_last_vol[ii+m_voice_ofs]=1;
+                            if (!opn2->old_dacen) {
+                                vgm_last_vol[ii+opn2->voice_ofs]=2;
+                            } else vgm_last_vol[ii+opn2->voice_ofs]=1;
                         } else {
                             int newvol=1;//cch[ii]->keyon_triggered+1;
-                            vgm_last_vol[ii+m_voice_ofs]=newvol;
+                            vgm_last_vol[ii+opn2->voice_ofs]=newvol;
                         }
                     }
                 } else {
-                    if ((opn2->ch_out[ii]!=old_out_fm[ii])) {
+                    if ((opn2->ch_out[ii]!=opn2->old_out_fm[ii])) {
                         int freq=opn2->fnum[ii];
                         int octave=opn2->block[ii];
-                        vgm_last_note[ii+m_voice_ofs]=(freq<<octave)*110.0f/1081.0f; //1148.0f;
-                        vgm_last_instr[ii+m_voice_ofs]=ii+m_voice_ofs;
+                        vgm_last_note[ii+opn2->voice_ofs]=(freq<<octave)*110.0f/1081.0f; //1148.0f;
+                        vgm_last_instr[ii+opn2->voice_ofs]=ii+opn2->voice_ofs;
                         int newvol=1;//cch[ii]->keyon_triggered+1;
-                            vgm_last_vol[ii+m_voice_ofs]=newvol;
+                            vgm_last_vol[ii+opn2->voice_ofs]=newvol;
                     }
                 }
             }
         }
     
     for (int ii=0;ii<6;ii++) {
-        old_out_fm[ii]=opn2->ch_out[ii];
-        old_dacen=opn2->dacen;
+        opn2->old_out_fm[ii]=opn2->ch_out[ii];
+        opn2->old_dacen=opn2->dacen;
     }
     //YOYOFR
+#endif
 
     for (i = 0; i < numsamples; i++)
     {
@@ -76,6 +76,11 @@ typedef struct
     
     
     Bit32s chan_out[6]; //YOYOFR
+    Bit32u cur_chan;    //YOYOFR: channel that chan_out is collected for
+    int voice_ofs;      //YOYOFR: first oscilloscope voice, -1 = none
+    Bit64s voice_smplIncr; //YOYOFR
+    Bit32s old_out_fm[6]; //YOYOFR
+    Bit8u old_dacen;    //YOYOFR
     
     /* IO */
     Bit16u write_data;
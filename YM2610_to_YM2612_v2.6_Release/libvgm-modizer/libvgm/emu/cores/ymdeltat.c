@@ -120,7 +120,7 @@ UINT8 YM_DELTAT_ADPCM_Read(YM_DELTAT *DELTAT)
 
 		if ( DELTAT->now_addr != (DELTAT->end<<1) )
 		{
-			v = DELTAT->memory[(DELTAT->now_addr>>1)&DELTAT->memory_mask];
+			v = ROMMAP_READ(&DELTAT->memory, (DELTAT->now_addr>>1)&DELTAT->memory_mask);
 
 			/*emu_logf(DELTAT->logger, DEVLOG_TRACE, "YM Delta-T memory read  $%08x, v=$%02x\n", DELTAT->now_addr >> 1, v);*/
 
@@ -228,7 +228,7 @@ value:   START, REC, MEMDAT, REPEAT, SPOFF, x,x,RESET   meaning:
 			DELTAT->memread = 2;	/* two dummy reads needed before accesing external memory via register $08*/
 
 			/* if yes, then let's check if ADPCM memory is mapped and big enough */
-			if(DELTAT->memory == NULL)
+			if(! DELTAT->memory_size)
 			{
 				emu_logf(DELTAT->logger, DEVLOG_WARN, "Delta-T ADPCM rom not mapped\n");
 				DELTAT->portstate = 0x00;
@@ -343,7 +343,7 @@ value:   START, REC, MEMDAT, REPEAT, SPOFF, x,x,RESET   meaning:
 
 			if ( DELTAT->now_addr != (DELTAT->end<<1) )
 			{
-				DELTAT->memory[(DELTAT->now_addr>>1)&DELTAT->memory_mask] = v;
+				rommap_write_byte(&DELTAT->memory, (DELTAT->now_addr>>1)&DELTAT->memory_mask, v);
 				DELTAT->now_addr+=2; /* two nibbles at a time */
 
 				/* reset BRDY bit in status register, which means we are processing the write */
@@ -472,6 +472,25 @@ void YM_DELTAT_ADPCM_Reset(YM_DELTAT *DELTAT,int pan)
 		(DELTAT->status_set_handler)(DELTAT->status_change_which_chip, DELTAT->status_change_BRDY_bit);
 }
 
+/* restore the playback state from a copy of this unit made earlier
+** (sample memory and the output/status hookup stay those of DELTAT) */
+void YM_DELTAT_ADPCM_LoadState(YM_DELTAT *DELTAT, const YM_DELTAT *state)
+{
+	DEV_LOGGER *logger = DELTAT->logger;
+	ROM_MAP memory = DELTAT->memory;
+	UINT32 memory_size = DELTAT->memory_size;
+	UINT32 memory_mask = DELTAT->memory_mask;
+	INT32 *output_pointer = DELTAT->output_pointer;
+
+	*DELTAT = *state;
+	DELTAT->logger = logger;
+	DELTAT->memory = memory;
+	DELTAT->memory_size = memory_size;
+	DELTAT->memory_mask = memory_mask;
+	DELTAT->output_pointer = output_pointer;
+	DELTAT->pan = &output_pointer[state->pan - state->output_pointer];
+}
+
 
 #define YM_DELTAT_Limit(val,max,min)	\
 {										\
@@ -479,73 +498,87 @@ void YM_DELTAT_ADPCM_Reset(YM_DELTAT *DELTAT,int pan)
 	else if ( val < min ) val = min;	\
 }
 
-INLINE void YM_DELTAT_synthesis_from_external_memory(YM_DELTAT *DELTAT)
+/* limit/end address checks done before each nibble; returns 0 on End Of Sample */
+INLINE UINT8 YM_DELTAT_check_address(YM_DELTAT *DELTAT)
+{
+	if ( DELTAT->now_addr == (DELTAT->limit<<1) )
+		DELTAT->now_addr = 0;
+
+	if ( DELTAT->now_addr == (DELTAT->end<<1) ) {	/* 12-06-2001 JB: corrected comparison. Was > instead of == */
+		if( DELTAT->portstate&0x10 ){
+			/* repeat start */
+			DELTAT->now_addr = DELTAT->start<<1;
+			DELTAT->acc      = 0;
+			DELTAT->adpcmd   = YM_DELTAT_DELTA_DEF;
+			DELTAT->prev_acc = 0;
+		}else{
+			/* set EOS bit in status register */
+			if(DELTAT->status_set_handler != NULL && DELTAT->status_change_EOS_bit)
+				(DELTAT->status_set_handler)(DELTAT->status_change_which_chip, DELTAT->status_change_EOS_bit);
+
+			/* clear PCM BUSY bit (reflected in status register) */
+			DELTAT->PCM_BSY = 0;
+
+			DELTAT->portstate = 0;
+			DELTAT->adpcml = 0;
+			DELTAT->prev_acc = 0;
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/* decode the nibble at now_addr from external memory */
+INLINE void YM_DELTAT_decode_nibble(YM_DELTAT *DELTAT)
 {
-	UINT32 step;
 	int data;
 
-	DELTAT->now_step += DELTAT->step;
-	if ( DELTAT->now_step >= (1<<YM_DELTAT_SHIFT) )
+	if( DELTAT->now_addr&1 ) data = DELTAT->now_data & 0x0f;
+	else
 	{
-		step = DELTAT->now_step >> YM_DELTAT_SHIFT;
-		DELTAT->now_step &= (1<<YM_DELTAT_SHIFT)-1;
-		do{
+		DELTAT->now_data = ROMMAP_READ(&DELTAT->memory, (DELTAT->now_addr>>1)&DELTAT->memory_mask);
+		data = DELTAT->now_data >> 4;
+	}
 
-			if ( DELTAT->now_addr == (DELTAT->limit<<1) )
-				DELTAT->now_addr = 0;
-
-			if ( DELTAT->now_addr == (DELTAT->end<<1) ) {	/* 12-06-2001 JB: corrected comparison. Was > instead of == */
-				if( DELTAT->portstate&0x10 ){
-					/* repeat start */
-					DELTAT->now_addr = DELTAT->start<<1;
-					DELTAT->acc      = 0;
-					DELTAT->adpcmd   = YM_DELTAT_DELTA_DEF;
-					DELTAT->prev_acc = 0;
-				}else{
-					/* set EOS bit in status register */
-					if(DELTAT->status_set_handler != NULL && DELTAT->status_change_EOS_bit)
-						(DELTAT->status_set_handler)(DELTAT->status_change_which_chip, DELTAT->status_change_EOS_bit);
-
-					/* clear PCM BUSY bit (reflected in status register) */
-					DELTAT->PCM_BSY = 0;
+	DELTAT->now_addr++;
+	/* 12-06-2001 JB: */
+	/* YM2610 address register is 24 bits wide.*/
+	/* The "+1" is there because we use 1 bit more for nibble calculations.*/
+	/* WARNING: */
+	/* Side effect: we should take the size of the mapped ROM into account */
+	//DELTAT->now_addr &= ( (1<<(24+1))-1);
+	DELTAT->now_addr &= DELTAT->address_mask;
+	
 
-					DELTAT->portstate = 0;
-					DELTAT->adpcml = 0;
-					DELTAT->prev_acc = 0;
-					return;
-				}
-			}
+	/* store accumulator value */
+	DELTAT->prev_acc = DELTAT->acc;
 
-			if( DELTAT->now_addr&1 ) data = DELTAT->now_data & 0x0f;
-			else
-			{
-				DELTAT->now_data = DELTAT->memory[(DELTAT->now_addr>>1)&DELTAT->memory_mask];
-				data = DELTAT->now_data >> 4;
-			}
+	/* Forecast to next Forecast */
+	DELTAT->acc += (ym_deltat_decode_tableB1[data] * DELTAT->adpcmd / 8);
+	YM_DELTAT_Limit(DELTAT->acc,YM_DELTAT_DECODE_MAX, YM_DELTAT_DECODE_MIN);
 
-			DELTAT->now_addr++;
-			/* 12-06-2001 JB: */
-			/* YM2610 address register is 24 bits wide.*/
-			/* The "+1" is there because we use 1 bit more for nibble calculations.*/
-			/* WARNING: */
-			/* Side effect: we should take the size of the mapped ROM into account */
-			//DELTAT->now_addr &= ( (1<<(24+1))-1);
-			DELTAT->now_addr &= DELTAT->address_mask;
-			
+	/* delta to next delta */
+	DELTAT->adpcmd = (DELTAT->adpcmd * ym_deltat_decode_tableB2[data] ) / 64;
+	YM_DELTAT_Limit(DELTAT->adpcmd,YM_DELTAT_DELTA_MAX, YM_DELTAT_DELTA_MIN );
 
-			/* store accumulator value */
-			DELTAT->prev_acc = DELTAT->acc;
+	/* ElSemi: Fix interpolator. */
+	/*DELTAT->prev_acc = prev_acc + ((DELTAT->acc - prev_acc) / 2 );*/
+}
 
-			/* Forecast to next Forecast */
-			DELTAT->acc += (ym_deltat_decode_tableB1[data] * DELTAT->adpcmd / 8);
-			YM_DELTAT_Limit(DELTAT->acc,YM_DELTAT_DECODE_MAX, YM_DELTAT_DECODE_MIN);
+INLINE void YM_DELTAT_synthesis_from_external_memory(YM_DELTAT *DELTAT)
+{
+	UINT32 step;
 
-			/* delta to next delta */
-			DELTAT->adpcmd = (DELTAT->adpcmd * ym_deltat_decode_tableB2[data] ) / 64;
-			YM_DELTAT_Limit(DELTAT->adpcmd,YM_DELTAT_DELTA_MAX, YM_DELTAT_DELTA_MIN );
+	DELTAT->now_step += DELTAT->step;
+	if ( DELTAT->now_step >= (1<<YM_DELTAT_SHIFT) )
+	{
+		step = DELTAT->now_step >> YM_DELTAT_SHIFT;
+		DELTAT->now_step &= (1<<YM_DELTAT_SHIFT)-1;
+		do{
 
-			/* ElSemi: Fix interpolator. */
-			/*DELTAT->prev_acc = prev_acc + ((DELTAT->acc - prev_acc) / 2 );*/
+			if (! YM_DELTAT_check_address(DELTAT))
+				return;
+			YM_DELTAT_decode_nibble(DELTAT);
 
 		}while(--step);
 
@@ -560,6 +593,119 @@ INLINE void YM_DELTAT_synthesis_from_external_memory(YM_DELTAT *DELTAT)
 	*(DELTAT->pan) += DELTAT->adpcml;
 }
 
+/* number of nibbles from now_addr until it equals target (the address counter wraps at address_mask) */
+INLINE UINT32 YM_DELTAT_nibbles_until(const YM_DELTAT *DELTAT, UINT32 target)
+{
+	if (DELTAT->now_addr > DELTAT->address_mask)
+		return 0;	/* not wrapped yet, leave it to the checked path */
+	if (target > DELTAT->address_mask)
+		return 0xFFFFFFFF;	/* never reached */
+	if (target >= DELTAT->now_addr)
+		return target - DELTAT->now_addr;
+	return (DELTAT->address_mask - DELTAT->now_addr) + 1 + target;
+}
+
+/* Block version of YM_DELTAT_synthesis_from_external_memory: renders up to
+** length samples into buf and returns how many were rendered. Between limit/end
+** boundaries the nibbles are decoded without address checks, the boundary
+** nibbles themselves go through YM_DELTAT_check_address as usual.
+** Stops early when the sample ends (EOS), the last sample is then 0. */
+static UINT32 YM_DELTAT_block_from_external_memory(YM_DELTAT *DELTAT, INT32 *buf, UINT32 length)
+{
+	const ROM_MAP memory = DELTAT->memory;
+	UINT32 memory_mask  = DELTAT->memory_mask;
+	UINT32 address_mask = DELTAT->address_mask;
+	UINT32 now_step     = DELTAT->now_step;
+	UINT32 step         = DELTAT->step;
+	UINT32 now_addr     = DELTAT->now_addr;
+	UINT8  now_data     = DELTAT->now_data;
+	INT32  acc          = DELTAT->acc;
+	INT32  prev_acc     = DELTAT->prev_acc;
+	INT32  adpcmd       = DELTAT->adpcmd;
+	INT32  volume       = DELTAT->volume;
+	UINT32 run;		/* nibbles that can be decoded before a check could trigger */
+	UINT32 i;
+	UINT32 nibbles;
+	int data;
+
+	run = YM_DELTAT_nibbles_until(DELTAT, DELTAT->limit<<1);
+	nibbles = YM_DELTAT_nibbles_until(DELTAT, DELTAT->end<<1);
+	if (nibbles < run)
+		run = nibbles;
+
+	for (i = 0; i < length; i++)
+	{
+		now_step += step;
+		if ( now_step >= (1<<YM_DELTAT_SHIFT) )
+		{
+			nibbles = now_step >> YM_DELTAT_SHIFT;
+			now_step &= (1<<YM_DELTAT_SHIFT)-1;
+			if (nibbles <= run)
+			{
+				run -= nibbles;
+				do{
+					if( now_addr&1 ) data = now_data & 0x0f;
+					else
+					{
+						now_data = ROMMAP_READ(&memory, (now_addr>>1)&memory_mask);
+						data = now_data >> 4;
+					}
+					now_addr = (now_addr + 1) & address_mask;
+
+					prev_acc = acc;
+					acc += (ym_deltat_decode_tableB1[data] * adpcmd / 8);
+					YM_DELTAT_Limit(acc,YM_DELTAT_DECODE_MAX, YM_DELTAT_DECODE_MIN);
+					adpcmd = (adpcmd * ym_deltat_decode_tableB2[data] ) / 64;
+					YM_DELTAT_Limit(adpcmd,YM_DELTAT_DELTA_MAX, YM_DELTAT_DELTA_MIN );
+				}while(--nibbles);
+			}
+			else
+			{
+				/* a limit/end boundary is crossed: take the checked path */
+				DELTAT->now_addr = now_addr;
+				DELTAT->now_data = now_data;
+				DELTAT->acc      = acc;
+				DELTAT->prev_acc = prev_acc;
+				DELTAT->adpcmd   = adpcmd;
+				do{
+					if (! YM_DELTAT_check_address(DELTAT))
+					{
+						DELTAT->now_step = now_step;
+						buf[i] = 0;
+						return i + 1;
+					}
+					YM_DELTAT_decode_nibble(DELTAT);
+				}while(--nibbles);
+				now_addr = DELTAT->now_addr;
+				now_data = DELTAT->now_data;
+				acc      = DELTAT->acc;
+				prev_acc = DELTAT->prev_acc;
+				adpcmd   = DELTAT->adpcmd;
+
+				run = YM_DELTAT_nibbles_until(DELTAT, DELTAT->limit<<1);
+				nibbles = YM_DELTAT_nibbles_until(DELTAT, DELTAT->end<<1);
+				if (nibbles < run)
+					run = nibbles;
+			}
+		}
+
+		/* ElSemi: Fix interpolator. */
+		buf[i] = prev_acc * (int)((1<<YM_DELTAT_SHIFT)-now_step);
+		buf[i] += (acc * (int)now_step);
+		buf[i] = (buf[i]>>YM_DELTAT_SHIFT) * volume;
+	}
+
+	DELTAT->now_step = now_step;
+	DELTAT->now_addr = now_addr;
+	DELTAT->now_data = now_data;
+	DELTAT->acc      = acc;
+	DELTAT->prev_acc = prev_acc;
+	DELTAT->adpcmd   = adpcmd;
+	if (length > 0)
+		DELTAT->adpcml = buf[length - 1];
+	return length;
+}
+
 
 
 INLINE void YM_DELTAT_synthesis_from_CPU_memory(YM_DELTAT *DELTAT)
@@ -656,6 +802,38 @@ value:   START, REC, MEMDAT, REPEAT, SPOFF, x,x,RESET   meaning:
 	return;
 }
 
+/* ADPCM B for a block of samples: the output of each sample (what
+** YM_DELTAT_ADPCM_CALC adds to *pan) goes to buf[], 0 while not playing */
+void YM_DELTAT_ADPCM_CALC_BLOCK(YM_DELTAT *DELTAT, INT32 *buf, UINT32 length)
+{
+	UINT32 i = 0;
+
+	while (i < length)
+	{
+		if ( (DELTAT->portstate & 0xe0)==0xa0 )
+		{
+			i += YM_DELTAT_block_from_external_memory(DELTAT, &buf[i], length - i);
+			continue;
+		}
+
+		if ( (DELTAT->portstate & 0xe0)==0x80 )
+		{
+			INT32* pan = DELTAT->pan;
+			INT32 out = 0;
+
+			DELTAT->pan = &out;
+			YM_DELTAT_synthesis_from_CPU_memory(DELTAT);
+			DELTAT->pan = pan;
+			buf[i] = out;
+		}
+		else
+		{
+			buf[i] = 0;
+		}
+		i ++;
+	}
+}
+
 void YM_DELTAT_calc_mem_mask(YM_DELTAT* DELTAT)
 {
 	DELTAT->memory_mask = pow2_mask(DELTAT->memory_size);
@@ -3,6 +3,7 @@
 
 #include "../../stdtype.h"
 #include "../logging.h"
+#include "rommap.h"
 
 #define YM_DELTAT_SHIFT    (16)
 
@@ -16,7 +17,7 @@ typedef void (*STATUS_CHANGE_HANDLER)(void *chip, UINT8 status_bits);
 /* DELTA-T (adpcm type B) struct */
 typedef struct deltat_adpcm_state {     /* AT: rearranged and tightened structure */
 	DEV_LOGGER* logger;
-	UINT8	*memory;
+	ROM_MAP	memory;
 	INT32	*output_pointer;/* pointer of output pointers   */
 	INT32	*pan;			/* pan : &output_pointer[pan]   */
 	double	freqbase;
@@ -78,7 +79,9 @@ UINT8 YM_DELTAT_ADPCM_Read(YM_DELTAT *DELTAT);
 void YM_DELTAT_ADPCM_Write(YM_DELTAT *DELTAT,int r,int v);
 void YM_DELTAT_ADPCM_Init(YM_DELTAT *DELTAT,int emulation_mode,int portshift,INT32* output_ptr,int output_range);
 void YM_DELTAT_ADPCM_Reset(YM_DELTAT *DELTAT,int pan);
+void YM_DELTAT_ADPCM_LoadState(YM_DELTAT *DELTAT, const YM_DELTAT *state);
 void YM_DELTAT_ADPCM_CALC(YM_DELTAT *DELTAT);
+void YM_DELTAT_ADPCM_CALC_BLOCK(YM_DELTAT *DELTAT, INT32 *buf, UINT32 length);
 
 void YM_DELTAT_calc_mem_mask(YM_DELTAT* DELTAT);
 
@@ -69,6 +69,7 @@ differences between OPL2 and OPL3 shown in datasheets:
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
+#include "../modizer_voices.h"
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -589,7 +590,7 @@ static int num_lock = 0;
 
 
 
-static UINT8 tablesInit = 0;
+static EMU_ONCE tablesInit = EMU_ONCE_INIT;
 
 /* status set and IRQ handling */
 INLINE void OPL3_STATUS_SET(OPL3 *chip,int flag)
@@ -1123,9 +1124,8 @@ static int init_tables(void)
 	signed int n;
 	double o,m;
 
-	if (tablesInit)
+	if (! emu_once_begin(&tablesInit))
 		return 1;
-	tablesInit = 1;
 
 	for (x=0; x<TL_RES_LEN; x++)
 	{
@@ -1271,6 +1271,7 @@ static int init_tables(void)
 	}
 	/*logerror("YMF262.C: ENV_QUIET= %08x (dec*8=%i)\n", ENV_QUIET, ENV_QUIET*8 );*/
 
+	emu_once_end(&tablesInit);
 	return 1;
 }
 
@@ -2543,6 +2544,7 @@ void ymf262_update_one(void *_chip, UINT32 length, DEV_SMPL **buffers)
 	UINT32 i;
 	int chn;
     
+#ifndef MODIZER_NO_OSCILLO
     //TODO:  MODIZER changes start / YOYOFR
     //search first voice linked to current chip
     int m_voice_ofs=-1;
@@ -2551,21 +2553,16 @@ void ymf262_update_one(void *_chip, UINT32 length, DEV_SMPL **buffers)
         m_voice_ofs=m_voicesForceOfs;
         m_voicesForceOfs=-1;
     } else {
-        for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-            if (m_voice_ChipID[ii]==m_voice_current_system) {
-                m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-                m_voice_current_total=m_total_channels;
-                break;
-            }
-        }
+        m_voice_ofs=modizer_voices_find_slot(m_total_channels);
     }
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
     //printf("opn:%d / %lf delta:%lf\n",OPN->ST.rate,OPN->ST.freqbase,DELTAT->freqbase);
-    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
+#endif
 
 	if (! length)
 	{
@@ -2583,8 +2580,9 @@ void ymf262_update_one(void *_chip, UINT32 length, DEV_SMPL **buffers)
 		return;
 	}
     
+#ifndef MODIZER_NO_OSCILLO
     //YOYOFR
-    static INT32 old_out_fm[18]; //YOYOFR
+    static MZV_THREAD_LOCAL INT32 old_out_fm[18]; //YOYOFR
     if (m_voice_ofs>=0) {
         for (int ii=0;ii<4;ii++) {
             if (!(chip->P_CH[ii].Muted)) {
@@ -2612,6 +2610,7 @@ void ymf262_update_one(void *_chip, UINT32 length, DEV_SMPL **buffers)
         }
     }
     //YOYOFR
+#endif
 	
 	for( i=0; i < length ; i++ )
 	{
@@ -2693,6 +2692,7 @@ void ymf262_update_one(void *_chip, UINT32 length, DEV_SMPL **buffers)
 			d += chip->chanout[chn] & chip->pan[chn * 4 + 3];
 		}
         
+#ifndef MODIZER_NO_OSCILLO
         //TODO:  MODIZER changes start / YOYOFR
         if (m_voice_ofs>=0) {
             int64_t ofs_start=m_voice_current_ptr[m_voice_ofs+0];
@@ -2714,6 +2714,7 @@ void ymf262_update_one(void *_chip, UINT32 length, DEV_SMPL **buffers)
             for (int ii=0;ii<18;ii++) m_voice_current_ptr[m_voice_ofs+ii]=ofs_end;
         }
         //TODO:  MODIZER changes end / YOYOFR
+#endif
 
 		/* store to sound buffer */
 		ch_a[i] = ((a+c) * chip->masterVolL) >> 12;
@@ -39,9 +39,10 @@
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
+#include "../modizer_voices.h"
 static int curchan;
-static int64_t smplIncr;
-static int m_voice_ofs;
+static MZV_THREAD_LOCAL int64_t smplIncr;
+static MZV_THREAD_LOCAL int m_voice_ofs;
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -711,6 +712,7 @@ static void update_pcm(YMF271Chip *chip, int slotnum, INT32 *mixp, UINT32 length
 		mixp[i*2+0] += (sample * ch0_vol) >> 16;
 		mixp[i*2+1] += (sample * ch1_vol) >> 16;
         
+#ifndef MODIZER_NO_OSCILLO
         //TODO:  MODIZER changes start / YOYOFR
         if (m_voice_ofs>=0) {
             int64_t ofs_start=m_voice_current_ptr[m_voice_ofs+curchan]+i*smplIncr;
@@ -727,6 +729,7 @@ static void update_pcm(YMF271Chip *chip, int slotnum, INT32 *mixp, UINT32 length
                 }
         }
         //TODO:  MODIZER changes end / YOYOFR
+#endif
 
 		// go to next step
 		slot->stepptr += slot->step;
@@ -778,25 +781,21 @@ static void ymf271_update(void *info, UINT32 samples, DEV_SMPL** outputs)
 	INT32 *mixp;
 	YMF271Chip *chip = (YMF271Chip *)info;
     
+#ifndef MODIZER_NO_OSCILLO
     //TODO:  MODIZER changes start / YOYOFR
     //search first voice linked to current chip
     m_voice_ofs=-1;
     int m_total_channels=12;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
     if (m_voice_ofs>=0) m_voicesForceOfs=m_voice_ofs;
     //printf("opn:%d / %lf delta:%lf\n",OPN->ST.rate,OPN->ST.freqbase,DELTAT->freqbase);
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
-    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
+#endif
     
     
 	for (smpl_ofs = 0; smpl_ofs < samples; smpl_ofs += proc_smpls)
@@ -814,6 +813,7 @@ static void ymf271_update(void *info, UINT32 samples, DEV_SMPL** outputs)
 
         if (slot_group->Muted || chip->mem_base == NULL) {
             
+#ifndef MODIZER_NO_OSCILLO
             //TODO:  MODIZER changes start / YOYOFR
             if (m_voice_ofs>=0) {
                 int64_t ofs_start=m_voice_current_ptr[m_voice_ofs+j];
@@ -823,6 +823,7 @@ static void ymf271_update(void *info, UINT32 samples, DEV_SMPL** outputs)
                 m_voice_current_ptr[m_voice_ofs+j]=ofs_end;
             }
             //TODO:  MODIZER changes end / YOYOFR
+#endif
             
             continue;
         }
@@ -1057,6 +1058,7 @@ static void ymf271_update(void *info, UINT32 samples, DEV_SMPL** outputs)
 										(output3 * chip->lut_attenuation[chip->slots[slot3].ch1_level]) +
 										(output4 * chip->lut_attenuation[chip->slots[slot4].ch1_level])) >> 16;
                         
+#ifndef MODIZER_NO_OSCILLO
                         //TODO:  MODIZER changes start / YOYOFR
                         if (m_voice_ofs>=0) {
                             int64_t ofs_start=m_voice_current_ptr[m_voice_ofs+j]+i*smplIncr;
@@ -1076,6 +1078,7 @@ static void ymf271_update(void *info, UINT32 samples, DEV_SMPL** outputs)
                                 }
                         }
                         //TODO:  MODIZER changes end / YOYOFR
+#endif
 					}
 				}
 				break;
@@ -1139,6 +1142,7 @@ static void ymf271_update(void *info, UINT32 samples, DEV_SMPL** outputs)
 							mixp[i*2+1] += ((output1 * chip->lut_attenuation[chip->slots[slot1].ch1_level]) +
 											(output3 * chip->lut_attenuation[chip->slots[slot3].ch1_level])) >> 16;
                             
+#ifndef MODIZER_NO_OSCILLO
                             //TODO:  MODIZER changes start / YOYOFR
                             if (m_voice_ofs>=0) {
                                 int64_t ofs_start=m_voice_current_ptr[m_voice_ofs+j]+i*smplIncr;
@@ -1156,6 +1160,7 @@ static void ymf271_update(void *info, UINT32 samples, DEV_SMPL** outputs)
                                     }
                             }
                             //TODO:  MODIZER changes end / YOYOFR
+#endif
 						}
 					}
 				}
@@ -1268,6 +1273,7 @@ static void ymf271_update(void *info, UINT32 samples, DEV_SMPL** outputs)
 										(output2 * chip->lut_attenuation[chip->slots[slot2].ch1_level]) +
 										(output3 * chip->lut_attenuation[chip->slots[slot3].ch1_level])) >> 16;
                         
+#ifndef MODIZER_NO_OSCILLO
                         //TODO:  MODIZER changes start / YOYOFR
                         if (m_voice_ofs>=0) {
                             int64_t ofs_start=m_voice_current_ptr[m_voice_ofs+j]+i*smplIncr;
@@ -1286,6 +1292,7 @@ static void ymf271_update(void *info, UINT32 samples, DEV_SMPL** outputs)
                                 }
                         }
                         //TODO:  MODIZER changes end / YOYOFR
+#endif
 					}
 				}
 
@@ -1306,6 +1313,7 @@ static void ymf271_update(void *info, UINT32 samples, DEV_SMPL** outputs)
 			}
 		}
         
+#ifndef MODIZER_NO_OSCILLO
         //TODO:  MODIZER changes start / YOYOFR
         if (m_voice_ofs>=0) {
             int64_t ofs_end=(m_voice_current_ptr[m_voice_ofs+j]+proc_smpls*smplIncr);
@@ -1314,6 +1322,7 @@ static void ymf271_update(void *info, UINT32 samples, DEV_SMPL** outputs)
             m_voice_current_ptr[m_voice_ofs+j]=ofs_end;
         }
         //TODO:  MODIZER changes end / YOYOFR
+#endif
 	}
 
 	for (i = 0; i < proc_smpls; i++)
@@ -109,6 +109,7 @@
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
+#include "../modizer_voices.h"
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -420,7 +421,7 @@ static const UINT8 am_depth[8] = {
 };
 
 
-static UINT8 tablesInit = 0;
+static EMU_ONCE tablesInit = EMU_ONCE_INIT;
 
 // Sign extend a 4-bit value to 8-bit int
 // require: x in range [0..15]
@@ -781,20 +782,14 @@ static void ymf278b_pcm_update(void *info, UINT32 samples, DEV_SMPL** outputs)
     //search first voice linked to current chip
     int m_voice_ofs=-1;
     int m_total_channels=24;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
     if (m_voice_ofs>=0) m_voicesForceOfs=m_voice_ofs;
     //printf("opn:%d / %lf delta:%lf\n",OPN->ST.rate,OPN->ST.freqbase,DELTAT->freqbase);
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
-    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
 
 	vl = mix_level[chip->pcm_l];
@@ -1520,10 +1515,8 @@ static UINT8 device_start_ymf278b(const DEV_GEN_CFG* cfg, DEV_INFO* retDevInf)
 
 	chip->memadr = 0; // avoid UMR
 
-	if (! tablesInit)
+	if (emu_once_begin(&tablesInit))
 	{
-		tablesInit = 1;
-		
 		// Volume table (envelope levels)
 		for (i = 0x00; i < ENV_LEN; i ++)
 		{
@@ -1539,6 +1532,7 @@ static UINT8 device_start_ymf278b(const DEV_GEN_CFG* cfg, DEV_INFO* retDevInf)
 				vol_tab[i] = 0;
 			}
 		}
+	emu_once_end(&tablesInit);
 	}
 
 	ymf278b_set_mute_mask(chip, 0x000000);
@@ -44,6 +44,7 @@
 
 //TODO:  MODIZER changes start / YOYOFR
 #include "../../../../../src/ModizerVoicesData.h"
+#include "../modizer_voices.h"
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -185,7 +186,7 @@ static const int index_scale[8] = { 0x0e6, 0x0e6, 0x0e6, 0x0e6, 0x133, 0x199, 0x
 
 /* lookup table for the precomputed difference */
 static int diff_lookup[16];
-static UINT8 lookup_init = 0x00;	/* lookup-table is initialized */
+static EMU_ONCE lookup_init = EMU_ONCE_INIT;	/* lookup-table is initialized */
 
 
 INLINE UINT8 ymz280b_read_memory(ymz280b_state *chip, UINT32 offset)
@@ -287,7 +288,7 @@ static void compute_tables(void)
 {
 	int nib;
 
-	if (lookup_init)
+	if (! emu_once_begin(&lookup_init))
 		return;
 
 	/* loop over all nibbles and compute the difference */
@@ -297,7 +298,7 @@ static void compute_tables(void)
 		diff_lookup[nib] = (nib & 0x08) ? -value : value;
 	}
 	
-	lookup_init = 0x01;
+	emu_once_end(&lookup_init);
 }
 
 
@@ -582,20 +583,14 @@ static void ymz280b_update(void *param, UINT32 samples, DEV_SMPL **outputs)
     //search first voice linked to current chip
     int m_voice_ofs=-1;
     int m_total_channels=8;
-    for (int ii=0;ii<=SOUND_MAXVOICES_BUFFER_FX-m_total_channels;ii++) {
-        if (m_voice_ChipID[ii]==m_voice_current_system) {
-            m_voice_ofs=ii+(m_voice_current_systemSub?m_voice_current_systemPairedOfs:0);
-            m_voice_current_total=m_total_channels;
-            break;
-        }
-    }
+    m_voice_ofs=modizer_voices_find_slot(m_total_channels);
     if (m_voice_ofs>=0) m_voicesForceOfs=m_voice_ofs;
     //printf("opn:%d / %lf delta:%lf\n",OPN->ST.rate,OPN->ST.freqbase,DELTAT->freqbase);
-    if (!m_voice_current_samplerate) {
-        m_voice_current_samplerate=44100;
+    if (!mzv_ctx->samplerate) {
+        mzv_ctx->samplerate=44100;
         //printf("voice sample rate null\n");
     }
-    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/m_voice_current_samplerate;
+    int64_t smplIncr=(int64_t)44100*(1<<MODIZER_OSCILLO_OFFSET_FIXEDPOINT)/mzv_ctx->samplerate;
     //TODO:  MODIZER changes end / YOYOFR
     
 	/* loop over voices */
@@ -557,3 +557,51 @@ void daccontrol_stop(void* info)
 	
 	return;
 }
+
+UINT32 daccontrol_get_next_event(void* info)
+{
+	// returns the number of samples until the next update that sends a command
+	// (the update covering exactly that many samples sends it at its end),
+	// or (UINT32)-1 if the stream won't send anything
+	dac_control* chip = (dac_control*)info;
+	RC_TYPE remain;
+	RC_TYPE smpls;
+	
+	if (chip->Running & 0x80)	// disabled
+		return (UINT32)-1;
+	if (! (chip->Running & 0x01))	// stopped
+		return (UINT32)-1;
+	if (! chip->RemainCmds)
+		return (UINT32)-1;
+	
+	if (RC_GET_VAL(&chip->stepCntr) > 0)
+		return 1;	// already due (frequency 0 after a start)
+	if (! chip->stepCntr.inc)
+		return (UINT32)-1;
+	
+	remain = ((RC_TYPE)1 << RC_SHIFT) - chip->stepCntr.val;
+	smpls = (remain + chip->stepCntr.inc - 1) / chip->stepCntr.inc;
+	return (smpls < (UINT32)-1) ? (UINT32)smpls : (UINT32)-1;
+}
+
+UINT32 daccontrol_save_state(void* info, void* buffer)
+{
+	// returns the size of the state, buffer == NULL only queries it
+	dac_control* chip = (dac_control*)info;
+	
+	if (buffer != NULL)
+		memcpy(buffer, chip, sizeof(dac_control));
+	return sizeof(dac_control);
+}
+
+void daccontrol_load_state(void* info, const void* buffer)
+{
+	// Note: The state may come from another stream instance. It includes the
+	//       destination chip and the data pointer, so both must still be valid.
+	//       (call daccontrol_refresh_data when the data was moved)
+	dac_control* chip = (dac_control*)info;
+	
+	memcpy(chip, buffer, sizeof(dac_control));
+	
+	return;
+}
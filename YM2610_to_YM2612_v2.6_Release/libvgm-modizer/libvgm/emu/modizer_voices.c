@@ -0,0 +1,67 @@
+#include <stddef.h>	// for NULL
+
+#include "../stdtype.h"
+#include "modizer_voices.h"
+
+//TODO:  MODIZER changes start / YOYOFR
+#include "../../../../src/ModizerVoicesData.h"
+//TODO:  MODIZER changes end / YOYOFR
+
+#ifdef MODIZER_NO_OSCILLO
+// headless build: no reference to MODIZER's voice map, so that it doesn't need to be linked in
+#define MZV_VOICE_MAP	NULL
+#else
+#define MZV_VOICE_MAP	m_voice_ChipID
+#endif
+
+static MODIZER_VOICE_CTX defaultCtx = {MZV_VOICE_MAP, 0, 0, 0, 0, 0, NULL};
+MZV_THREAD_LOCAL MODIZER_VOICE_CTX* mzv_ctx = &defaultCtx;
+
+void modizer_voices_init_ctx(MODIZER_VOICE_CTX* ctx, UINT8 capture)
+{
+	ctx->chipID = capture ? MZV_VOICE_MAP : NULL;
+	ctx->system = 0;
+	ctx->systemSub = 0;
+	ctx->systemPairedOfs = 0;
+	ctx->total = 0;
+	ctx->samplerate = 0;
+	ctx->slot = NULL;
+	return;
+}
+
+#ifndef MODIZER_NO_OSCILLO
+
+int modizer_voices_find_slot(int channels)
+{
+	MODIZER_VOICE_CTX* ctx = mzv_ctx;
+	int ii;
+	
+	if (ctx->chipID == NULL)
+		return -1;
+	if (ctx->slot != NULL && ctx->slot->ofs != MZV_SLOT_UNRESOLVED)
+	{
+		ctx->total = ctx->slot->count;
+		return ctx->slot->ofs;
+	}
+	
+	for (ii = 0; ii <= SOUND_MAXVOICES_BUFFER_FX - channels; ii ++)
+	{
+		if (ctx->chipID[ii] == ctx->system)
+			break;
+	}
+	if (ii > SOUND_MAXVOICES_BUFFER_FX - channels)
+		ii = -1;
+	else
+		ii += (ctx->systemSub ? ctx->systemPairedOfs : 0);
+	if (ii < 0)
+		return -1;	// not in the map (yet), the player may fill it in later
+	
+	ctx->total = channels;
+	if (ctx->slot != NULL)
+	{
+		ctx->slot->ofs = ii;
+		ctx->slot->count = channels;
+	}
+	return ii;
+}
+#endif
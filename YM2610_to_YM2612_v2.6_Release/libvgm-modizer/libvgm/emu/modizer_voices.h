@@ -0,0 +1,74 @@
+#ifndef __MODIZER_VOICES_H__
+#define __MODIZER_VOICES_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "../stdtype.h"
+
+// Define MODIZER_NO_OSCILLO for headless builds (converters, batch renderers). The cores then
+// never look up a voice slot, their oscilloscope capture code is compiled out and libvgm
+// doesn't reference MODIZER's voice buffers (ModizerVoicesData.h) any more.
+
+// oscilloscope voices of a device, looked up on each update until the device is found
+// in the voice map, then kept with the device
+typedef struct _modizer_voice_slot
+{
+	int ofs;	// first voice, MZV_SLOT_UNRESOLVED = not found yet
+	int count;	// number of voices
+} MODIZER_VOICE_SLOT;
+#define MZV_SLOT_UNRESOLVED	-2
+#define MZV_SLOT_INIT(slot)	do { (slot)->ofs = MZV_SLOT_UNRESOLVED; (slot)->count = 0; } while(0)
+
+// MODIZER oscilloscope state of a player
+// The voice buffers themselves are MODIZER's global arrays (see ModizerVoicesData.h),
+// this only holds what used to be the process-wide m_voice_current_* variables.
+typedef struct _modizer_voice_context
+{
+	const int* chipID;		// voice -> device map (m_voice_ChipID), NULL = no oscilloscope capture
+	int system;				// device that is being rendered
+	int systemSub;			// != 0 when rendering a linked device (e.g. the SSG of an OPN)
+	int systemPairedOfs;	// voice offset of the linked device
+	int total;				// number of voices of the last device that found its slot
+	int samplerate;			// sample rate of the device that is being rendered
+	MODIZER_VOICE_SLOT* slot;	// slot of the device that is being rendered, NULL = not cached
+} MODIZER_VOICE_CTX;
+
+#if defined(_MSC_VER)
+#define MZV_THREAD_LOCAL	__declspec(thread)
+#elif defined(__GNUC__)
+#define MZV_THREAD_LOCAL	__thread
+#else
+#define MZV_THREAD_LOCAL	_Thread_local
+#endif
+
+// Context of the player that is rendering on the calling thread.
+// Players point it to their own context during Start/Render, so that multiple players
+// can run on separate threads. Outside of that it refers to a process-wide default context.
+extern MZV_THREAD_LOCAL MODIZER_VOICE_CTX* mzv_ctx;
+
+void modizer_voices_init_ctx(MODIZER_VOICE_CTX* ctx, UINT8 capture);
+// returns the first voice of the device that is being rendered, -1 = none
+#ifdef MODIZER_NO_OSCILLO
+#define modizer_voices_find_slot(channels)	(-1)
+#else
+int modizer_voices_find_slot(int channels);
+#endif
+
+#ifdef __cplusplus
+}
+
+// makes a player's context the current one for the lifetime of the object
+class ModizerVoiceScope
+{
+public:
+	ModizerVoiceScope(MODIZER_VOICE_CTX* ctx) : _prevCtx(mzv_ctx)	{ mzv_ctx = ctx; }
+	~ModizerVoiceScope()	{ mzv_ctx = _prevCtx; }
+private:
+	MODIZER_VOICE_CTX* _prevCtx;
+};
+#endif
+
+#endif	// __MODIZER_VOICES_H__
@@ -19,7 +19,7 @@
 #include "../emu/logging.h"
 
 //TODO:  MODIZER changes start / YOYOFR
-#include "../../../../src/ModizerVoicesData.h"
+#include "../emu/modizer_voices.h"
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -645,6 +645,7 @@ UINT8 GYMPlayer::Start(void)
 {
 	size_t curDev;
 	UINT8 retVal;
+	ModizerVoiceScope voiceScope(&_voiceCtx);	//YOYOFR: Resmpl_Init may already update the devices
 	
 	for (curDev = 0; curDev < 2; curDev ++)
 		_optDevMap[curDev] = (size_t)-1;
@@ -660,6 +661,7 @@ UINT8 GYMPlayer::Start(void)
 		
 		cDev->base.defInf.dataPtr = NULL;
 		cDev->base.linkDev = NULL;
+		MZV_SLOT_INIT(&cDev->base.voiceSlot);	//YOYOFR
 		cDev->optID = DeviceID2OptionID((UINT32)curDev);
 		
 		devOpts = (cDev->optID != (size_t)-1) ? &_devOpts[cDev->optID] : NULL;
@@ -821,6 +823,8 @@ UINT32 GYMPlayer::Render(UINT32 smplCnt, WAVE_32BS* data)
 	UINT32 pcmSmplStart = 0;
 	UINT32 pcmSmplLen = 1;
 	
+	ModizerVoiceScope voiceScope(&_voiceCtx);	//YOYOFR: the cores' oscilloscope hooks use this player's context
+	
 	// Note: use do {} while(), so that "smplCnt == 0" can be used to process until reaching the next sample.
 	curSmpl = 0;
 	do
@@ -869,23 +873,25 @@ UINT32 GYMPlayer::Render(UINT32 smplCnt, WAVE_32BS* data)
 			UINT8 disable = (cDev->optID != (size_t)-1) ? _devOpts[cDev->optID].muteOpts.disable : 0x00;
 			VGM_BASEDEV* clDev;
             //TODO:  MODIZER changes start / yoyofr
-            m_voice_current_system=curDev;
-            m_voice_current_systemSub=0;  //YOYOFR: to remove, not used anymore
-            m_voice_current_systemPairedOfs=0;
+            _voiceCtx.system=curDev;
+            _voiceCtx.systemSub=0;  //YOYOFR: to remove, not used anymore
+            _voiceCtx.systemPairedOfs=0;
             //TODO:  MODIZER changes end / YOYOFR
 			
 			for (clDev = &cDev->base; clDev != NULL; clDev = clDev->linkDev, disable >>= 1)
 			{
                 //YOYOFR
-                m_voice_current_samplerate=clDev->defInf.sampleRate;
+                _voiceCtx.samplerate=clDev->defInf.sampleRate;
+                _voiceCtx.slot=&clDev->voiceSlot;    //the device keeps its voice slot once it was looked up
                 //YOYOFR
                 
 				if (clDev->defInf.dataPtr != NULL && ! (disable & 0x01))
 					Resmpl_Execute(&clDev->resmpl, smplStep, &data[curSmpl]);
                 
                 //YOYOFR
-                m_voice_current_systemSub++; //flag that next one will be a linked device
-                m_voice_current_systemPairedOfs+=m_voice_current_total;
+                _voiceCtx.systemSub++; //flag that next one will be a linked device
+                _voiceCtx.systemPairedOfs+=_voiceCtx.total;
+                _voiceCtx.slot=NULL;
                 //YOYOFR
 			}
 		}
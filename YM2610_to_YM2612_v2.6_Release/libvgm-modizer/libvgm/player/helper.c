@@ -27,6 +27,7 @@ void SetupLinkedDevices(VGM_BASEDEV* cBaseDev, SETUPLINKDEV_CB devCfgCB, void* c
 		if (cDevCur == NULL)
 			break;
 		cDevCur->linkDev = NULL;
+		MZV_SLOT_INIT(&cDevCur->voiceSlot);
 		if (cParent == NULL)
 			cBaseDev->linkDev = cDevCur;
 		else
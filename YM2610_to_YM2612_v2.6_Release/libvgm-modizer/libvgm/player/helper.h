@@ -9,6 +9,7 @@ extern "C"
 #include "../stdtype.h"
 #include "../emu/EmuStructs.h"
 #include "../emu/Resampler.h"
+#include "../emu/modizer_voices.h"
 
 typedef struct _vgm_base_device VGM_BASEDEV;
 struct _vgm_base_device
@@ -16,6 +17,7 @@ struct _vgm_base_device
 	DEV_INFO defInf;
 	RESMPL_STATE resmpl;
 	VGM_BASEDEV* linkDev;
+	MODIZER_VOICE_SLOT voiceSlot;	//YOYOFR
 };
 
 // callback function typedef for SetupLinkedDevices
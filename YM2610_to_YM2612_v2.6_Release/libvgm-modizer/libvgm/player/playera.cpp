@@ -634,14 +634,16 @@ UINT32 PlayerA::Render(UINT32 bufSize, void* data)
 		_outSmplPack(&bData[(curSmpl * 2 + 1) * _outSmplSize1], fnlSmpl.R);
 	}
     
+#ifndef MODIZER_NO_OSCILLO
     //YOYOFR
-    if (basePbSmpl >= _fadeSmplStart) {
+    if (basePbSmpl >= _fadeSmplStart && _player->GetVoiceCapture()) {
         for (int i = 0; i < smplCount; i++)
             for (int j=0;j<(m_genNumVoicesChannels<SOUND_MAXVOICES_BUFFER_FX?m_genNumVoicesChannels:SOUND_MAXVOICES_BUFFER_FX);j++) {
                 m_voice_buff[j][i]=LIMIT8(((int)(m_voice_buff[j][i])* curVolume) >> VOL_BITS);
             }     
     }
     //YOYOFR
+#endif
 	return curSmpl * _outSmplSizeA;
 }
 
@@ -12,6 +12,7 @@ PlayerBase::PlayerBase() :
 	_logCbFunc(NULL),
 	_logCbParam(NULL)
 {
+	modizer_voices_init_ctx(&_voiceCtx, 1);
 }
 
 PlayerBase::~PlayerBase()
@@ -50,6 +51,7 @@ UINT8 PlayerBase::CanLoadFile(DATA_LOADER *dataLoader) const
 	devOpts.muteOpts.chnMute[0] = 0x00;
 	devOpts.muteOpts.chnMute[1] = 0x00;
 	memset(devOpts.panOpts.chnPan, 0x00, sizeof(devOpts.panOpts.chnPan));
+	devOpts.sampleCache = NULL;
 	return 0x00;
 }
 
@@ -98,6 +100,17 @@ void PlayerBase::SetLogCallback(PLAYER_LOG_CB cbFunc, void* cbParam)
 	return;
 }
 
+void PlayerBase::SetVoiceCapture(UINT8 enable)
+{
+	modizer_voices_init_ctx(&_voiceCtx, enable);
+	return;
+}
+
+UINT8 PlayerBase::GetVoiceCapture(void) const
+{
+	return (_voiceCtx.chipID != NULL);
+}
+
 double PlayerBase::Sample2Second(UINT32 samples) const
 {
 	if (samples == (UINT32)-1)
@@ -4,6 +4,7 @@
 #include "../stdtype.h"
 #include "../emu/EmuStructs.h"	// for DEV_GEN_CFG
 #include "../emu/Resampler.h"	// for WAVE_32BS
+#include "../emu/modizer_voices.h"	// for MODIZER_VOICE_CTX
 #include "../utils/DataLoader.h"
 #include <vector>
 
@@ -90,6 +91,7 @@ struct PLR_DEV_OPTS
 	UINT32 coreOpts;
 	PLR_MUTE_OPTS muteOpts;
 	PLR_PAN_OPTS panOpts;
+	void* sampleCache;	// decoded sample cache shared with other devices (core specific, see DEVRW_CACHE), NULL = private
 };
 
 struct PLR_GEN_OPTS
@@ -135,6 +137,10 @@ public:
 	virtual void SetEventCallback(PLAYER_EVENT_CB cbFunc, void* cbParam);
 	virtual void SetFileReqCallback(PLAYER_FILEREQ_CB cbFunc, void* cbParam);
 	virtual void SetLogCallback(PLAYER_LOG_CB cbFunc, void* cbParam);
+	// MODIZER oscilloscope capture, enabled by default
+	// Only one player in a process should capture, as all players share MODIZER's voice buffers.
+	void SetVoiceCapture(UINT8 enable);
+	UINT8 GetVoiceCapture(void) const;
 	virtual UINT32 Tick2Sample(UINT32 ticks) const = 0;
 	virtual UINT32 Sample2Tick(UINT32 samples) const = 0;
 	virtual double Tick2Second(UINT32 ticks) const = 0;
@@ -161,6 +167,7 @@ protected:
 	void* _fileReqCbParam;
 	PLAYER_LOG_CB _logCbFunc;
 	void* _logCbParam;
+	MODIZER_VOICE_CTX _voiceCtx;
 };
 
 #endif	// __PLAYERBASE_HPP__
@@ -17,6 +17,7 @@
 #include "../emu/dac_control.h"
 #include "../emu/cores/sn764intf.h"	// for SN76496_CFG
 #include "../emu/cores/2612intf.h"
+#include "../emu/cores/opnintf.h"	// for OPT_YM2610_PCM_ONLY
 #include "../emu/cores/segapcm.h"		// for SEGAPCM_CFG
 #include "../emu/cores/ayintf.h"		// for AY8910_CFG
 #include "../emu/cores/gb.h"
@@ -33,7 +34,7 @@
 #include "../emu/logging.h"
 
 //TODO:  MODIZER changes start / YOYOFR
-#include "../../../../src/ModizerVoicesData.h"
+#include "../emu/modizer_voices.h"
 //TODO:  MODIZER changes end / YOYOFR
 
 
@@ -622,6 +623,10 @@ void VGMPlayer::RefreshDevOptions(CHIP_DEVICE& chipDev, const PLR_DEV_OPTS& devO
 {
 	UINT8 chipType = chipDev.chipType;
 	DEV_INFO* devInf = &chipDev.base.defInf;
+	DEVFUNC_WRITE_CACHE setCache = NULL;
+	SndEmu_GetDeviceFunc(devInf->devDef, RWF_MEMORY | RWF_WRITE, DEVRW_CACHE, 0, (void**)&setCache);
+	if (setCache != NULL)
+		setCache(devInf->dataPtr, devOpts.sampleCache);
 	if (devInf->devDef->SetOptionBits == NULL)
 		return;
 	
@@ -928,6 +933,15 @@ UINT8 VGMPlayer::Stop(void)
 	}
 	free(_pcmComprTbl.values.d8);	_pcmComprTbl.values.d8 = NULL;
 	
+	_keyframes.clear();	// keyframes are only valid for the current devices
+	for (curBank = 0x00; curBank < _PCM_BANK_COUNT; curBank ++)
+	{
+		PCM_BANK* kfBnk = &_kfPcmBank[curBank];
+		kfBnk->bankOfs.clear();
+		kfBnk->bankSize.clear();
+		kfBnk->data.clear();
+	}
+	
 	for (curDev = 0; curDev < _devices.size(); curDev ++)
 		FreeDeviceTree(&_devices[curDev].base, 0);
 	_devNames.clear();
@@ -1336,6 +1350,7 @@ void VGMPlayer::GenerateDeviceConfig(void)
 void VGMPlayer::InitDevices(void)
 {
 	size_t curChip;
+	ModizerVoiceScope voiceScope(&_voiceCtx);	//YOYOFR: Resmpl_Init may already update the devices
 	
 	memset(_shownCmdWarnings, 0, 0x100);
 	
@@ -1381,6 +1396,7 @@ void VGMPlayer::InitDevices(void)
 		chipDev.cfgID = curChip;
 		chipDev.base.defInf.dataPtr = NULL;
 		chipDev.base.linkDev = NULL;
+		MZV_SLOT_INIT(&chipDev.base.voiceSlot);	//YOYOFR
 		
 		devOpts = (chipDev.optID != (size_t)-1) ? &_devOpts[chipDev.optID] : NULL;
 		devCfg->emuCore = (devOpts != NULL) ? devOpts->emuCore[0] : 0x00;
@@ -1435,8 +1451,10 @@ void VGMPlayer::InitDevices(void)
 			SndEmu_GetDeviceFunc(devInf->devDef, RWF_REGISTER | RWF_WRITE, DEVRW_A8D8, 0, (void**)&chipDev.write8);
 			SndEmu_GetDeviceFunc(devInf->devDef, RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 'A', (void**)&chipDev.romSize);
 			SndEmu_GetDeviceFunc(devInf->devDef, RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 'A', (void**)&chipDev.romWrite);
+			SndEmu_GetDeviceFunc(devInf->devDef, RWF_MEMORY | RWF_WRITE, DEVRW_BLOCKREF, 'A', (void**)&chipDev.romRef);
 			SndEmu_GetDeviceFunc(devInf->devDef, RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 'B', (void**)&chipDev.romSizeB);
 			SndEmu_GetDeviceFunc(devInf->devDef, RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 'B', (void**)&chipDev.romWriteB);
+			SndEmu_GetDeviceFunc(devInf->devDef, RWF_MEMORY | RWF_WRITE, DEVRW_BLOCKREF, 'B', (void**)&chipDev.romRefB);
 			break;
 		case DEVID_YMF278B:
 			retVal = SndEmu_Start(chipType, devCfg, devInf);
@@ -1535,6 +1553,8 @@ void VGMPlayer::InitDevices(void)
 			SndEmu_GetDeviceFunc(devInf->devDef, RWF_REGISTER | RWF_WRITE, DEVRW_A16D8, 0, (void**)&chipDev.writeM8);
 			SndEmu_GetDeviceFunc(devInf->devDef, RWF_MEMORY | RWF_WRITE, DEVRW_MEMSIZE, 0, (void**)&chipDev.romSize);
 			SndEmu_GetDeviceFunc(devInf->devDef, RWF_MEMORY | RWF_WRITE, DEVRW_BLOCK, 0, (void**)&chipDev.romWrite);
+			SndEmu_GetDeviceFunc(devInf->devDef, RWF_MEMORY | RWF_WRITE, DEVRW_BLOCKREF, 0, (void**)&chipDev.romRef);
+			SndEmu_GetDeviceFunc(devInf->devDef, RWF_REGISTER | RWF_WRITE, DEVRW_DACQUEUE, 0, (void**)&chipDev.dacQueue);
 			break;
 		}
 		if (retVal)
@@ -1728,8 +1748,13 @@ UINT8 VGMPlayer::Seek(UINT8 unit, UINT32 pos)
 		// fall through
 	case PLAYPOS_TICK:
 		_playState |= PLAYSTATE_SEEK;
-		if (pos < _playTick)
-			Reset();
+		{
+			const KEYFRAME* kf = FindKeyframe(pos);
+			if (kf != NULL && (pos < _playTick || kf->playTick > _playTick))
+				LoadKeyframe(*kf);
+			else if (pos < _playTick)
+				Reset();
+		}
 		return SeekToTick(pos);
 	case PLAYPOS_COMMAND:
 	default:
@@ -1773,14 +1798,243 @@ UINT8 VGMPlayer::SeekToFilePos(UINT32 pos)
 	return 0x00;
 }
 
+UINT8 VGMPlayer::BuildSeekIndex(UINT32 interval)
+{
+	PLAYER_EVENT_CB eventCbFunc;
+	size_t curBank;
+	
+	if (! (_playState & PLAYSTATE_PLAY))
+		return 0xFF;	// the devices have to be running
+	
+	_keyframes.clear();
+	for (curBank = 0x00; curBank < _PCM_BANK_COUNT; curBank ++)
+	{
+		PCM_BANK* kfBnk = &_kfPcmBank[curBank];
+		kfBnk->bankOfs.clear();
+		kfBnk->bankSize.clear();
+		kfBnk->data.clear();
+	}
+	if (! interval)
+		return 0x00;
+	if (! CanSaveDeviceStates())
+		return 0x01;
+	
+	// parse the first pass of the song (no loops) like Seek() does, without sending events
+	eventCbFunc = _eventCbFunc;
+	_eventCbFunc = NULL;
+	Reset();
+	_playState |= PLAYSTATE_SEEK;
+	while(true)
+	{
+		ParseFile(interval);
+		if ((_playState & PLAYSTATE_END) || _curLoop > 0)
+			break;
+		_keyframes.push_back(KEYFRAME());
+		SaveKeyframe(_keyframes.back());
+	}
+	_playState &= ~PLAYSTATE_SEEK;
+	
+	// Data blocks are only appended, so the PCM banks of every keyframe are a prefix of these.
+	for (curBank = 0x00; curBank < _PCM_BANK_COUNT; curBank ++)
+	{
+		_kfPcmBank[curBank].bankOfs.swap(_pcmBank[curBank].bankOfs);
+		_kfPcmBank[curBank].bankSize.swap(_pcmBank[curBank].bankSize);
+		_kfPcmBank[curBank].data.swap(_pcmBank[curBank].data);
+	}
+	Reset();
+	_eventCbFunc = eventCbFunc;
+	
+	emu_logf(&_logger, PLRLOG_DEBUG, "Seek index: %u keyframes\n", (UINT32)_keyframes.size());
+	return 0x00;
+}
+
+bool VGMPlayer::CanSaveDeviceStates(void) const
+{
+	size_t curDev;
+	
+	for (curDev = 0; curDev < _devices.size(); curDev ++)
+	{
+		const VGM_BASEDEV* clDev;
+		for (clDev = &_devices[curDev].base; clDev != NULL; clDev = clDev->linkDev)
+		{
+			void* funcPtr;
+			if (clDev->defInf.dataPtr == NULL)
+				continue;
+			if (SndEmu_GetDeviceFunc(clDev->defInf.devDef, RWF_STATE | RWF_READ, DEVRW_ALL, 0, &funcPtr))
+				return false;
+			if (SndEmu_GetDeviceFunc(clDev->defInf.devDef, RWF_STATE | RWF_WRITE, DEVRW_ALL, 0, &funcPtr))
+				return false;
+		}
+	}
+	return true;
+}
+
+void VGMPlayer::SaveKeyframe(KEYFRAME& kf)
+{
+	size_t curDev;
+	size_t curStrm;
+	size_t curBank;
+	
+	kf.filePos = _filePos;
+	kf.fileTick = _fileTick;
+	kf.playTick = _playTick;
+	kf.ym2612pcm_bnkPos = _ym2612pcm_bnkPos;
+	memcpy(kf.rf5cBank, _rf5cBank, sizeof(_rf5cBank));
+	memcpy(kf.qsWork, _qsWork, sizeof(_qsWork));
+	
+	kf.pcmBankItems.resize(_PCM_BANK_COUNT);
+	kf.pcmBankSize.resize(_PCM_BANK_COUNT);
+	for (curBank = 0x00; curBank < _PCM_BANK_COUNT; curBank ++)
+	{
+		kf.pcmBankItems[curBank] = (UINT32)_pcmBank[curBank].bankOfs.size();
+		kf.pcmBankSize[curBank] = (UINT32)_pcmBank[curBank].data.size();
+	}
+	
+	kf.dacStreams.resize(_dacStreams.size());
+	for (curStrm = 0; curStrm < _dacStreams.size(); curStrm ++)
+	{
+		KEYFRAME_STRM& kfStrm = kf.dacStreams[curStrm];
+		void* strmData = _dacStreams[curStrm].defInf.dataPtr;
+		kfStrm.strm = _dacStreams[curStrm];
+		kfStrm.state.resize(daccontrol_save_state(strmData, NULL));
+		daccontrol_save_state(strmData, &kfStrm.state[0]);
+	}
+	
+	kf.devStates.clear();
+	for (curDev = 0; curDev < _devices.size(); curDev ++)
+	{
+		VGM_BASEDEV* clDev;
+		for (clDev = &_devices[curDev].base; clDev != NULL; clDev = clDev->linkDev)
+		{
+			DEVFUNC_READ_STATE saveState;
+			if (clDev->defInf.dataPtr == NULL)
+				continue;
+			SndEmu_GetDeviceFunc(clDev->defInf.devDef, RWF_STATE | RWF_READ, DEVRW_ALL, 0, (void**)&saveState);
+			size_t stateOfs = kf.devStates.size();
+			kf.devStates.resize(stateOfs + saveState(clDev->defInf.dataPtr, NULL));
+			saveState(clDev->defInf.dataPtr, &kf.devStates[stateOfs]);
+		}
+	}
+	
+	return;
+}
+
+void VGMPlayer::LoadKeyframe(const KEYFRAME& kf)
+{
+	size_t curDev;
+	size_t curStrm;
+	size_t curBank;
+	const UINT8* statePtr;
+	
+	_filePos = kf.filePos;
+	_fileTick = kf.fileTick;
+	_playTick = kf.playTick;
+	_playSmpl = Tick2Sample(_playTick);
+	_playState &= ~PLAYSTATE_END;
+	_psTrigger = 0x00;
+	_curLoop = 0;
+	_lastLoopTick = 0;
+	
+	_ym2612pcm_bnkPos = kf.ym2612pcm_bnkPos;
+	memcpy(_rf5cBank, kf.rf5cBank, sizeof(_rf5cBank));
+	memcpy(_qsWork, kf.qsWork, sizeof(_qsWork));
+	
+	for (curBank = 0x00; curBank < _PCM_BANK_COUNT; curBank ++)
+	{
+		PCM_BANK* pcmBnk = &_pcmBank[curBank];
+		const PCM_BANK* kfBnk = &_kfPcmBank[curBank];
+		size_t items = kf.pcmBankItems[curBank];
+		size_t dataLen = kf.pcmBankSize[curBank];
+		
+		pcmBnk->bankOfs.assign(kfBnk->bankOfs.begin(), kfBnk->bankOfs.begin() + items);
+		pcmBnk->bankSize.assign(kfBnk->bankSize.begin(), kfBnk->bankSize.begin() + items);
+		// the current data is a prefix of the final data as well
+		if (pcmBnk->data.size() > dataLen)
+			pcmBnk->data.resize(dataLen);
+		else
+			pcmBnk->data.insert(pcmBnk->data.end(), kfBnk->data.begin() + pcmBnk->data.size(), kfBnk->data.begin() + dataLen);
+	}
+	
+	for (curStrm = 0; curStrm < _dacStreams.size(); curStrm ++)
+	{
+		DEV_INFO* devInf = &_dacStreams[curStrm].defInf;
+		devInf->devDef->Stop(devInf->dataPtr);
+	}
+	_dacStreams.clear();
+	for (curStrm = 0; curStrm < 0x100; curStrm ++)
+		_dacStrmMap[curStrm] = (size_t)-1;
+	for (curStrm = 0; curStrm < kf.dacStreams.size(); curStrm ++)
+	{
+		const KEYFRAME_STRM& kfStrm = kf.dacStreams[curStrm];
+		DEV_GEN_CFG devCfg;
+		DACSTRM_DEV dacStrm = kfStrm.strm;
+		
+		devCfg.emuCore = 0x00;
+		devCfg.srMode = DEVRI_SRMODE_NATIVE;
+		devCfg.flags = 0x00;
+		devCfg.clock = 0;
+		devCfg.smplRate = _outSmplRate;
+		if (device_start_daccontrol(&devCfg, &dacStrm.defInf))
+			continue;
+		daccontrol_load_state(dacStrm.defInf.dataPtr, &kfStrm.state[0]);
+		// the bank data may have moved since the keyframe was saved
+		if (dacStrm.bankID < _PCM_BANK_COUNT && ! _pcmBank[dacStrm.bankID].data.empty())
+		{
+			std::vector<UINT8>& bnkData = _pcmBank[dacStrm.bankID].data;
+			daccontrol_refresh_data(dacStrm.defInf.dataPtr, &bnkData[0], (UINT32)bnkData.size());
+		}
+		
+		_dacStrmMap[dacStrm.streamID] = _dacStreams.size();
+		_dacStreams.push_back(dacStrm);
+	}
+	
+	statePtr = kf.devStates.empty() ? NULL : &kf.devStates[0];
+	for (curDev = 0; curDev < _devices.size(); curDev ++)
+	{
+		VGM_BASEDEV* clDev;
+		for (clDev = &_devices[curDev].base; clDev != NULL; clDev = clDev->linkDev)
+		{
+			DEVFUNC_READ_STATE saveState;
+			DEVFUNC_WRITE_STATE loadState;
+			if (clDev->defInf.dataPtr == NULL)
+				continue;
+			SndEmu_GetDeviceFunc(clDev->defInf.devDef, RWF_STATE | RWF_READ, DEVRW_ALL, 0, (void**)&saveState);
+			SndEmu_GetDeviceFunc(clDev->defInf.devDef, RWF_STATE | RWF_WRITE, DEVRW_ALL, 0, (void**)&loadState);
+			loadState(clDev->defInf.dataPtr, statePtr);
+			statePtr += saveState(clDev->defInf.dataPtr, NULL);
+		}
+	}
+	
+	return;
+}
+
+const VGMPlayer::KEYFRAME* VGMPlayer::FindKeyframe(UINT32 tick) const
+{
+	// last keyframe at or before the tick
+	size_t kfMin = 0;
+	size_t kfMax = _keyframes.size();
+	while(kfMin < kfMax)
+	{
+		size_t kfMid = (kfMin + kfMax) / 2;
+		if (_keyframes[kfMid].playTick <= tick)
+			kfMin = kfMid + 1;
+		else
+			kfMax = kfMid;
+	}
+	return (kfMin > 0) ? &_keyframes[kfMin - 1] : NULL;
+}
+
 UINT32 VGMPlayer::Render(UINT32 smplCnt, WAVE_32BS* data)
 {
 	UINT32 curSmpl;
 	UINT32 smplFileTick;
 	UINT32 maxSmpl;
+	UINT32 maxStep;
 	INT32 smplStep;	// might be negative due to rounding errors in Tick2Sample
 	size_t curDev;
 	
+	ModizerVoiceScope voiceScope(&_voiceCtx);	//YOYOFR: the cores' oscilloscope hooks use this player's context
+	
 	// Note: use do {} while(), so that "smplCnt == 0" can be used to process until reaching the next sample.
 	curSmpl = 0;
 	do
@@ -1788,39 +2042,56 @@ UINT32 VGMPlayer::Render(UINT32 smplCnt, WAVE_32BS* data)
 		smplFileTick = Sample2Tick(_playSmpl);
 		ParseFile(smplFileTick - _playTick);
 		
+		// When DAC streams are active, end the step at the next stream command, so that DAC streams
+		// and sound chip emulation are in sync. (The command is sent after the step's last sample,
+		// just like with 1-sample steps.)
+		maxStep = smplCnt - curSmpl;
+		for (curDev = 0; curDev < _dacStreams.size(); curDev ++)
+		{
+			UINT32 dsEvent = daccontrol_get_next_event(_dacStreams[curDev].defInf.dataPtr);
+			if (dsEvent < maxStep)
+				maxStep = dsEvent;
+		}
+		// hand runs of YM2612 DAC writes to the chip in advance, instead of stopping at each of them
+		ParseDACWriteRun(maxStep);
+		
 		// render as many samples at once as possible (for better performance)
 		maxSmpl = Tick2Sample(_fileTick);
 		smplStep = maxSmpl - _playSmpl;
-		// When DAC streams are active, limit step size to 1, so that DAC streams and sound chip emulation are in sync.
-		if (smplStep < 1 || ! _dacStreams.empty())
+		if (smplStep < 1)
 			smplStep = 1;	// must render at least 1 sample in order to advance
-		if ((UINT32)smplStep > smplCnt - curSmpl)
-			smplStep = smplCnt - curSmpl;
+		if ((UINT32)smplStep > maxStep)
+			smplStep = maxStep;
 		
 		for (curDev = 0; curDev < _devices.size(); curDev ++)
 		{
 			CHIP_DEVICE* cDev = &_devices[curDev];
 			UINT8 disable = (cDev->optID != (size_t)-1) ? _devOpts[cDev->optID].muteOpts.disable : 0x00;
 			VGM_BASEDEV* clDev;
+			if (cDev->chipType == DEVID_YM2610 && cDev->optID != (size_t)-1 &&
+				(_devOpts[cDev->optID].coreOpts & OPT_YM2610_PCM_ONLY))
+				disable |= 0x02;	// PCM-only mode: don't render the SSG
             
             //TODO:  MODIZER changes start / yoyofr
-            m_voice_current_system=curDev;
-            m_voice_current_systemSub=0;  //YOYOFR: to remove, not used anymore
-            m_voice_current_systemPairedOfs=0;
+            _voiceCtx.system=curDev;
+            _voiceCtx.systemSub=0;  //YOYOFR: to remove, not used anymore
+            _voiceCtx.systemPairedOfs=0;
             //TODO:  MODIZER changes end / YOYOFR
             
 			for (clDev = &cDev->base; clDev != NULL; clDev = clDev->linkDev, disable >>= 1)
 			{
                 //YOYOFR
-                m_voice_current_samplerate=clDev->defInf.sampleRate;
+                _voiceCtx.samplerate=clDev->defInf.sampleRate;
+                _voiceCtx.slot=&clDev->voiceSlot;    //the device keeps its voice slot once it was looked up
                 //YOYOFR
                 
 				if (clDev->defInf.dataPtr != NULL && ! (disable & 0x01))
 					Resmpl_Execute(&clDev->resmpl, smplStep, &data[curSmpl]);
                 
                 //YOYOFR
-                m_voice_current_systemSub++; //flag that next one will be a linked device
-                m_voice_current_systemPairedOfs+=m_voice_current_total;
+                _voiceCtx.systemSub++; //flag that next one will be a linked device
+                _voiceCtx.systemPairedOfs+=_voiceCtx.total;
+                _voiceCtx.slot=NULL;
                 //YOYOFR
                 
 			}
@@ -1843,6 +2114,92 @@ UINT32 VGMPlayer::Render(UINT32 smplCnt, WAVE_32BS* data)
 	return curSmpl;
 }
 
+void VGMPlayer::ParseDACWriteRun(UINT32 maxStep)
+{
+	// Queues the YM2612 DAC writes (52 2A dd / 8n) and waits (61/62/63/7n) that follow
+	// the current position, for as long as they fall into the next maxStep samples.
+	// Each write gets the sample that 1-sample steps would have sent it at, mapped to the chip's
+	// sample rate, so the output stays the same. Anything else ends the run.
+	CHIP_DEVICE* cDev = GetDevicePtr(0x02, 0);
+	UINT32 cmdSmpl;	// sample at which the command would be sent
+	UINT32 cmdCnt;
+	
+	if (cDev == NULL || cDev->dacQueue == NULL || cDev->base.defInf.dataPtr == NULL)
+		return;
+	if (_playState & PLAYSTATE_END)
+		return;
+	if (cDev->optID != (size_t)-1 && (_devOpts[cDev->optID].muteOpts.disable & 0x01))
+		return;	// the chip isn't rendered and wouldn't consume the queue
+	
+	cmdSmpl = _playSmpl;
+	for (cmdCnt = 0; _filePos < _fileHdr.dataEnd && cmdCnt < 0x100; )
+	{
+		const UINT8* cmd = &_fileData[_filePos];
+		UINT8 data;
+		UINT8 cmdLen;
+		UINT32 delay;
+		
+		// leave the last command to ParseFile(), so that it detects the end of the data
+		if (_filePos + _CMD_INFO[cmd[0x00]].cmdLen >= _fileHdr.dataEnd)
+			break;
+		if (cmd[0x00] == 0x52 && cmd[0x01] == 0x2A)
+		{
+			data = cmd[0x02];
+			cmdLen = 0x03;
+			delay = 0;
+		}
+		else if ((cmd[0x00] & 0xF0) == 0x80)
+		{
+			if (_ym2612pcm_bnkPos >= _pcmBank[0].data.size())
+				break;
+			data = _pcmBank[0].data[_ym2612pcm_bnkPos];
+			cmdLen = 0x01;
+			delay = cmd[0x00] & 0x0F;
+		}
+		else
+		{
+			switch(cmd[0x00])
+			{
+			case 0x61:
+				_fileTick += ReadLE16(&cmd[0x01]);
+				break;
+			case 0x62:
+				_fileTick += 735;
+				break;
+			case 0x63:
+				_fileTick += 882;
+				break;
+			case 0x70: case 0x71: case 0x72: case 0x73: case 0x74: case 0x75: case 0x76: case 0x77:
+			case 0x78: case 0x79: case 0x7A: case 0x7B: case 0x7C: case 0x7D: case 0x7E: case 0x7F:
+				_fileTick += 1 + (cmd[0x00] & 0x0F);
+				break;
+			default:
+				return;
+			}
+			_filePos += _CMD_INFO[cmd[0x00]].cmdLen;
+			continue;
+		}
+		
+		// step forward the way Render() would until ParseFile() reaches the command
+		while (Sample2Tick(cmdSmpl) < _fileTick)
+		{
+			INT32 smplStep = Tick2Sample(_fileTick) - cmdSmpl;
+			cmdSmpl += (smplStep < 1) ? 1 : smplStep;
+		}
+		if (cmdSmpl - _playSmpl >= maxStep)
+			break;
+		
+		cDev->dacQueue(cDev->base.defInf.dataPtr, Resmpl_GetSrcOffset(&cDev->base.resmpl, cmdSmpl - _playSmpl), data);
+		if (cmdLen == 0x01)
+			_ym2612pcm_bnkPos ++;
+		_fileTick += delay;
+		_filePos += cmdLen;
+		cmdCnt ++;
+	}
+	
+	return;
+}
+
 void VGMPlayer::ParseFile(UINT32 ticks)
 {
 	_playTick += ticks;
@@ -74,6 +74,9 @@ public:
 		DEVFUNC_WRITE_BLOCK romWrite;
 		DEVFUNC_WRITE_MEMSIZE romSizeB;
 		DEVFUNC_WRITE_BLOCK romWriteB;
+		DEVFUNC_WRITE_BLOCK romRef;		// map ROM data from the file without copying it (YM2608/YM2610)
+		DEVFUNC_WRITE_BLOCK romRefB;
+		DEVFUNC_WRITE_DACQUEUE dacQueue;	// queue timestamped DAC writes (YM2612)
 		DEVLOG_CB_DATA logCbData;
 	};
 	struct DACSTRM_DEV
@@ -143,6 +146,25 @@ protected:
 		UINT16 pitchCache[16];		// QSound register 0x02
 	};
 	
+	struct KEYFRAME_STRM
+	{
+		DACSTRM_DEV strm;	// Note: defInf is not used
+		std::vector<UINT8> state;	// dac_control state
+	};
+	struct KEYFRAME	// player and device state at a certain tick, for fast seeking
+	{
+		UINT32 filePos;
+		UINT32 fileTick;
+		UINT32 playTick;
+		UINT32 ym2612pcm_bnkPos;
+		UINT8 rf5cBank[2][2];
+		QSOUND_WORK qsWork[2];
+		std::vector<UINT32> pcmBankItems;	// number of data blocks in each PCM bank
+		std::vector<UINT32> pcmBankSize;	// data size of each PCM bank
+		std::vector<KEYFRAME_STRM> dacStreams;
+		std::vector<UINT8> devStates;	// device states, in the order of the device trees
+	};
+	
 public:
 	VGMPlayer();
 	~VGMPlayer();
@@ -192,6 +214,10 @@ public:
 	UINT8 Reset(void);
 	UINT8 Seek(UINT8 unit, UINT32 pos);
 	UINT32 Render(UINT32 smplCnt, WAVE_32BS* data);
+	// Run through the song once and record a keyframe every 'interval' ticks, so that
+	// seeking only has to process the commands after the nearest keyframe.
+	// Call after Start(), playback restarts from the beginning. interval = 0 removes the keyframes.
+	UINT8 BuildSeekIndex(UINT32 interval);
 
 	// Chip visualization support: public accessor for chip device pointer
 	CHIP_DEVICE* GetChipDevice(UINT8 chipType, UINT8 chipID) { return GetDevicePtr(chipType, chipID); }
@@ -227,9 +253,14 @@ protected:
 	CHIP_DEVICE* GetDevicePtr(UINT8 chipType, UINT8 chipID);
 	void LoadOPL4ROM(CHIP_DEVICE* chipDev);
 	
+	bool CanSaveDeviceStates(void) const;
+	void SaveKeyframe(KEYFRAME& kf);
+	void LoadKeyframe(const KEYFRAME& kf);
+	const KEYFRAME* FindKeyframe(UINT32 tick) const;
 	UINT8 SeekToTick(UINT32 tick);
 	UINT8 SeekToFilePos(UINT32 pos);
 	void ParseFile(UINT32 ticks);
+	void ParseDACWriteRun(UINT32 maxStep);
 
 	void ParseFileForFMClocks();
 	
@@ -373,6 +404,9 @@ protected:
 	UINT32 _ym2612pcm_bnkPos;
 	UINT8 _rf5cBank[2][2];	// [0 RF5C68 / 1 RF5C164][chipID]
 	QSOUND_WORK _qsWork[2];
+	
+	std::vector<KEYFRAME> _keyframes;	// sorted by playTick
+	PCM_BANK _kfPcmBank[_PCM_BANK_COUNT];	// PCM banks at the end of the keyframe pass
 
 	UINT8 _v101Fix;	// enable hack/fix for v1.00/v1.01 VGMs with FM clock
 	UINT32 _v101ym2413clock;
@@ -642,21 +642,26 @@ INLINE void SendYMCommand(VGMPlayer::CHIP_DEVICE* cDev, UINT8 port, UINT8 reg, U
 	return;
 }
 
+// dataInFile: data points into the loaded file and can be referenced by the chip instead of being copied
 static void WriteChipROM(VGMPlayer::CHIP_DEVICE* cDev, UINT8 memID,
-						 UINT32 memSize, UINT32 dataOfs, UINT32 dataLen, const UINT8* data)
+						 UINT32 memSize, UINT32 dataOfs, UINT32 dataLen, const UINT8* data, bool dataInFile)
 {
 	if (memID == 0)
 	{
 		if (cDev->romSize != NULL)
 			cDev->romSize(cDev->base.defInf.dataPtr, memSize);
-		if (cDev->romWrite != NULL && dataLen)
+		if (cDev->romRef != NULL && dataInFile && dataLen)
+			cDev->romRef(cDev->base.defInf.dataPtr, dataOfs, dataLen, data);
+		else if (cDev->romWrite != NULL && dataLen)
 			cDev->romWrite(cDev->base.defInf.dataPtr, dataOfs, dataLen, data);
 	}
 	else
 	{
 		if (cDev->romSizeB != NULL)
 			cDev->romSizeB(cDev->base.defInf.dataPtr, memSize);
-		if (cDev->romWriteB != NULL && dataLen)
+		if (cDev->romRefB != NULL && dataInFile && dataLen)
+			cDev->romRefB(cDev->base.defInf.dataPtr, dataOfs, dataLen, data);
+		else if (cDev->romWriteB != NULL && dataLen)
 			cDev->romWriteB(cDev->base.defInf.dataPtr, dataOfs, dataLen, data);
 	}
 	
@@ -765,11 +770,11 @@ void VGMPlayer::Cmd_DataBlock(void)
 				swpData[curPos + 0x00] = dataPtr[curPos + 0x01];
 				swpData[curPos + 0x01] = dataPtr[curPos + 0x00];
 			}
-			WriteChipROM(cDev, _VGM_ROM_CHIPS[dblkType & 0x3F][1], memSize, dataOfs, dataLen, &swpData[0x00]);
+			WriteChipROM(cDev, _VGM_ROM_CHIPS[dblkType & 0x3F][1], memSize, dataOfs, dataLen, &swpData[0x00], false);
 		}
 		else
 		{
-			WriteChipROM(cDev, _VGM_ROM_CHIPS[dblkType & 0x3F][1], memSize, dataOfs, dataLen, dataPtr);
+			WriteChipROM(cDev, _VGM_ROM_CHIPS[dblkType & 0x3F][1], memSize, dataOfs, dataLen, dataPtr, true);
 		}
 		break;
 	case 0xC0:	// RAM Write
@@ -11,6 +11,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
+
+#include <vector>
 
 #include "player/playerbase.hpp"
 #include "player/vgmplayer.hpp"
@@ -47,6 +50,10 @@ bit_depth = 16;
 static unsigned int
 loops = 2;
 
+/* emulation core for every device that offers it (e.g. "nuke", "mame"), 0 = defaults */
+static UINT32
+core_id = 0;
+
 /* vgm-specific functions */
 static void
 FCC2STR(char *str, UINT32 fcc);
@@ -54,8 +61,8 @@ FCC2STR(char *str, UINT32 fcc);
 static UINT32
 STR2FCC(const char *str);
 
-static void
-set_core(PlayerBase *player, UINT8 devId, UINT32 coreId);
+static unsigned int
+set_core(PlayerBase *player, UINT32 coreId);
 
 static void
 dump_info(PlayerBase *player);
@@ -170,6 +177,27 @@ int main(int argc, const char *argv[]) {
             argv++;
             argc--;
         }
+        else if(str_istarts(*argv,"--core")) {
+            c = strchr(*argv,'=');
+            if(c != NULL) {
+                s = &c[1];
+            } else {
+                argv++;
+                argc--;
+                s = *argv;
+            }
+            /* core IDs are 4 upper-case characters, padded with zeros ("EMU\0") */
+            {
+                char fcc[4] = {0, 0, 0, 0};
+                unsigned int i;
+                for(i = 0; i < 4 && s != NULL && s[i] != '\0'; i++) {
+                    fcc[i] = (char)toupper((unsigned char)s[i]);
+                }
+                core_id = STR2FCC(fcc);
+            }
+            argv++;
+            argc--;
+        }
         else {
             break;
         }
@@ -197,6 +225,7 @@ int main(int argc, const char *argv[]) {
         fprintf(stderr,"    --bps\n");
         fprintf(stderr,"    --fade\n");
         fprintf(stderr,"    --loops\n");
+        fprintf(stderr,"    --core (emulation core for all devices that have it, e.g. nuke, mame)\n");
         return 1;
     }
 
@@ -280,15 +309,10 @@ int main(int argc, const char *argv[]) {
         player.SetLoopCount(vgmplay->GetModifiedLoopCount(loops));
     }
 
-    /* example for setting cores */
-    /* TODO provide interface for user to specify cores
-     * for devices, like:
-     *   --core=ym2612=nuke ?DEVID_YM3812
-     *   --ym2612=nuke ?
-     *   ???
-     */
-    /* commented-out since NUKE uses a lot of CPU */
-    // set_core(plrEngine,DEVID_YM2612,FCC_NUKE);
+    /* --core: has to be set before Start, which creates the devices */
+    if(core_id != 0 && set_core(plrEngine,core_id) == 0) {
+        fprintf(stderr,"no device of this file has the requested core, using the defaults\n");
+    }
 
     /* let's get some tags! just printing for now.
      * if we wanted to get *really* fancy we could add
@@ -381,16 +405,31 @@ int main(int argc, const char *argv[]) {
     return 0;
 }
 
-static void set_core(PlayerBase *player, UINT8 devId, UINT32 coreId) {
+/* select coreId for every device of the song that has such a core,
+ * returns the number of devices switched */
+static unsigned int set_core(PlayerBase *player, UINT32 coreId) {
+    std::vector<PLR_DEV_INFO> devInfList;
     PLR_DEV_OPTS devOpts;
+    const DEV_DEF **devDefList;
+    unsigned int count;
     UINT32 id;
+    size_t i;
+
+    count = 0;
+    player->GetSongDeviceInfo(devInfList);
+    for(i=0;i<devInfList.size();i++) {
+        for(devDefList = SndEmu_GetDevDefList(devInfList[i].type); *devDefList; devDefList++) {
+            if((*devDefList)->coreID == coreId) break;
+        }
+        if(*devDefList == NULL) continue;
 
-    /* just going to set the first instance */
-    id = PLR_DEV_ID(devId,0);
-    if(player->GetDeviceOptions(id,devOpts)) return;
-    devOpts.emuCore[0] = coreId;
-    player->SetDeviceOptions(id,devOpts);
-    return;
+        id = PLR_DEV_ID(devInfList[i].type,devInfList[i].instance);
+        if(player->GetDeviceOptions(id,devOpts)) continue;
+        devOpts.emuCore[0] = coreId;
+        player->SetDeviceOptions(id,devOpts);
+        count++;
+    }
+    return count;
 }
 
 static void dump_info(PlayerBase *player) {